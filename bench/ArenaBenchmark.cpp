@@ -0,0 +1,134 @@
+// Counts the heap allocations it takes to load and unload a file in each parse mode, and times both,
+// to compare AsepriteParseMode::Arena against the modes that allocate every container separately.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include bench/ArenaBenchmark.cpp -o ArenaBenchmark -lz
+// Usage:
+//   ArenaBenchmark <file.aseprite> [iterations]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "Core/Log/Public/Log.h"
+#include "Core/Image/Public/Parser.h"
+
+namespace
+{
+	std::atomic<uint64_t> Allocations{ 0 };
+	std::atomic<uint64_t> Frees{ 0 };
+}
+
+void* operator new(size_t Size)
+{
+	Allocations++;
+	if (void* Ptr = malloc(Size ? Size : 1))
+	{
+		return Ptr;
+	}
+	throw std::bad_alloc();
+}
+void operator delete(void* Ptr) noexcept
+{
+	if (Ptr)
+	{
+		Frees++;
+		free(Ptr);
+	}
+}
+void operator delete(void* Ptr, size_t) noexcept
+{
+	operator delete(Ptr);
+}
+
+//std::pmr::new_delete_resource allocates through these, so they have to be counted too
+void* operator new(size_t Size, std::align_val_t Alignment)
+{
+	Allocations++;
+	size_t Align = (size_t)Alignment;
+#ifdef _MSC_VER
+	void* Ptr = _aligned_malloc(Size ? Size : 1, Align);
+#else
+	void* Ptr = aligned_alloc(Align, (Size + Align - 1) / Align * Align);
+#endif
+	if (Ptr)
+	{
+		return Ptr;
+	}
+	throw std::bad_alloc();
+}
+void operator delete(void* Ptr, std::align_val_t) noexcept
+{
+	if (Ptr)
+	{
+		Frees++;
+#ifdef _MSC_VER
+		_aligned_free(Ptr);
+#else
+		free(Ptr);
+#endif
+	}
+}
+void operator delete(void* Ptr, size_t, std::align_val_t Alignment) noexcept
+{
+	operator delete(Ptr, Alignment);
+}
+
+namespace
+{
+	void Run(const char* Name, const char* Path, ASE::AsepriteParseMode Mode, int Iterations)
+	{
+		ASE::AsepriteParser Parser;
+		uint64_t LoadAllocations = 0;
+		uint64_t UnloadFrees = 0;
+		double LoadTime = 0.0;
+		double UnloadTime = 0.0;
+
+		for (int i = 0; i < Iterations; i++)
+		{
+			uint64_t Before = Allocations;
+			auto Start = std::chrono::steady_clock::now();
+			ASE::SpriteId Sprite = Parser.ReadData(Path, Mode);
+			auto Loaded = std::chrono::steady_clock::now();
+			LoadAllocations += Allocations - Before;
+
+			if (!Sprite)
+			{
+				printf("Unable to load %s\n", Path);
+				return;
+			}
+
+			Before = Frees;
+			auto UnloadStart = std::chrono::steady_clock::now();
+			Parser.Unload(Sprite);
+			auto End = std::chrono::steady_clock::now();
+			UnloadFrees += Frees - Before;
+
+			LoadTime += std::chrono::duration<double, std::milli>(Loaded - Start).count();
+			UnloadTime += std::chrono::duration<double, std::micro>(End - UnloadStart).count();
+		}
+
+		printf("%-8s %10.1f allocs/load %10.1f frees/unload %10.3f ms/load %10.2f us/unload\n", Name,
+			(double)LoadAllocations / Iterations, (double)UnloadFrees / Iterations, LoadTime / Iterations, UnloadTime / Iterations);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		printf("Usage: %s <file.aseprite> [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	ASE::Log::Init();
+	int Iterations = argc > 2 ? atoi(argv[2]) : 200;
+	printf("%d iterations\n", Iterations);
+
+	Run("Stream", argv[1], ASE::AsepriteParseMode::Stream, Iterations);
+	Run("Mapped", argv[1], ASE::AsepriteParseMode::Mapped, Iterations);
+	Run("Arena", argv[1], ASE::AsepriteParseMode::Arena, Iterations);
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+// Compares the cel inflate backends (ZlibInflater and FastInflater) on every compressed cel of a file.
+// Both backends are always built here, ASE_FAST_INFLATE only picks which one Image uses.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include bench/InflateBenchmark.cpp -o InflateBenchmark -lz
+// Usage:
+//   InflateBenchmark <file.aseprite> [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Core/Log/Public/Log.h"
+#include "Core/Serializer/Public/MappedFileReader.h"
+#include "Core/Compression/Public/Inflater.h"
+#include "Core/Compression/Public/FastInflater.h"
+
+namespace
+{
+	struct CelRef
+	{
+		const uint8_t* Data;
+		size_t Size;
+		size_t DecodedSize;
+	};
+
+	std::vector<CelRef> CollectCompressedCels(ASE::MappedFileReader& Stream)
+	{
+		std::vector<CelRef> Cels;
+		uint16_t Frames = 0;
+		uint16_t Depth = 0;
+
+		Stream.SetStreamPosition(6);
+		Stream.ReadRaw<uint16_t>(Frames);
+		Stream.SetStreamPosition(12);
+		Stream.ReadRaw<uint16_t>(Depth);
+		Stream.SetStreamPosition(128);
+
+		for (uint16_t i = 0; i < Frames && Stream; i++)
+		{
+			uint32_t BytesInFrame = 0;
+			uint16_t OldNumOfChunks = 0;
+			uint32_t NumOfChunks = 0;
+			uint64_t FrameStart = Stream.GetStreamPosition();
+
+			Stream.ReadRaw<uint32_t>(BytesInFrame);
+			Stream.SetStreamPosition(FrameStart + 6);
+			Stream.ReadRaw<uint16_t>(OldNumOfChunks);
+			Stream.SetStreamPosition(FrameStart + 12);
+			Stream.ReadRaw<uint32_t>(NumOfChunks);
+			if (NumOfChunks == 0)
+			{
+				NumOfChunks = OldNumOfChunks;
+			}
+
+			for (uint32_t x = 0; x < NumOfChunks && Stream; x++)
+			{
+				uint32_t Size = 0;
+				uint16_t Type = 0;
+				Stream.ReadRaw<uint32_t>(Size);
+				Stream.ReadRaw<uint16_t>(Type);
+				const uint8_t* Body = (const uint8_t*)Stream.ReadView(Size - 6);
+
+				// Cel header is 16 bytes, then width and height before the zlib stream
+				uint16_t CelType = 0;
+				if (!Body || Type != 0x2005 || Size < 6 + 20)
+				{
+					continue;
+				}
+				memcpy(&CelType, Body + 7, sizeof(CelType));
+				if (CelType != 2)
+				{
+					continue;
+				}
+
+				uint16_t Width = 0;
+				uint16_t Height = 0;
+				memcpy(&Width, Body + 16, sizeof(Width));
+				memcpy(&Height, Body + 18, sizeof(Height));
+				Cels.push_back({ Body + 20, Size - 6 - 20, (size_t)Width * Height * (Depth / 8) });
+			}
+
+			Stream.SetStreamPosition(FrameStart + BytesInFrame);
+		}
+
+		return Cels;
+	}
+
+	template<typename Backend>
+	double Run(const char* Name, const std::vector<CelRef>& Cels, int Iterations, std::vector<std::vector<uint8_t>>& Output)
+	{
+		Backend Inflater;
+		size_t Failed = 0;
+		size_t Bytes = 0;
+
+		Output.resize(Cels.size());
+		for (size_t i = 0; i < Cels.size(); i++)
+		{
+			Output[i].resize(Cels[i].DecodedSize);
+			Bytes += Cels[i].DecodedSize;
+		}
+
+		auto Start = std::chrono::steady_clock::now();
+		for (int i = 0; i < Iterations; i++)
+		{
+			for (size_t c = 0; c < Cels.size(); c++)
+			{
+				Failed += !Inflater.Inflate(Cels[c].Data, Cels[c].Size, Output[c].data(), Output[c].size());
+			}
+		}
+		auto End = std::chrono::steady_clock::now();
+
+		double Nanoseconds = std::chrono::duration<double, std::nano>(End - Start).count();
+		double PerCel = Nanoseconds / ((double)Cels.size() * Iterations);
+		double MBPerSecond = ((double)Bytes * Iterations / (1024.0 * 1024.0)) / (Nanoseconds / 1e9);
+		printf("%-14s %10.1f ns/cel  %8.1f MB/s  (%zu failed)\n", Name, PerCel, MBPerSecond, Failed);
+		return PerCel;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		printf("Usage: %s <file.aseprite> [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	ASE::Log::Init();
+	int Iterations = argc > 2 ? atoi(argv[2]) : 50;
+
+	ASE::MappedFileReader Stream(argv[1]);
+	if (!Stream)
+	{
+		printf("Unable to open %s\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<CelRef> Cels = CollectCompressedCels(Stream);
+	if (Cels.empty())
+	{
+		printf("%s has no compressed cels\n", argv[1]);
+		return 1;
+	}
+	printf("%zu compressed cels, %d iterations\n", Cels.size(), Iterations);
+
+	std::vector<std::vector<uint8_t>> ZlibOutput;
+	std::vector<std::vector<uint8_t>> FastOutput;
+	double ZlibTime = Run<ASE::ZlibInflater>("ZlibInflater", Cels, Iterations, ZlibOutput);
+	double FastTime = Run<ASE::FastInflater>("FastInflater", Cels, Iterations, FastOutput);
+	printf("Speedup: %.2fx, outputs %s\n", ZlibTime / FastTime, ZlibOutput == FastOutput ? "match" : "DIFFER");
+
+	return 0;
+}
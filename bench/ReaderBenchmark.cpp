@@ -0,0 +1,170 @@
+// Compares MemoryStreamReader against MemorySpanReader by decoding every cel chunk of a file the way ReadCelChunk does.
+// Point it at a real cel-heavy sprite, the more frames and layers the better.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include bench/ReaderBenchmark.cpp -o ReaderBenchmark
+// Usage:
+//   ReaderBenchmark <file.aseprite> [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Core/Log/Public/Log.h"
+#include "Core/Serializer/Public/DataReader.h"
+#include "Core/Serializer/Public/MappedFileReader.h"
+
+namespace
+{
+	struct ChunkRef
+	{
+		const std::byte* Data;
+		size_t Size;
+	};
+
+	std::vector<ChunkRef> CollectCelChunks(ASE::MappedFileReader& Stream)
+	{
+		std::vector<ChunkRef> Chunks;
+		uint16_t Frames = 0;
+
+		Stream.SetStreamPosition(6);
+		Stream.ReadRaw<uint16_t>(Frames);
+		Stream.SetStreamPosition(128);
+
+		for (uint16_t i = 0; i < Frames && Stream; i++)
+		{
+			uint32_t BytesInFrame = 0;
+			uint16_t Magic = 0;
+			uint16_t OldNumOfChunks = 0;
+			uint32_t NumOfChunks = 0;
+			uint64_t FrameStart = Stream.GetStreamPosition();
+
+			Stream.ReadRaw<uint32_t>(BytesInFrame);
+			Stream.ReadRaw<uint16_t>(Magic);
+			Stream.ReadRaw<uint16_t>(OldNumOfChunks);
+			Stream.SetStreamPosition(FrameStart + 12);
+			Stream.ReadRaw<uint32_t>(NumOfChunks);
+			if (NumOfChunks == 0)
+			{
+				NumOfChunks = OldNumOfChunks;
+			}
+
+			for (uint32_t x = 0; x < NumOfChunks && Stream; x++)
+			{
+				uint32_t Size = 0;
+				uint16_t Type = 0;
+				Stream.ReadRaw<uint32_t>(Size);
+				Stream.ReadRaw<uint16_t>(Type);
+				const std::byte* Body = Stream.ReadView(Size - 6);
+				if (Body && Type == 0x2005)
+				{
+					Chunks.push_back({ Body, Size - 6 });
+				}
+			}
+
+			Stream.SetStreamPosition(FrameStart + BytesInFrame);
+		}
+
+		return Chunks;
+	}
+
+	template<typename Reader>
+	uint64_t DecodeCels(const std::vector<ChunkRef>& Chunks, std::vector<std::byte>& Scratch)
+	{
+		uint64_t Checksum = 0;
+
+		for (const auto& C : Chunks)
+		{
+			Reader Stream((void*)C.Data, C.Size);
+			uint16_t LayerIndex = 0;
+			int16_t x = 0;
+			int16_t y = 0;
+			uint8_t Opacity;
+			uint16_t CelType = 0;
+			int16_t zIndex;
+			uint8_t Useless;
+			uint16_t Width = 0;
+			uint16_t Height = 0;
+
+			Stream.template ReadRaw<uint16_t>(LayerIndex);
+			Stream.template ReadRaw<int16_t>(x);
+			Stream.template ReadRaw<int16_t>(y);
+			Stream.template ReadRaw<uint8_t>(Opacity);
+			Stream.template ReadRaw<uint16_t>(CelType);
+			Stream.template ReadRaw<int16_t>(zIndex);
+			for (int i = 0; i < 5; i++)
+			{
+				Stream.template ReadRaw<uint8_t>(Useless);
+			}
+
+			if (CelType != 1)
+			{
+				Stream.template ReadRaw<uint16_t>(Width);
+				Stream.template ReadRaw<uint16_t>(Height);
+				size_t PixelBytes = C.Size - 20;
+				if (Scratch.size() < PixelBytes)
+				{
+					Scratch.resize(PixelBytes);
+				}
+				Stream.ReadBytes(Scratch, PixelBytes);
+				Checksum += PixelBytes ? (uint64_t)Scratch[PixelBytes - 1] : 0;
+			}
+
+			Checksum += LayerIndex + x + y + Opacity + CelType + zIndex + Width + Height;
+		}
+
+		return Checksum;
+	}
+
+	template<typename Reader>
+	double Run(const char* Name, const std::vector<ChunkRef>& Chunks, int Iterations)
+	{
+		std::vector<std::byte> Scratch;
+		uint64_t Checksum = 0;
+
+		auto Start = std::chrono::steady_clock::now();
+		for (int i = 0; i < Iterations; i++)
+		{
+			Checksum += DecodeCels<Reader>(Chunks, Scratch);
+		}
+		auto End = std::chrono::steady_clock::now();
+
+		double Nanoseconds = std::chrono::duration<double, std::nano>(End - Start).count();
+		double PerChunk = Nanoseconds / ((double)Chunks.size() * Iterations);
+		printf("%-20s %10.1f ns/chunk  (checksum %llu)\n", Name, PerChunk, (unsigned long long)Checksum);
+		return PerChunk;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		printf("Usage: %s <file.aseprite> [iterations]\n", argv[0]);
+		return 1;
+	}
+
+	ASE::Log::Init();
+	int Iterations = argc > 2 ? atoi(argv[2]) : 200;
+
+	ASE::MappedFileReader Stream(argv[1]);
+	if (!Stream)
+	{
+		printf("Unable to open %s\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<ChunkRef> Chunks = CollectCelChunks(Stream);
+	if (Chunks.empty())
+	{
+		printf("%s has no cel chunks\n", argv[1]);
+		return 1;
+	}
+	printf("%zu cel chunks, %d iterations\n", Chunks.size(), Iterations);
+
+	double StreamTime = Run<ASE::MemoryStreamReader>("MemoryStreamReader", Chunks, Iterations);
+	double SpanTime = Run<ASE::MemorySpanReader>("MemorySpanReader", Chunks, Iterations);
+	printf("Speedup: %.2fx\n", StreamTime / SpanTime);
+
+	return 0;
+}
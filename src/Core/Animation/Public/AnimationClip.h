@@ -0,0 +1,215 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cmath>
+#include <algorithm>
+#include "Log/Public/Log.h"
+#include "Structs/Public/DataStructures.h"
+
+namespace ASE
+{
+	//A tag (or the whole file) turned into a timeline of frames, so finding the frame to show at some time is a lookup rather than stepping through the animation.
+	//The timeline is an intro that plays once followed by a cycle that repeats, either forever or until the tag's repeat count runs out.
+	//Ping-pong 0-3 is the intro 0 then the cycle 1 2 3 2 1 0, so the frames at the turnarounds aren't shown twice, same as Aseprite plays it.
+	//Times are in milliseconds
+	class AnimationClip
+	{
+	public:
+		AnimationClip() = default;
+
+		//Frames From to To of an animation whose frames last Durations milliseconds each. RepeatTimes of 0 loops forever
+		AnimationClip(const std::vector<uint16_t>& Durations, uint16_t From, uint16_t To, AsepriteLoopDirection Direction = AsepriteLoopDirection::Forward, uint16_t RepeatTimes = 0)
+		{
+			if (Durations.empty())
+			{
+				return;
+			}
+			To = std::min<uint16_t>(To, (uint16_t)(Durations.size() - 1));
+			From = std::min(From, To);
+
+			std::vector<uint16_t> Forward;
+			for (uint16_t f = From; f <= To; f++)
+			{
+				Forward.push_back(f);
+			}
+			std::vector<uint16_t> Backward(Forward.rbegin(), Forward.rend());
+
+			bool IsReverse = Direction == AsepriteLoopDirection::Reverse || Direction == AsepriteLoopDirection::PingPongReverse;
+			bool IsPingPong = Direction == AsepriteLoopDirection::PingPong || Direction == AsepriteLoopDirection::PingPongReverse;
+			const std::vector<uint16_t>& First = IsReverse ? Backward : Forward;
+			const std::vector<uint16_t>& Second = IsReverse ? Forward : Backward;
+
+			//Frames shown over the whole clip, each pass of a ping-pong after the first skips the frame it turned around on
+			size_t Length = First.size();
+			size_t TotalFrames = 0;
+			if (IsPingPong && Length > 1)
+			{
+				m_Frames.push_back(First[0]);
+				m_Frames.insert(m_Frames.end(), First.begin() + 1, First.end());
+				m_Frames.insert(m_Frames.end(), Second.begin() + 1, Second.end());
+				m_CycleStart = 1;
+				TotalFrames = Length + (size_t)std::max<int>(RepeatTimes - 1, 0) * (Length - 1);
+			}
+			else
+			{
+				m_Frames = First;
+				m_CycleStart = 0;
+				TotalFrames = (size_t)RepeatTimes * Length;
+			}
+
+			//Broken files can have 0ms frames, they'd never be shown and would make the cycle take no time
+			m_Ends.resize(m_Frames.size());
+			float Time = 0.0f;
+			for (size_t i = 0; i < m_Frames.size(); i++)
+			{
+				Time += (float)std::max<uint16_t>(Durations[m_Frames[i]], 1);
+				m_Ends[i] = Time;
+			}
+			m_CycleStartTime = m_CycleStart ? m_Ends[m_CycleStart - 1] : 0.0f;
+			m_CycleDuration = Time - m_CycleStartTime;
+
+			//The common case of every frame lasting the same time doesn't need a search at all
+			m_UniformDuration = (float)std::max<uint16_t>(Durations[m_Frames[m_CycleStart]], 1);
+			for (size_t i = m_CycleStart; i < m_Frames.size(); i++)
+			{
+				if ((float)std::max<uint16_t>(Durations[m_Frames[i]], 1) != m_UniformDuration)
+				{
+					m_UniformDuration = 0.0f;
+					break;
+				}
+			}
+
+			m_Looping = RepeatTimes == 0;
+			if (m_Looping)
+			{
+				m_Duration = m_Ends.back();
+				m_LastFrame = m_Frames.back();
+				return;
+			}
+
+			//How long until it stops, and the frame it stops on
+			size_t CycleFrames = TotalFrames - m_CycleStart - 1;
+			size_t CycleLength = m_Frames.size() - m_CycleStart;
+			size_t Last = m_CycleStart + CycleFrames % CycleLength;
+			m_Duration = m_CycleStartTime + (float)(CycleFrames / CycleLength) * m_CycleDuration + m_Ends[Last] - m_CycleStartTime;
+			m_LastFrame = m_Frames[Last];
+		}
+
+		//Every frame of the file, forwards and looping
+		static AnimationClip FromFile(const AsepriteFileData& File)
+		{
+			std::vector<uint16_t> Durations = GetDurations(File);
+			return AnimationClip(Durations, 0, Durations.empty() ? 0 : (uint16_t)(Durations.size() - 1));
+		}
+
+		static AnimationClip FromTag(const AsepriteFileData& File, const AsepriteTag& Tag)
+		{
+			return AnimationClip(GetDurations(File), Tag.FromFrame, Tag.ToFrame, (AsepriteLoopDirection)Tag.LoopDirection, Tag.RepeatTimes);
+		}
+
+		//Invalid if the file has no tag called TagName
+		static AnimationClip FromTag(const AsepriteFileData& File, const std::string& TagName)
+		{
+			for (auto& Tag : File.Tags)
+			{
+				if (std::string_view(Tag.Name) == TagName)
+				{
+					return FromTag(File, Tag);
+				}
+			}
+			CoreLogger::Warn("There's no tag called {} to make an animation from", TagName);
+			return AnimationClip();
+		}
+
+		bool IsValid() const { return !m_Frames.empty(); }
+		bool IsLooping() const { return m_Looping; }
+		//How long until the clip stops on its last frame, or one full trip through it if it loops
+		float GetDuration() const { return m_Duration; }
+		bool IsFinished(float Time) const { return !m_Looping && Time >= m_Duration; }
+
+		//Time folded back into the clip, loops wrap around the cycle and clips that stop are held at the end
+		float Wrap(float Time) const
+		{
+			if (!m_Looping)
+			{
+				return std::clamp(Time, 0.0f, m_Duration);
+			}
+			if (Time < m_CycleStartTime)
+			{
+				return std::max(Time, 0.0f);
+			}
+
+			//Time usually only moves on by a frame's worth between calls, so it's rarely more than one cycle out
+			float CycleTime = Time - m_CycleStartTime;
+			if (CycleTime >= m_CycleDuration)
+			{
+				CycleTime = std::fmod(CycleTime, m_CycleDuration);
+			}
+			return m_CycleStartTime + CycleTime;
+		}
+
+		//Frame of the file to show Time milliseconds into the clip
+		uint16_t GetFrame(float Time) const
+		{
+			return GetWrappedFrame(Wrap(Time));
+		}
+
+		//GetFrame for a time that's already been through Wrap. Constant time when every frame of the cycle lasts as long, a binary search otherwise
+		uint16_t GetWrappedFrame(float Time) const
+		{
+			if (m_Frames.empty())
+			{
+				return 0;
+			}
+			if (!m_Looping && Time >= m_Duration)
+			{
+				return m_LastFrame;
+			}
+			if (Time < m_CycleStartTime)
+			{
+				return m_Frames[std::upper_bound(m_Ends.begin(), m_Ends.begin() + m_CycleStart, Time) - m_Ends.begin()];
+			}
+
+			//Clips that stop can be several cycles in, loops never are once wrapped
+			float CycleTime = Time - m_CycleStartTime;
+			if (CycleTime >= m_CycleDuration)
+			{
+				CycleTime = std::fmod(CycleTime, m_CycleDuration);
+			}
+
+			size_t Index;
+			if (m_UniformDuration > 0.0f)
+			{
+				Index = m_CycleStart + (size_t)(CycleTime / m_UniformDuration);
+			}
+			else
+			{
+				Index = std::upper_bound(m_Ends.begin() + m_CycleStart, m_Ends.end(), m_CycleStartTime + CycleTime) - m_Ends.begin();
+			}
+			return m_Frames[std::min(Index, m_Frames.size() - 1)];
+		}
+
+	private:
+		static std::vector<uint16_t> GetDurations(const AsepriteFileData& File)
+		{
+			std::vector<uint16_t> Durations;
+			Durations.reserve(File.Frames.size());
+			for (auto& F : File.Frames)
+			{
+				Durations.push_back(F.FrameDuration);
+			}
+			return Durations;
+		}
+
+		std::vector<uint16_t> m_Frames; // Intro then one cycle, as frame numbers of the file
+		std::vector<float> m_Ends; // When each of m_Frames stops being shown
+		size_t m_CycleStart = 0;
+		float m_CycleStartTime = 0.0f;
+		float m_CycleDuration = 0.0f;
+		float m_UniformDuration = 0.0f; // How long every frame of the cycle lasts if they're all the same, 0 if they aren't
+		float m_Duration = 0.0f;
+		uint16_t m_LastFrame = 0;
+		bool m_Looping = true;
+	};
+}
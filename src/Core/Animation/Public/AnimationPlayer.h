@@ -0,0 +1,99 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Animation/Public/AnimationClip.h"
+
+namespace ASE
+{
+	//Plays clips on any number of sprite instances at once. Every instance's time, speed, clip and current frame live in their own arrays
+	//so Update goes straight through memory, and the frames it works out can be read back for the whole batch with GetFrames().
+	//Instances are numbered 0 to GetInstanceCount() - 1, removing one moves the last instance into its place
+	class AnimationPlayer
+	{
+	public:
+		AnimationPlayer() = default;
+
+		//Returns the number to Play the clip with
+		uint32_t AddClip(const AnimationClip& Clip)
+		{
+			m_ClipData.push_back(Clip);
+			return (uint32_t)(m_ClipData.size() - 1);
+		}
+		const AnimationClip& GetClip(uint32_t Clip) const { return m_ClipData[Clip]; }
+
+		//Starts a new instance playing Clip from the beginning, Speed scales how fast time passes for it (0 pauses it, clips don't play backwards). Returns the instance
+		uint32_t Play(uint32_t Clip, float Speed = 1.0f, float StartTime = 0.0f)
+		{
+			m_Clips.push_back(Clip);
+			m_Speeds.push_back(Speed);
+			m_Times.push_back(m_ClipData[Clip].Wrap(StartTime));
+			m_Frames.push_back(m_ClipData[Clip].GetFrame(m_Times.back()));
+			return (uint32_t)(m_Clips.size() - 1);
+		}
+
+		//Switches an instance over to another clip, starting it from the beginning
+		void SetClip(uint32_t Instance, uint32_t Clip)
+		{
+			m_Clips[Instance] = Clip;
+			m_Times[Instance] = 0.0f;
+			m_Frames[Instance] = m_ClipData[Clip].GetFrame(0.0f);
+		}
+		void SetSpeed(uint32_t Instance, float Speed) { m_Speeds[Instance] = Speed; }
+		void SetTime(uint32_t Instance, float Time)
+		{
+			m_Times[Instance] = m_ClipData[m_Clips[Instance]].Wrap(Time);
+			m_Frames[Instance] = m_ClipData[m_Clips[Instance]].GetFrame(m_Times[Instance]);
+		}
+
+		//The last instance takes Instance's number
+		void Remove(uint32_t Instance)
+		{
+			m_Clips[Instance] = m_Clips.back();
+			m_Speeds[Instance] = m_Speeds.back();
+			m_Times[Instance] = m_Times.back();
+			m_Frames[Instance] = m_Frames.back();
+			m_Clips.pop_back();
+			m_Speeds.pop_back();
+			m_Times.pop_back();
+			m_Frames.pop_back();
+		}
+
+		void Reserve(size_t Instances)
+		{
+			m_Clips.reserve(Instances);
+			m_Speeds.reserve(Instances);
+			m_Times.reserve(Instances);
+			m_Frames.reserve(Instances);
+		}
+
+		//Moves every instance on by DeltaTime milliseconds (times its speed) and works out the frame it's on.
+		//Times are kept folded back into their clip, so they never grow big enough to lose precision however long a loop runs
+		void Update(float DeltaTime)
+		{
+			const AnimationClip* Clips = m_ClipData.data();
+			for (size_t i = 0; i < m_Times.size(); i++)
+			{
+				const AnimationClip& Clip = Clips[m_Clips[i]];
+				float Time = Clip.Wrap(m_Times[i] + DeltaTime * m_Speeds[i]);
+				m_Times[i] = Time;
+				m_Frames[i] = Clip.GetWrappedFrame(Time);
+			}
+		}
+
+		size_t GetInstanceCount() const { return m_Times.size(); }
+		//Frame of the file each instance is showing as of the last Update
+		const uint16_t* GetFrames() const { return m_Frames.data(); }
+		uint16_t GetFrame(uint32_t Instance) const { return m_Frames[Instance]; }
+		float GetTime(uint32_t Instance) const { return m_Times[Instance]; }
+		bool IsFinished(uint32_t Instance) const { return m_ClipData[m_Clips[Instance]].IsFinished(m_Times[Instance]); }
+
+	private:
+		std::vector<AnimationClip> m_ClipData;
+
+		std::vector<uint32_t> m_Clips;
+		std::vector<float> m_Speeds;
+		std::vector<float> m_Times;
+		std::vector<uint16_t> m_Frames;
+	};
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "Compression/Public/Inflater.h"
+#include "Compression/Public/FastInflater.h"
+
+namespace ASE
+{
+	//Backend the Image uses to decompress cels, picked at compile time.
+	//A backend is any class with bool Inflate(const uint8_t* Src, size_t SrcSize, uint8_t* Dst, size_t DstSize) that inflates a whole
+	//zlib stream into a buffer of exactly the cel's size, logs and returns false on corrupt data, and is used one instance per thread.
+	//zlib is the default, define ASE_FAST_INFLATE to use FastInflater instead
+#ifdef ASE_FAST_INFLATE
+	using CelInflater = FastInflater;
+#else
+	using CelInflater = ZlibInflater;
+#endif
+}
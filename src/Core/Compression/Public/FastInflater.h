@@ -0,0 +1,641 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ASE_FAST_INFLATE_SSE2 1
+#endif
+#include "Log/Public/Log.h"
+
+namespace ASE
+{
+	//Single shot zlib/DEFLATE decoder in the style of libdeflate. Unlike zlib's inflate it never has to stop and resume,
+	//the whole compressed cel and the whole destination are available up front, so it can keep a 64 bit bit buffer,
+	//refill it 8 bytes at a time and decode straight into Dst with no window or state machine in between.
+	//Same contract as ZlibInflater, not thread safe so give every thread its own
+	class FastInflater
+	{
+	public:
+		FastInflater() = default;
+		FastInflater(const FastInflater&) = delete;
+		FastInflater& operator=(const FastInflater&) = delete;
+
+		//Returns false unless Src is one complete zlib stream, checksum included, that inflates to exactly DstSize bytes.
+		//Anything after the end of the stream is ignored, same as ZlibInflater
+		bool Inflate(const uint8_t* Src, size_t SrcSize, uint8_t* Dst, size_t DstSize)
+		{
+			m_In = Src;
+			m_InSize = SrcSize;
+			m_InPos = 0;
+			m_Bits = 0;
+			m_BitCount = 0;
+
+			if (SrcSize < 6 || (Src[0] & 0x0F) != 8 || (Src[0] >> 4) > 7 || (Src[1] & 0x20) || ((Src[0] << 8) | Src[1]) % 31 != 0)
+			{
+				CoreLogger::Error("Cel doesn't start with a valid zlib header");
+				return false;
+			}
+			m_InPos = 2;
+
+			uint8_t* Out = Dst;
+			uint8_t* OutEnd = Dst + DstSize;
+			bool LastBlock = false;
+
+			while (!LastBlock)
+			{
+				Refill();
+				LastBlock = Take(1) != 0;
+				uint32_t BlockType = Take(2);
+
+				bool Success = false;
+				switch (BlockType)
+				{
+				case 0:
+				{
+					Success = ReadStoredBlock(Out, OutEnd);
+					break;
+				}
+				case 1:
+				{
+					Success = BuildFixedTables() && DecodeBlock(m_FixedLitLenTable.data(), m_FixedDistTable.data(), Dst, Out, OutEnd);
+					break;
+				}
+				case 2:
+				{
+					Success = ReadDynamicTables() && DecodeBlock(m_LitLenTable.data(), m_DistTable.data(), Dst, Out, OutEnd);
+					break;
+				}
+				default:
+				{
+					CoreLogger::Error("Invalid DEFLATE block type");
+					break;
+				}
+				}
+
+				if (!Success)
+				{
+					return false;
+				}
+			}
+
+			AlignToByte();
+			if (m_InPos + 4 > m_InSize)
+			{
+				CoreLogger::Error("Compressed cel is truncated");
+				return false;
+			}
+
+			if (Out != OutEnd)
+			{
+				CoreLogger::Error("Compressed cel is {} bytes short", (size_t)(OutEnd - Out));
+				return false;
+			}
+
+			const uint8_t* Trailer = m_In + m_InPos;
+			uint32_t Expected = ((uint32_t)Trailer[0] << 24) | ((uint32_t)Trailer[1] << 16) | ((uint32_t)Trailer[2] << 8) | (uint32_t)Trailer[3];
+			if (Adler32(Dst, DstSize) != Expected)
+			{
+				CoreLogger::Error("Compressed cel failed its checksum");
+				return false;
+			}
+
+			return true;
+		}
+
+	private:
+		//Table entries: bits 0-4 codeword length (or subtable index bits), 5-8 extra bits, 9-12 flags, 16-31 value
+		static constexpr uint32_t EntryLiteral = 1u << 9;
+		static constexpr uint32_t EntryEndOfBlock = 1u << 10;
+		static constexpr uint32_t EntrySubtable = 1u << 11;
+		static constexpr uint32_t EntryInvalid = 1u << 12;
+
+		static constexpr int LitLenTableBits = 11;
+		static constexpr int DistTableBits = 8;
+		static constexpr int PrecodeTableBits = 7;
+
+		static constexpr int MaxCodeLength = 15;
+		static constexpr int NumLitLenSymbols = 288;
+		static constexpr int NumDistSymbols = 32;
+		static constexpr int NumPrecodeSymbols = 19;
+
+		//Worst case every long code gets a full 2^(15 - TableBits) subtable
+		static constexpr size_t LitLenTableSize = (1u << LitLenTableBits) + NumLitLenSymbols * (1u << (MaxCodeLength - LitLenTableBits));
+		static constexpr size_t DistTableSize = (1u << DistTableBits) + NumDistSymbols * (1u << (MaxCodeLength - DistTableBits));
+
+		static uint32_t MakeEntry(uint32_t Value, uint32_t Flags, uint32_t ExtraBits, uint32_t Length)
+		{
+			return (Value << 16) | Flags | (ExtraBits << 5) | Length;
+		}
+
+		static uint32_t LitLenEntry(uint32_t Symbol)
+		{
+			static const uint16_t LengthBase[29] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+			static const uint8_t LengthExtra[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+
+			if (Symbol < 256)
+			{
+				return MakeEntry(Symbol, EntryLiteral, 0, 0);
+			}
+			if (Symbol == 256)
+			{
+				return MakeEntry(0, EntryEndOfBlock, 0, 0);
+			}
+			if (Symbol < 286)
+			{
+				return MakeEntry(LengthBase[Symbol - 257], 0, LengthExtra[Symbol - 257], 0);
+			}
+			return MakeEntry(0, EntryInvalid, 0, 0);
+		}
+
+		static uint32_t DistEntry(uint32_t Symbol)
+		{
+			static const uint16_t DistBase[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+			static const uint8_t DistExtra[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+
+			if (Symbol < 30)
+			{
+				return MakeEntry(DistBase[Symbol], 0, DistExtra[Symbol], 0);
+			}
+			return MakeEntry(0, EntryInvalid, 0, 0);
+		}
+
+		static uint32_t PrecodeEntry(uint32_t Symbol)
+		{
+			return MakeEntry(Symbol, 0, 0, 0);
+		}
+
+		//zlib's checksum. The scalar version ends up costing about as much as the inflate itself on flat sprite data,
+		//so on SSE2 it does 16 bytes per step: SAD for the byte sums and a multiply-add against 16..1 for the weighted sums
+		static uint32_t Adler32(const uint8_t* Data, size_t Size)
+		{
+			constexpr uint32_t Mod = 65521;
+			constexpr size_t MaxRun = 5552; // Most bytes that can be summed before s2 could overflow 32 bits
+			uint32_t S1 = 1;
+			uint32_t S2 = 0;
+
+#ifdef ASE_FAST_INFLATE_SSE2
+			const __m128i Zero = _mm_setzero_si128();
+			const __m128i WeightsLo = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+			const __m128i WeightsHi = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+
+			while (Size >= 16)
+			{
+				size_t Blocks = std::min(Size, MaxRun) / 16;
+				Size -= Blocks * 16;
+
+				__m128i Sum1 = _mm_setzero_si128();
+				__m128i Sum1Before = _mm_setzero_si128();
+				__m128i Sum2 = _mm_setzero_si128();
+				S2 += S1 * (uint32_t)(Blocks * 16);
+
+				for (size_t b = 0; b < Blocks; b++, Data += 16)
+				{
+					__m128i Bytes = _mm_loadu_si128((const __m128i*)Data);
+					Sum1Before = _mm_add_epi32(Sum1Before, Sum1);
+					Sum1 = _mm_add_epi32(Sum1, _mm_sad_epu8(Bytes, Zero));
+					Sum2 = _mm_add_epi32(Sum2, _mm_madd_epi16(_mm_unpacklo_epi8(Bytes, Zero), WeightsLo));
+					Sum2 = _mm_add_epi32(Sum2, _mm_madd_epi16(_mm_unpackhi_epi8(Bytes, Zero), WeightsHi));
+				}
+
+				uint32_t Lanes1[4];
+				uint32_t LanesBefore[4];
+				uint32_t Lanes2[4];
+				_mm_storeu_si128((__m128i*)Lanes1, Sum1);
+				_mm_storeu_si128((__m128i*)LanesBefore, Sum1Before);
+				_mm_storeu_si128((__m128i*)Lanes2, Sum2);
+
+				uint64_t BlockSum1 = (uint64_t)Lanes1[0] + Lanes1[2];
+				uint64_t BlockSum2 = 16ull * ((uint64_t)LanesBefore[0] + LanesBefore[2]) + Lanes2[0] + Lanes2[1] + Lanes2[2] + Lanes2[3];
+				S1 = (uint32_t)((S1 + BlockSum1) % Mod);
+				S2 = (uint32_t)((S2 + BlockSum2) % Mod);
+			}
+#endif
+
+			while (Size > 0)
+			{
+				size_t Run = std::min(Size, MaxRun);
+				Size -= Run;
+				for (size_t i = 0; i < Run; i++)
+				{
+					S1 += Data[i];
+					S2 += S1;
+				}
+				Data += Run;
+				S1 %= Mod;
+				S2 %= Mod;
+			}
+
+			return (S2 << 16) | S1;
+		}
+
+		//Keeps at least 56 bits in the buffer. Bytes past the end of the input read as zero,
+		//a stream that actually needed them gets caught by the trailer check
+		inline void Refill()
+		{
+			if (m_InPos + 8 <= m_InSize)
+			{
+				uint64_t Word;
+				memcpy(&Word, m_In + m_InPos, sizeof(Word));
+				m_Bits |= Word << m_BitCount;
+				m_InPos += (63 - m_BitCount) >> 3;
+				m_BitCount |= 56;
+				return;
+			}
+
+			while (m_BitCount <= 56)
+			{
+				uint64_t Byte = m_InPos < m_InSize ? m_In[m_InPos] : 0;
+				m_Bits |= Byte << m_BitCount;
+				m_InPos++;
+				m_BitCount += 8;
+			}
+		}
+
+		inline uint32_t Peek(uint32_t Count) const
+		{
+			return (uint32_t)(m_Bits & ((1ull << Count) - 1));
+		}
+
+		inline void Consume(uint32_t Count)
+		{
+			m_Bits >>= Count;
+			m_BitCount -= Count;
+		}
+
+		inline uint32_t Take(uint32_t Count)
+		{
+			uint32_t Value = Peek(Count);
+			Consume(Count);
+			return Value;
+		}
+
+		//Gives back whole bytes still sitting in the bit buffer so m_InPos points at the next unread byte
+		void AlignToByte()
+		{
+			m_InPos -= m_BitCount >> 3;
+			m_Bits = 0;
+			m_BitCount = 0;
+		}
+
+		inline uint32_t Lookup(const uint32_t* Table, int TableBits)
+		{
+			uint32_t Entry = Table[Peek(TableBits)];
+			if (Entry & EntrySubtable)
+			{
+				Consume(TableBits);
+				Entry = Table[(Entry >> 16) + Peek(Entry & 31)];
+			}
+			Consume(Entry & 31);
+			return Entry;
+		}
+
+		//Canonical Huffman table with TableBits of direct lookup, longer codes go through a subtable hanging off their prefix
+		template<typename EntryFn>
+		bool BuildTable(const uint8_t* Lengths, int NumSymbols, uint32_t* Table, size_t TableSize, int TableBits, EntryFn&& ToEntry)
+		{
+			uint16_t Count[MaxCodeLength + 1] = {};
+			for (int s = 0; s < NumSymbols; s++)
+			{
+				Count[Lengths[s]]++;
+			}
+			Count[0] = 0;
+
+			int Left = 1;
+			for (int l = 1; l <= MaxCodeLength; l++)
+			{
+				Left = (Left << 1) - Count[l];
+				if (Left < 0)
+				{
+					CoreLogger::Error("Over-subscribed Huffman code");
+					return false;
+				}
+			}
+
+			uint32_t NextCode[MaxCodeLength + 1] = {};
+			uint32_t Code = 0;
+			for (int l = 1; l <= MaxCodeLength; l++)
+			{
+				Code = (Code + Count[l - 1]) << 1;
+				NextCode[l] = Code;
+			}
+
+			uint32_t Codes[NumLitLenSymbols];
+			uint8_t LongestForPrefix[1u << LitLenTableBits] = {};
+			uint32_t Mask = (1u << TableBits) - 1;
+			for (int s = 0; s < NumSymbols; s++)
+			{
+				uint32_t Length = Lengths[s];
+				if (Length == 0)
+				{
+					continue;
+				}
+
+				uint32_t Reversed = 0;
+				for (uint32_t c = NextCode[Length]++, b = 0; b < Length; b++, c >>= 1)
+				{
+					Reversed = (Reversed << 1) | (c & 1);
+				}
+				Codes[s] = Reversed;
+
+				if ((int)Length > TableBits && Length > LongestForPrefix[Reversed & Mask])
+				{
+					LongestForPrefix[Reversed & Mask] = (uint8_t)Length;
+				}
+			}
+
+			size_t Used = (size_t)1 << TableBits;
+			for (size_t i = 0; i < Used; i++)
+			{
+				Table[i] = MakeEntry(0, EntryInvalid, 0, 0);
+			}
+
+			for (uint32_t Prefix = 0; Prefix <= Mask; Prefix++)
+			{
+				if (LongestForPrefix[Prefix] == 0)
+				{
+					continue;
+				}
+
+				uint32_t SubBits = LongestForPrefix[Prefix] - TableBits;
+				if (Used + ((size_t)1 << SubBits) > TableSize)
+				{
+					return false;
+				}
+				Table[Prefix] = MakeEntry((uint32_t)Used, EntrySubtable, 0, SubBits);
+				for (size_t i = 0; i < ((size_t)1 << SubBits); i++)
+				{
+					Table[Used + i] = MakeEntry(0, EntryInvalid, 0, 0);
+				}
+				Used += (size_t)1 << SubBits;
+			}
+
+			for (int s = 0; s < NumSymbols; s++)
+			{
+				uint32_t Length = Lengths[s];
+				if (Length == 0)
+				{
+					continue;
+				}
+
+				if ((int)Length <= TableBits)
+				{
+					uint32_t Entry = ToEntry((uint32_t)s) | Length;
+					for (uint32_t i = Codes[s]; i <= Mask; i += 1u << Length)
+					{
+						Table[i] = Entry;
+					}
+					continue;
+				}
+
+				uint32_t Sub = Table[Codes[s] & Mask];
+				uint32_t SubBits = Sub & 31;
+				uint32_t SubLength = Length - TableBits;
+				uint32_t Entry = ToEntry((uint32_t)s) | SubLength;
+				for (uint32_t i = Codes[s] >> TableBits; i < (1u << SubBits); i += 1u << SubLength)
+				{
+					Table[(Sub >> 16) + i] = Entry;
+				}
+			}
+
+			return true;
+		}
+
+		bool BuildFixedTables()
+		{
+			if (m_HasFixedTables)
+			{
+				return true;
+			}
+
+			uint8_t Lengths[NumLitLenSymbols + NumDistSymbols];
+			for (int s = 0; s < 144; s++) Lengths[s] = 8;
+			for (int s = 144; s < 256; s++) Lengths[s] = 9;
+			for (int s = 256; s < 280; s++) Lengths[s] = 7;
+			for (int s = 280; s < NumLitLenSymbols; s++) Lengths[s] = 8;
+			for (int s = 0; s < NumDistSymbols; s++) Lengths[NumLitLenSymbols + s] = 5;
+
+			m_HasFixedTables = BuildTable(Lengths, NumLitLenSymbols, m_FixedLitLenTable.data(), LitLenTableSize, LitLenTableBits, LitLenEntry) &&
+				BuildTable(Lengths + NumLitLenSymbols, NumDistSymbols, m_FixedDistTable.data(), DistTableSize, DistTableBits, DistEntry);
+			return m_HasFixedTables;
+		}
+
+		bool ReadDynamicTables()
+		{
+			static const uint8_t PrecodeOrder[NumPrecodeSymbols] = { 16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15 };
+
+			Refill();
+			uint32_t NumLitLen = Take(5) + 257;
+			uint32_t NumDist = Take(5) + 1;
+			uint32_t NumPrecode = Take(4) + 4;
+
+			uint8_t PrecodeLengths[NumPrecodeSymbols] = {};
+			for (uint32_t i = 0; i < NumPrecode; i++)
+			{
+				Refill();
+				PrecodeLengths[PrecodeOrder[i]] = (uint8_t)Take(3);
+			}
+
+			uint32_t PrecodeTable[1u << PrecodeTableBits];
+			if (!BuildTable(PrecodeLengths, NumPrecodeSymbols, PrecodeTable, sizeof(PrecodeTable) / sizeof(uint32_t), PrecodeTableBits, PrecodeEntry))
+			{
+				return false;
+			}
+
+			uint8_t Lengths[NumLitLenSymbols + NumDistSymbols] = {};
+			uint32_t Total = NumLitLen + NumDist;
+			for (uint32_t i = 0; i < Total;)
+			{
+				Refill();
+				uint32_t Entry = Lookup(PrecodeTable, PrecodeTableBits);
+				if (Entry & EntryInvalid)
+				{
+					CoreLogger::Error("Invalid code length code");
+					return false;
+				}
+
+				uint32_t Symbol = Entry >> 16;
+				if (Symbol < 16)
+				{
+					Lengths[i++] = (uint8_t)Symbol;
+					continue;
+				}
+
+				uint8_t Repeat = 0;
+				uint32_t Times;
+				if (Symbol == 16)
+				{
+					if (i == 0)
+					{
+						CoreLogger::Error("Code length repeat with nothing to repeat");
+						return false;
+					}
+					Repeat = Lengths[i - 1];
+					Times = 3 + Take(2);
+				}
+				else if (Symbol == 17)
+				{
+					Times = 3 + Take(3);
+				}
+				else
+				{
+					Times = 11 + Take(7);
+				}
+
+				if (i + Times > Total)
+				{
+					CoreLogger::Error("Code lengths overflow the table");
+					return false;
+				}
+				memset(Lengths + i, Repeat, Times);
+				i += Times;
+			}
+
+			if (Lengths[256] == 0)
+			{
+				CoreLogger::Error("Block has no end of block code");
+				return false;
+			}
+
+			uint8_t DistLengths[NumDistSymbols] = {};
+			memcpy(DistLengths, Lengths + NumLitLen, NumDist);
+
+			return BuildTable(Lengths, (int)NumLitLen, m_LitLenTable.data(), LitLenTableSize, LitLenTableBits, LitLenEntry) &&
+				BuildTable(DistLengths, NumDistSymbols, m_DistTable.data(), DistTableSize, DistTableBits, DistEntry);
+		}
+
+		bool ReadStoredBlock(uint8_t*& Out, uint8_t* OutEnd)
+		{
+			AlignToByte();
+			if (m_InPos + 4 > m_InSize)
+			{
+				CoreLogger::Error("Compressed cel is truncated");
+				return false;
+			}
+
+			const uint8_t* Header = m_In + m_InPos;
+			uint16_t Length = (uint16_t)(Header[0] | (Header[1] << 8));
+			uint16_t NotLength = (uint16_t)(Header[2] | (Header[3] << 8));
+			m_InPos += 4;
+
+			if ((uint16_t)~Length != NotLength || m_InPos + Length > m_InSize || Length > (size_t)(OutEnd - Out))
+			{
+				CoreLogger::Error("Invalid stored block");
+				return false;
+			}
+
+			memcpy(Out, m_In + m_InPos, Length);
+			Out += Length;
+			m_InPos += Length;
+			return true;
+		}
+
+		bool DecodeBlock(const uint32_t* LitLenTable, const uint32_t* DistTable, const uint8_t* OutBegin, uint8_t*& Out, uint8_t* OutEnd)
+		{
+			for (;;)
+			{
+				Refill();
+				uint32_t Entry = Lookup(LitLenTable, LitLenTableBits);
+
+				if (Entry & EntryLiteral)
+				{
+					if (Out == OutEnd)
+					{
+						CoreLogger::Error("Compressed cel is bigger than the cel");
+						return false;
+					}
+					*Out++ = (uint8_t)(Entry >> 16);
+					continue;
+				}
+
+				if (Entry & EntryEndOfBlock)
+				{
+					return true;
+				}
+
+				if (Entry & EntryInvalid)
+				{
+					CoreLogger::Error("Invalid literal/length code");
+					return false;
+				}
+
+				uint32_t Length = (Entry >> 16) + Take((Entry >> 5) & 15);
+
+				Refill();
+				Entry = Lookup(DistTable, DistTableBits);
+				if (Entry & EntryInvalid)
+				{
+					CoreLogger::Error("Invalid distance code");
+					return false;
+				}
+				size_t Distance = (Entry >> 16) + Take((Entry >> 5) & 15);
+
+				if (Distance > (size_t)(Out - OutBegin) || Length > (size_t)(OutEnd - Out))
+				{
+					CoreLogger::Error("Match runs outside the cel");
+					return false;
+				}
+
+				const uint8_t* Match = Out - Distance;
+				uint8_t* CopyEnd = Out + Length;
+				if (Distance >= 8 && (size_t)(OutEnd - Out) >= Length + 8)
+				{
+					//Every 8 byte chunk only reads bytes that are already written, overshooting the end is fine since there's room
+					do
+					{
+						memcpy(Out, Match, 8);
+						Out += 8;
+						Match += 8;
+					} while (Out < CopyEnd);
+				}
+				else if (Distance == 1)
+				{
+					memset(Out, *Match, Length);
+				}
+				else if ((size_t)(OutEnd - Out) >= Length + 16)
+				{
+					//Short repeats are mostly RGBA pixels. Lay down the pattern until it repeats at 8 bytes or more,
+					//after that it's the same word copy as above
+					size_t Stride = Distance * ((8 + Distance - 1) / Distance);
+					for (size_t i = 0; i < Stride; i++)
+					{
+						Out[i] = Match[i];
+					}
+					Out += Stride;
+					Match = Out - Stride;
+					while (Out < CopyEnd)
+					{
+						memcpy(Out, Match, 8);
+						Out += 8;
+						Match += 8;
+					}
+				}
+				else
+				{
+					while (Out < CopyEnd)
+					{
+						*Out++ = *Match++;
+					}
+				}
+				Out = CopyEnd;
+			}
+		}
+
+	private:
+		const uint8_t* m_In = nullptr;
+		size_t m_InSize = 0;
+		size_t m_InPos = 0;
+		uint64_t m_Bits = 0;
+		uint32_t m_BitCount = 0;
+
+		//Tables live on the heap, together they're far too big to be sitting in a thread_local
+		std::vector<uint32_t> m_LitLenTable = std::vector<uint32_t>(LitLenTableSize);
+		std::vector<uint32_t> m_DistTable = std::vector<uint32_t>(DistTableSize);
+
+		bool m_HasFixedTables = false;
+		std::vector<uint32_t> m_FixedLitLenTable = std::vector<uint32_t>(LitLenTableSize);
+		std::vector<uint32_t> m_FixedDistTable = std::vector<uint32_t>(DistTableSize);
+	};
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <zlib.h>
+#include <cstdint>
+#include <cstddef>
+#include "Log/Public/Log.h"
+
+namespace ASE
+{
+	//Owns one z_stream and keeps it around between cels, inflateReset is a lot cheaper than inflateInit/inflateEnd every time.
+	//Not thread safe, give every thread its own
+	class ZlibInflater
+	{
+	public:
+		ZlibInflater() = default;
+		ZlibInflater(const ZlibInflater&) = delete;
+		ZlibInflater& operator=(const ZlibInflater&) = delete;
+
+		~ZlibInflater()
+		{
+			if (m_Initialized)
+			{
+				inflateEnd(&m_Stream);
+			}
+		}
+
+		//Inflates the whole of Src straight into Dst. The cel size is known up front so there's no staging buffer.
+		//Returns false unless Src is one complete zlib stream, checksum included, that inflates to exactly DstSize bytes.
+		//Anything after the end of the stream is ignored, same as FastInflater
+		bool Inflate(const uint8_t* Src, size_t SrcSize, uint8_t* Dst, size_t DstSize)
+		{
+			if (!Reset())
+			{
+				return false;
+			}
+
+			m_Stream.next_in = (Bytef*)Src;
+			m_Stream.avail_in = (uInt)SrcSize;
+			m_Stream.next_out = (Bytef*)Dst;
+			m_Stream.avail_out = (uInt)DstSize;
+
+			int err = inflate(&m_Stream, Z_FINISH);
+
+			//A stream that fills Dst exactly can run out of output before inflate has read the end of block code and checksum,
+			//so give it one more byte to see whether it really ends there or has more to write
+			if (err == Z_BUF_ERROR && m_Stream.avail_out == 0)
+			{
+				uint8_t Scratch = 0;
+				m_Stream.next_out = &Scratch;
+				m_Stream.avail_out = 1;
+				err = inflate(&m_Stream, Z_FINISH);
+
+				if (m_Stream.avail_out == 0)
+				{
+					CoreLogger::Error("Compressed cel is bigger than the cel");
+					return false;
+				}
+				m_Stream.avail_out = 0;
+			}
+
+			if (err == Z_STREAM_END)
+			{
+				if (m_Stream.avail_out != 0)
+				{
+					CoreLogger::Error("Compressed cel is {} bytes short", m_Stream.avail_out);
+					return false;
+				}
+				return true;
+			}
+
+			if (err == Z_BUF_ERROR)
+			{
+				CoreLogger::Error("Compressed cel is truncated");
+				return false;
+			}
+
+			CoreLogger::Error("Error in inflate");
+			CoreLogger::Error("\tError:{} {}", err, m_Stream.msg ? m_Stream.msg : "");
+			return false;
+		}
+
+	private:
+		bool Reset()
+		{
+			if (m_Initialized)
+			{
+				return inflateReset(&m_Stream) == Z_OK;
+			}
+
+			m_Stream.zalloc = (alloc_func)0;
+			m_Stream.zfree = (free_func)0;
+			m_Stream.opaque = (voidpf)0;
+			m_Stream.next_in = Z_NULL;
+			m_Stream.avail_in = 0;
+
+			if (inflateInit(&m_Stream) != Z_OK)
+			{
+				CoreLogger::Error("Error in inflateInit()");
+				return false;
+			}
+			m_Initialized = true;
+			return true;
+		}
+
+	private:
+		z_stream m_Stream;
+		bool m_Initialized = false;
+	};
+}
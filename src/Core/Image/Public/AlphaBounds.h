@@ -0,0 +1,218 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#define ASE_BOUNDS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#define ASE_BOUNDS_SSE2 1
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ASE
+{
+	//Area of an image in pixels, X and Y from its top left corner
+	struct PixelRect
+	{
+		int32_t X = 0;
+		int32_t Y = 0;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+
+		bool IsEmpty() const { return Width == 0 || Height == 0; }
+	};
+
+	//Finds the smallest rect holding every pixel that isn't fully transparent, for trimming the empty border off frames and cels.
+	//Works on pixels at any of the file depths, a row is scanned 16 or 32 bytes at a time by masking everything but alpha
+	//(or comparing against the transparent index) and looking at which bytes are left set
+	class AlphaBounds
+	{
+	public:
+		//RGBA pixels, Stride is in pixels. Empty if every pixel has alpha 0
+		static PixelRect Find(const uint32_t* Pixels, uint32_t Width, uint32_t Height, size_t Stride)
+		{
+			return Find((const uint8_t*)Pixels, Width, Height, Stride, sizeof(uint32_t));
+		}
+
+		//Pixels at BytesPerPixel (4 RGBA, 2 greyscale, 1 indexed), Stride is in pixels.
+		//Indexed pixels count as transparent if they're TransparentIndex, with -1 (background layers) every pixel is opaque
+		static PixelRect Find(const uint8_t* Pixels, uint32_t Width, uint32_t Height, size_t Stride, size_t BytesPerPixel, int TransparentIndex = -1)
+		{
+			PixelRect Bounds;
+			if (BytesPerPixel == sizeof(uint8_t) && TransparentIndex < 0)
+			{
+				Bounds.Width = Width;
+				Bounds.Height = Height;
+				return Bounds;
+			}
+
+			Scanner Scan(BytesPerPixel, TransparentIndex);
+			size_t RowBytes = (size_t)Width * BytesPerPixel;
+			size_t StrideBytes = Stride * BytesPerPixel;
+
+			uint32_t Top = 0;
+			while (Top < Height && Scan.First(Pixels + Top * StrideBytes, RowBytes) == RowBytes)
+			{
+				Top++;
+			}
+			if (Top == Height)
+			{
+				return Bounds;
+			}
+
+			uint32_t Bottom = Height - 1;
+			while (Bottom > Top && Scan.First(Pixels + Bottom * StrideBytes, RowBytes) == RowBytes)
+			{
+				Bottom--;
+			}
+
+			//Rows in between only need looking at outside the columns already known to be used
+			//Both are byte offsets on pixel boundaries, Right is one past the last used pixel
+			size_t Left = RowBytes;
+			size_t Right = 0;
+			for (uint32_t y = Top; y <= Bottom; y++)
+			{
+				const uint8_t* Row = Pixels + y * StrideBytes;
+				Left = Scan.First(Row, Left) / BytesPerPixel * BytesPerPixel;
+				size_t End = Right + Scan.Last(Row + Right, RowBytes - Right);
+				if (End > Right)
+				{
+					Right = (End + BytesPerPixel - 1) / BytesPerPixel * BytesPerPixel;
+				}
+			}
+
+			Bounds.X = (int32_t)(Left / BytesPerPixel);
+			Bounds.Y = (int32_t)Top;
+			Bounds.Width = (uint32_t)((Right - Left) / BytesPerPixel);
+			Bounds.Height = Bottom - Top + 1;
+			return Bounds;
+		}
+
+	private:
+		//Per byte mask and reference of one pixel repeated across a vector, a byte is opaque if (Byte & Mask) != Ref.
+		//Only the alpha byte is kept for RGBA and greyscale, indexed keeps the whole byte and compares it to the transparent index
+		struct Scanner
+		{
+			uint8_t Mask[32];
+			uint8_t Ref[32];
+
+			Scanner(size_t BytesPerPixel, int TransparentIndex)
+			{
+				for (size_t i = 0; i < 32; i++)
+				{
+					bool IsAlpha = (i % BytesPerPixel) == BytesPerPixel - 1;
+					Mask[i] = BytesPerPixel == sizeof(uint8_t) ? 0xFF : (IsAlpha ? 0xFF : 0);
+					Ref[i] = BytesPerPixel == sizeof(uint8_t) ? (uint8_t)TransparentIndex : 0;
+				}
+			}
+
+			bool IsOpaque(const uint8_t* Row, size_t i) const
+			{
+				return (Row[i] & Mask[i % 32]) != Ref[i % 32];
+			}
+
+			//Byte offset of the first opaque byte in the Bytes bytes at Row, Bytes if there's none
+			size_t First(const uint8_t* Row, size_t Bytes) const
+			{
+				size_t i = 0;
+#if defined(ASE_BOUNDS_AVX2)
+				const __m256i M32 = _mm256_loadu_si256((const __m256i*)Mask);
+				const __m256i R32 = _mm256_loadu_si256((const __m256i*)Ref);
+				for (; i + 32 <= Bytes; i += 32)
+				{
+					__m256i V = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(Row + i)), M32);
+					uint32_t Opaque = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(V, R32));
+					if (Opaque)
+					{
+						return i + LowestBit(Opaque);
+					}
+				}
+#endif
+#if defined(ASE_BOUNDS_SSE2)
+				const __m128i M16 = _mm_loadu_si128((const __m128i*)Mask);
+				const __m128i R16 = _mm_loadu_si128((const __m128i*)Ref);
+				for (; i + 16 <= Bytes; i += 16)
+				{
+					__m128i V = _mm_and_si128(_mm_loadu_si128((const __m128i*)(Row + i)), M16);
+					uint32_t Opaque = ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(V, R16)) & 0xFFFF;
+					if (Opaque)
+					{
+						return i + LowestBit(Opaque);
+					}
+				}
+#endif
+				for (; i < Bytes; i++)
+				{
+					if (IsOpaque(Row, i))
+					{
+						return i;
+					}
+				}
+				return Bytes;
+			}
+
+			//One past the byte offset of the last opaque byte in the Bytes bytes at Row, 0 if there's none.
+			//Row has to start on a pixel, the vectors are lined up from the start so the mask stays in step with the pixels
+			size_t Last(const uint8_t* Row, size_t Bytes) const
+			{
+				size_t i = Bytes;
+#if defined(ASE_BOUNDS_SSE2)
+				size_t Tail = Bytes % 16;
+				for (; i > Bytes - Tail; i--)
+				{
+					if (IsOpaque(Row, i - 1))
+					{
+						return i;
+					}
+				}
+
+				const __m128i M16 = _mm_loadu_si128((const __m128i*)Mask);
+				const __m128i R16 = _mm_loadu_si128((const __m128i*)Ref);
+				for (; i >= 16; i -= 16)
+				{
+					__m128i V = _mm_and_si128(_mm_loadu_si128((const __m128i*)(Row + i - 16)), M16);
+					uint32_t Opaque = ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(V, R16)) & 0xFFFF;
+					if (Opaque)
+					{
+						return i - 16 + HighestBit(Opaque) + 1;
+					}
+				}
+#endif
+				for (; i > 0; i--)
+				{
+					if (IsOpaque(Row, i - 1))
+					{
+						return i;
+					}
+				}
+				return 0;
+			}
+		};
+
+		static uint32_t LowestBit(uint32_t Bits)
+		{
+#if defined(_MSC_VER)
+			unsigned long Index;
+			_BitScanForward(&Index, Bits);
+			return Index;
+#else
+			return (uint32_t)__builtin_ctz(Bits);
+#endif
+		}
+
+		static uint32_t HighestBit(uint32_t Bits)
+		{
+#if defined(_MSC_VER)
+			unsigned long Index;
+			_BitScanReverse(&Index, Bits);
+			return Index;
+#else
+			return 31 - (uint32_t)__builtin_clz(Bits);
+#endif
+		}
+	};
+}
@@ -0,0 +1,439 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include "Log/Public/Log.h"
+#include "Structs/Public/DataStructures.h"
+#include "Image/Public/FrameSet.h"
+#include "Image/Public/AlphaBounds.h"
+#include "Utils/Public/ParallelFor.h"
+
+namespace ASE
+{
+	//Where one frame ended up in the atlas
+	struct AtlasRect
+	{
+		uint16_t Page = 0;
+		uint32_t X = 0; // Pixels on the page
+		uint32_t Y = 0;
+		uint32_t Width = 0; // Trimmed size, 0 if the frame is fully transparent and wasn't packed at all
+		uint32_t Height = 0;
+		float U0 = 0.0f;
+		float V0 = 0.0f;
+		float U1 = 0.0f;
+		float V1 = 0.0f;
+		int32_t OffsetX = 0; // Where the trimmed rect sits on the untrimmed frame
+		int32_t OffsetY = 0;
+	};
+
+	//A tag's frames, FromFrame to ToFrame index into the sprite's Frames
+	struct AtlasTag
+	{
+		std::string Name;
+		uint16_t FromFrame = 0;
+		uint16_t ToFrame = 0;
+		uint8_t LoopDirection = 0;
+		uint16_t RepeatTimes = 0;
+	};
+
+	//Where one key of a slice ended up, taken from the frame the key starts on. FrameX, FrameY is that frame's untrimmed top left on the page,
+	//which is what NineSlice::Build wants along with the page size. Only the trimmed frame was packed, so a slice reaching into transparent
+	//pixels that got trimmed off reads whatever is next to the frame on the page
+	struct AtlasSliceKey
+	{
+		uint16_t Page = 0;
+		int32_t FrameX = 0;
+		int32_t FrameY = 0;
+		float U0 = 0.0f; // The slice's bounds on the page
+		float V0 = 0.0f;
+		float U1 = 0.0f;
+		float V1 = 0.0f;
+	};
+
+	struct AtlasSlice
+	{
+		AsepriteSliceChunk Slice;
+		std::vector<AtlasSliceKey> Keys; // One per key in Slice.Slices
+	};
+
+	struct AtlasSprite
+	{
+		std::string Name;
+		uint32_t Width = 0; // Untrimmed frame size
+		uint32_t Height = 0;
+		std::vector<AtlasRect> Frames;
+		std::vector<uint16_t> Durations;
+		std::vector<AtlasTag> Tags;
+		std::vector<AtlasSlice> Slices;
+
+		//Null if the sprite has no slice called Name
+		const AtlasSlice* FindSlice(std::string_view SliceName) const
+		{
+			for (auto& Slice : Slices)
+			{
+				if (std::string_view(Slice.Slice.Name) == SliceName)
+				{
+					return &Slice;
+				}
+			}
+			return nullptr;
+		}
+	};
+
+	//One power of two RGBA texture
+	struct AtlasPage
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<uint32_t> Pixels;
+	};
+
+	//Packs the frames of any number of sprites into a few texture pages so whole scenes can be drawn from a handful of textures.
+	//Frames are trimmed to the pixels that aren't transparent, frames that look exactly the same are only packed once, and placement is a skyline bottom-left packer
+	class AtlasBuilder
+	{
+	public:
+		//MaxPageSize is rounded down to a power of two. Padding is the gap of transparent pixels kept between frames so filtering doesn't bleed
+		AtlasBuilder(uint32_t MaxPageSize = 4096, uint32_t Padding = 1)
+			:m_MaxPageSize(1), m_Padding(Padding)
+		{
+			while (m_MaxPageSize * 2 <= MaxPageSize)
+			{
+				m_MaxPageSize *= 2;
+			}
+		}
+
+		//Composites every frame of File and queues it up for the next Build. Lazy files need their frames loaded first
+		void AddSprite(const std::string& Name, const AsepriteFileData& File, uint32_t ThreadCount = 0)
+		{
+			AddSprite(Name, std::make_shared<const FrameSet>(File, ThreadCount, true), std::vector<AsepriteTag>(File.Tags.begin(), File.Tags.end()),
+				std::vector<AsepriteSliceChunk>(File.Slices.begin(), File.Slices.end()));
+		}
+
+		void AddSprite(const std::string& Name, std::shared_ptr<const FrameSet> Frames, const std::vector<AsepriteTag>& Tags = {}, const std::vector<AsepriteSliceChunk>& Slices = {})
+		{
+			if (m_SpriteIndex.count(Name))
+			{
+				CoreLogger::Warn("A sprite named {} is already in the atlas, replacing it", Name);
+				m_Pending[m_SpriteIndex[Name]] = { Name, std::move(Frames), Tags, Slices };
+				return;
+			}
+			m_SpriteIndex[Name] = m_Pending.size();
+			m_Pending.push_back({ Name, std::move(Frames), Tags, Slices });
+		}
+
+		//Trims, packs and copies every sprite added so far into pages. Returns false if any frame was too big for a page, the rest are still packed
+		bool Build(uint32_t ThreadCount = 0)
+		{
+			m_Pages.clear();
+			m_Sprites.clear();
+			m_Sprites.resize(m_Pending.size());
+
+			//One entry per stored frame, frames that share a FrameSet slot are packed once
+			struct Entry
+			{
+				size_t Sprite;
+				uint16_t Slot;
+				PixelRect Bounds;
+				AtlasRect Rect;
+			};
+			std::vector<Entry> Entries;
+			std::vector<size_t> SpriteFirstEntry(m_Pending.size());
+			for (size_t s = 0; s < m_Pending.size(); s++)
+			{
+				SpriteFirstEntry[s] = Entries.size();
+				for (uint16_t Slot = 0; Slot < m_Pending[s].Frames->GetSlotCount(); Slot++)
+				{
+					Entries.push_back({ s, Slot, {}, {} });
+				}
+			}
+
+			Utils::ParallelFor(Entries.size(), ThreadCount, [&](size_t i)
+				{
+					const FrameSet& Frames = *m_Pending[Entries[i].Sprite].Frames;
+					const uint32_t* Pixels = Frames.GetBuffer() + Frames.GetFrameStride() * Entries[i].Slot;
+					Entries[i].Bounds = AlphaBounds::Find(Pixels, Frames.GetWidth(), Frames.GetHeight(), Frames.GetWidth());
+				});
+
+			//Tallest first keeps the skyline flat, widest first among the same height
+			std::vector<size_t> Order;
+			for (size_t i = 0; i < Entries.size(); i++)
+			{
+				if (!Entries[i].Bounds.IsEmpty())
+				{
+					Order.push_back(i);
+				}
+			}
+			std::sort(Order.begin(), Order.end(), [&Entries](size_t A, size_t B)
+				{
+					const PixelRect& RA = Entries[A].Bounds;
+					const PixelRect& RB = Entries[B].Bounds;
+					return RA.Height != RB.Height ? RA.Height > RB.Height : (RA.Width != RB.Width ? RA.Width > RB.Width : A < B);
+				});
+
+			bool Success = true;
+			std::vector<Skyline> Skylines;
+			for (size_t i : Order)
+			{
+				Entry& E = Entries[i];
+				//Padding can go past the edge of the page, there's nothing to bleed into there
+				uint32_t Width = std::min(E.Bounds.Width + m_Padding, m_MaxPageSize);
+				uint32_t Height = std::min(E.Bounds.Height + m_Padding, m_MaxPageSize);
+				if (E.Bounds.Width > m_MaxPageSize || E.Bounds.Height > m_MaxPageSize)
+				{
+					CoreLogger::Error("A {}x{} frame of {} doesn't fit on a {} page", E.Bounds.Width, E.Bounds.Height, m_Pending[E.Sprite].Name, m_MaxPageSize);
+					E.Bounds = PixelRect();
+					Success = false;
+					continue;
+				}
+
+				bool Placed = false;
+				for (size_t p = 0; p < Skylines.size() && !Placed; p++)
+				{
+					Placed = Skylines[p].Insert(Width, Height, E.Rect.X, E.Rect.Y);
+					E.Rect.Page = (uint16_t)p;
+				}
+				if (!Placed)
+				{
+					Skylines.emplace_back(m_MaxPageSize);
+					Skylines.back().Insert(Width, Height, E.Rect.X, E.Rect.Y);
+					E.Rect.Page = (uint16_t)(Skylines.size() - 1);
+				}
+				E.Rect.Width = E.Bounds.Width;
+				E.Rect.Height = E.Bounds.Height;
+				E.Rect.OffsetX = E.Bounds.X;
+				E.Rect.OffsetY = E.Bounds.Y;
+			}
+
+			//Pages only need to be big enough for what ended up on them
+			m_Pages.resize(Skylines.size());
+			for (size_t p = 0; p < Skylines.size(); p++)
+			{
+				m_Pages[p].Width = NextPowerOfTwo(Skylines[p].GetUsedWidth());
+				m_Pages[p].Height = NextPowerOfTwo(Skylines[p].GetUsedHeight());
+				m_Pages[p].Pixels.assign((size_t)m_Pages[p].Width * m_Pages[p].Height, 0);
+			}
+
+			//Every frame goes to its own part of a page so they can all be copied at once
+			Utils::ParallelFor(Order.size(), ThreadCount, [&](size_t o)
+				{
+					Entry& E = Entries[Order[o]];
+					if (E.Bounds.IsEmpty())
+					{
+						return;
+					}
+
+					AtlasPage& Page = m_Pages[E.Rect.Page];
+					E.Rect.U0 = (float)E.Rect.X / Page.Width;
+					E.Rect.V0 = (float)E.Rect.Y / Page.Height;
+					E.Rect.U1 = (float)(E.Rect.X + E.Rect.Width) / Page.Width;
+					E.Rect.V1 = (float)(E.Rect.Y + E.Rect.Height) / Page.Height;
+
+					const FrameSet& Frames = *m_Pending[E.Sprite].Frames;
+					const uint32_t* Src = Frames.GetBuffer() + Frames.GetFrameStride() * E.Slot + (size_t)E.Bounds.Y * Frames.GetWidth() + E.Bounds.X;
+					uint32_t* Dst = Page.Pixels.data() + (size_t)E.Rect.Y * Page.Width + E.Rect.X;
+					for (uint32_t y = 0; y < E.Rect.Height; y++)
+					{
+						memcpy(Dst + (size_t)y * Page.Width, Src + (size_t)y * Frames.GetWidth(), E.Rect.Width * sizeof(uint32_t));
+					}
+				});
+
+			for (size_t s = 0; s < m_Pending.size(); s++)
+			{
+				const PendingSprite& Pending = m_Pending[s];
+				AtlasSprite& Sprite = m_Sprites[s];
+				Sprite.Name = Pending.Name;
+				Sprite.Width = Pending.Frames->GetWidth();
+				Sprite.Height = Pending.Frames->GetHeight();
+				for (uint16_t f = 0; f < Pending.Frames->GetFrameCount(); f++)
+				{
+					Sprite.Frames.push_back(Entries[SpriteFirstEntry[s] + Pending.Frames->GetFrameSlot(f)].Rect);
+					Sprite.Durations.push_back(Pending.Frames->GetFrameDuration(f));
+				}
+				for (auto& Tag : Pending.Tags)
+				{
+					Sprite.Tags.push_back({ std::string(Tag.Name), Tag.FromFrame, Tag.ToFrame, Tag.LoopDirection, Tag.RepeatTimes });
+				}
+				for (auto& Slice : Pending.Slices)
+				{
+					AtlasSlice& Placed = Sprite.Slices.emplace_back();
+					Placed.Slice = Slice;
+					for (auto& Key : Slice.Slices)
+					{
+						//Left empty if the key's frame is past the end or was fully transparent and never packed
+						AtlasSliceKey& PlacedKey = Placed.Keys.emplace_back();
+						if (Key.FrameNumber >= Sprite.Frames.size() || Sprite.Frames[Key.FrameNumber].Width == 0)
+						{
+							continue;
+						}
+
+						const AtlasRect& Rect = Sprite.Frames[Key.FrameNumber];
+						const AtlasPage& Page = m_Pages[Rect.Page];
+						PlacedKey.Page = Rect.Page;
+						PlacedKey.FrameX = (int32_t)Rect.X - Rect.OffsetX;
+						PlacedKey.FrameY = (int32_t)Rect.Y - Rect.OffsetY;
+						PlacedKey.U0 = (float)(PlacedKey.FrameX + Key.SliceX) / Page.Width;
+						PlacedKey.V0 = (float)(PlacedKey.FrameY + Key.SliceY) / Page.Height;
+						PlacedKey.U1 = (float)(PlacedKey.FrameX + Key.SliceX + (int32_t)Key.SliceWidth) / Page.Width;
+						PlacedKey.V1 = (float)(PlacedKey.FrameY + Key.SliceY + (int32_t)Key.SliceHeight) / Page.Height;
+					}
+				}
+			}
+
+			return Success;
+		}
+
+		const std::vector<AtlasPage>& GetPages() const { return m_Pages; }
+		const std::vector<AtlasSprite>& GetSprites() const { return m_Sprites; }
+
+		//Null if there's no sprite called Name or Build hasn't been called since it was added
+		const AtlasSprite* GetSprite(const std::string& Name) const
+		{
+			auto It = m_SpriteIndex.find(Name);
+			return It == m_SpriteIndex.end() || It->second >= m_Sprites.size() ? nullptr : &m_Sprites[It->second];
+		}
+
+	private:
+		struct PendingSprite
+		{
+			std::string Name;
+			std::shared_ptr<const FrameSet> Frames;
+			std::vector<AsepriteTag> Tags;
+			std::vector<AsepriteSliceChunk> Slices;
+		};
+
+		//Bottom-left skyline of one page. Every rect goes on the lowest stretch of skyline it fits on, the narrowest stretch if there's a tie
+		//so the wide gaps are left for the wide rects
+		class Skyline
+		{
+		public:
+			Skyline(uint32_t Size)
+				:m_Size(Size)
+			{
+				m_Nodes.push_back({ 0, 0, Size });
+			}
+
+			bool Insert(uint32_t Width, uint32_t Height, uint32_t& X, uint32_t& Y)
+			{
+				size_t Best = m_Nodes.size();
+				uint32_t BestY = m_Size;
+				uint32_t BestWidth = m_Size;
+				for (size_t i = 0; i < m_Nodes.size(); i++)
+				{
+					uint32_t FitY;
+					if (!Fits(i, Width, Height, FitY))
+					{
+						continue;
+					}
+					if (FitY < BestY || (FitY == BestY && m_Nodes[i].Width < BestWidth))
+					{
+						Best = i;
+						BestY = FitY;
+						BestWidth = m_Nodes[i].Width;
+					}
+				}
+				if (Best == m_Nodes.size())
+				{
+					return false;
+				}
+
+				X = m_Nodes[Best].X;
+				Y = BestY;
+				m_UsedWidth = std::max(m_UsedWidth, X + Width);
+				m_UsedHeight = std::max(m_UsedHeight, Y + Height);
+
+				//The new node covers the start of the ones after it, those get cut down or dropped
+				m_Nodes.insert(m_Nodes.begin() + Best, { X, Y + Height, Width });
+				for (size_t i = Best + 1; i < m_Nodes.size();)
+				{
+					uint32_t End = m_Nodes[i - 1].X + m_Nodes[i - 1].Width;
+					if (m_Nodes[i].X >= End)
+					{
+						break;
+					}
+					uint32_t Cut = End - m_Nodes[i].X;
+					if (Cut >= m_Nodes[i].Width)
+					{
+						m_Nodes.erase(m_Nodes.begin() + i);
+						continue;
+					}
+					m_Nodes[i].X += Cut;
+					m_Nodes[i].Width -= Cut;
+					break;
+				}
+
+				//Neighbours at the same height are one node
+				for (size_t i = 0; i + 1 < m_Nodes.size();)
+				{
+					if (m_Nodes[i].Y == m_Nodes[i + 1].Y)
+					{
+						m_Nodes[i].Width += m_Nodes[i + 1].Width;
+						m_Nodes.erase(m_Nodes.begin() + i + 1);
+						continue;
+					}
+					i++;
+				}
+				return true;
+			}
+
+			uint32_t GetUsedWidth() const { return m_UsedWidth; }
+			uint32_t GetUsedHeight() const { return m_UsedHeight; }
+
+		private:
+			struct Node
+			{
+				uint32_t X;
+				uint32_t Y;
+				uint32_t Width;
+			};
+
+			//Y is the height the rect would sit at if its left edge went at node Index, the top of every node it spans
+			bool Fits(size_t Index, uint32_t Width, uint32_t Height, uint32_t& Y) const
+			{
+				if (m_Nodes[Index].X + Width > m_Size)
+				{
+					return false;
+				}
+
+				Y = 0;
+				uint32_t Remaining = Width;
+				for (size_t i = Index; Remaining > 0; i++)
+				{
+					Y = std::max(Y, m_Nodes[i].Y);
+					if (Y + Height > m_Size)
+					{
+						return false;
+					}
+					Remaining -= std::min(Remaining, m_Nodes[i].Width);
+				}
+				return true;
+			}
+
+			uint32_t m_Size;
+			uint32_t m_UsedWidth = 0;
+			uint32_t m_UsedHeight = 0;
+			std::vector<Node> m_Nodes;
+		};
+
+		static uint32_t NextPowerOfTwo(uint32_t Value)
+		{
+			uint32_t Result = 1;
+			while (Result < Value)
+			{
+				Result *= 2;
+			}
+			return Result;
+		}
+
+		uint32_t m_MaxPageSize;
+		uint32_t m_Padding;
+		std::vector<PendingSprite> m_Pending;
+		std::vector<AtlasSprite> m_Sprites;
+		std::unordered_map<std::string, size_t> m_SpriteIndex;
+		std::vector<AtlasPage> m_Pages;
+	};
+}
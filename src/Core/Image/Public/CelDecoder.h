@@ -0,0 +1,379 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include "Log/Public/Log.h"
+#include "Structs/Public/DataStructures.h"
+#include "Compression/Public/CelInflater.h"
+#include "Image/Public/Compositor.h"
+#include "Image/Public/AlphaBounds.h"
+#include "Utils/Public/ParallelFor.h"
+#include "Utils/Public/Hash.h"
+
+namespace ASE
+{
+	//One cel of a frame along with how it has to be blended in.
+	//Cel is the chunk as it sits in the frame, Source is the one that actually holds the pixels, position and opacity.
+	//They're the same cel unless it's linked (CelType 1), then every link shares Source's decoded Pixels instead of inflating it again
+	struct DecodedCel
+	{
+		const AsepriteCelChunk* Cel;
+		const AsepriteCelChunk* Source;
+		AsepriteBlendMode Mode = AsepriteBlendMode::Normal;
+		uint8_t Opacity = 255;
+		std::shared_ptr<const std::vector<uint8_t>> Pixels; // Source->Width * Source->Height pixels at the file's depth, null if it couldn't be decoded
+		bool IsBackground = false; // Indexed background layers draw the transparent index as a colour
+		PixelRect Bounds{}; // Part of Source that gets drawn, all of it unless FindBounds found a transparent border
+		size_t Stride = 0; // Pixels from one row of Pixels to the next
+		size_t Offset = 0; // Pixels from the start of Pixels to the top left of Bounds
+		const AsepriteTileset* Tileset = nullptr; // Set for tilemap cels instead of Pixels, they're drawn tile by tile from Source->Tilemap
+
+		int GetX() const { return Source->x + Bounds.X; }
+		int GetY() const { return Source->y + Bounds.Y; }
+	};
+
+	//What a DecodeAll call cost and what sharing linked cels saved
+	struct CelDecodeStats
+	{
+		size_t Cels = 0;
+		size_t DecodedCels = 0;
+		size_t DecodedBytes = 0;
+		size_t SharedBytes = 0; // Bytes linked cels would have taken up if each one had its own copy
+		size_t DuplicateCels = 0; // Cels that weren't links but held the same bytes as another cel, only filled in when deduplicating
+		size_t DuplicateBytes = 0; // Decoded bytes those duplicates didn't need
+		size_t TransparentBytes = 0; // Decoded bytes of fully transparent border FindBounds left out of the cels
+		size_t TilemapCels = 0; // Cels drawn from a tileset, nothing gets decoded for them
+	};
+
+	//Picks out the cels that make up a frame and decodes them, shared by Image and FrameSet
+	class CelDecoder
+	{
+	public:
+		//Every cel of a frame that ends up on screen, in the order Aseprite draws them (bottom first)
+		static std::vector<DecodedCel> CollectFrameCels(const AsepriteFileData& File, uint16_t Frame)
+		{
+			std::vector<DecodedCel> Cels;
+			if (Frame >= File.Frames.size())
+			{
+				CoreLogger::Warn("Frame {} is out of range, the file only has {} frames", Frame, File.Frames.size());
+				return Cels;
+			}
+			if (!File.Frames[Frame].CelsLoaded)
+			{
+				CoreLogger::Warn("Frame {} was parsed lazily and hasn't been loaded yet, call AsepriteParser::LoadFrame first", Frame);
+			}
+
+			//Layer opacity is only meant to be used when the header says it's valid
+			bool UseLayerOpacity = (File.Header.Flags & 1) != 0;
+
+			//A layer is only shown if it and every group above it are visible, Child is how deep in the groups it is
+			std::vector<bool> GroupVisible;
+			for (auto& L : File.Frames[Frame].Layers)
+			{
+				bool Visible = (L.Flags & (uint16_t)AsepriteLayerFlags::Visible) && (L.Child == 0 || (L.Child <= GroupVisible.size() && GroupVisible[L.Child - 1]));
+				GroupVisible.resize((size_t)L.Child + 1);
+				GroupVisible[L.Child] = Visible;
+
+				if (!Visible || (L.Flags & (uint16_t)AsepriteLayerFlags::Reference))
+				{
+					continue;
+				}
+
+				//Tilemaps without their tiles (an external tileset) have nothing to draw
+				const AsepriteTileset* Tileset = nullptr;
+				if (L.Type == 2)
+				{
+					Tileset = FindTileset(File, L.TilesetIndex);
+					if (!Tileset || !Tileset->Pixels)
+					{
+						continue;
+					}
+				}
+
+				uint8_t LayerOpacity = UseLayerOpacity ? L.Opacity : 255;
+				for (auto& C : L.CelChunks)
+				{
+					const AsepriteCelChunk* Source = ResolveLink(File, C);
+					if (Source && (Source->CelType == 3) == (Tileset != nullptr))
+					{
+						Cels.push_back({ &C, Source, (AsepriteBlendMode)L.BlendMode, (uint8_t)Compositor::MulUn8(Source->Opacity, LayerOpacity), nullptr, (L.Flags & (uint16_t)AsepriteLayerFlags::Background) != 0 });
+						Cels.back().Tileset = Tileset;
+					}
+				}
+			}
+
+			//Same order Aseprite draws in, layer index shifted by the cel's z-index
+			std::stable_sort(Cels.begin(), Cels.end(), [](const DecodedCel& A, const DecodedCel& B)
+				{
+					return (A.Cel->order() < B.Cel->order()) || (A.Cel->order() == B.Cel->order() && A.Cel->zIndex < B.Cel->zIndex);
+				});
+
+			return Cels;
+		}
+
+		//The cel holding the pixels for C, following links back to the frame they point at. Null if there's nothing to draw
+		static const AsepriteCelChunk* ResolveLink(const AsepriteFileData& File, const AsepriteCelChunk& C)
+		{
+			const AsepriteCelChunk* Cel = &C;
+
+			//Aseprite always links straight to a cel with pixels, the limit is only there so a broken file can't loop forever
+			for (size_t Hops = 0; Cel && Cel->CelType == 1 && Hops < File.Frames.size(); Hops++)
+			{
+				Cel = FindCel(File, Cel->FramePosition, Cel->LayerIndex);
+			}
+
+			if (!Cel || (Cel->PixelDatas.empty() && Cel->CelType != 3))
+			{
+				if (C.CelType == 1)
+				{
+					CoreLogger::Warn("Linked cel on layer {} points at frame {} which has nothing to link to", C.LayerIndex, C.FramePosition);
+				}
+				return nullptr;
+			}
+			return Cel;
+		}
+
+		//The tileset a tilemap layer's TilesetIndex refers to, null if the file doesn't have it
+		static const AsepriteTileset* FindTileset(const AsepriteFileData& File, uint32_t ID)
+		{
+			for (auto& Tileset : File.Tilesets)
+			{
+				if (Tileset.ID == ID)
+				{
+					return &Tileset;
+				}
+			}
+			CoreLogger::Warn("Tilemap layer uses tileset {} which isn't in the file", ID);
+			return nullptr;
+		}
+
+		//Every cel is its own zlib stream, so they all get inflated on their own thread.
+		//A source cel that several links point at is only inflated once and its buffer handed to all of them.
+		//With Deduplicate, cels that aren't links but have exactly the same compressed bytes (copy pasted frames) share one buffer too
+		static CelDecodeStats DecodeAll(std::vector<DecodedCel>& Cels, size_t BytesPerPixel, uint32_t ThreadCount, bool Deduplicate = false)
+		{
+			CelDecodeStats Stats;
+			std::unordered_map<const AsepriteCelChunk*, size_t> SourceIndex;
+			std::vector<const AsepriteCelChunk*> Sources;
+			for (auto& Cel : Cels)
+			{
+				if (Cel.Tileset)
+				{
+					continue;
+				}
+				if (SourceIndex.emplace(Cel.Source, Sources.size()).second)
+				{
+					Sources.push_back(Cel.Source);
+				}
+			}
+
+			//Unique[i] is the first source with the same content as source i, only those get decoded
+			std::vector<size_t> Unique(Sources.size());
+			for (size_t i = 0; i < Sources.size(); i++)
+			{
+				Unique[i] = i;
+			}
+			if (Deduplicate)
+			{
+				std::vector<uint64_t> Hashes(Sources.size());
+				Utils::ParallelFor(Sources.size(), ThreadCount, [&](size_t i)
+					{
+						const AsepritePixelData& Data = Sources[i]->PixelDatas[0];
+						Hashes[i] = Utils::Hash64(Data.GetData(), Data.GetSize());
+					});
+
+				//Equal hashes still get their bytes compared, two different cels must never end up sharing pixels
+				std::unordered_map<uint64_t, std::vector<size_t>> Seen;
+				for (size_t i = 0; i < Sources.size(); i++)
+				{
+					auto& Candidates = Seen[Hashes[i]];
+					for (size_t c : Candidates)
+					{
+						if (SameContent(*Sources[c], *Sources[i]))
+						{
+							Unique[i] = c;
+							break;
+						}
+					}
+					if (Unique[i] == i)
+					{
+						Candidates.push_back(i);
+					}
+				}
+			}
+
+			std::vector<size_t> ToDecode;
+			for (size_t i = 0; i < Sources.size(); i++)
+			{
+				if (Unique[i] == i)
+				{
+					ToDecode.push_back(i);
+				}
+			}
+
+			std::vector<std::shared_ptr<const std::vector<uint8_t>>> Decoded(Sources.size());
+			Utils::ParallelFor(ToDecode.size(), ThreadCount, [&](size_t i)
+				{
+					Decoded[ToDecode[i]] = Decode(*Sources[ToDecode[i]], BytesPerPixel);
+				});
+
+			Stats.Cels = Cels.size();
+			Stats.DecodedCels = ToDecode.size();
+			for (size_t i = 0; i < Sources.size(); i++)
+			{
+				if (Unique[i] != i)
+				{
+					Decoded[i] = Decoded[Unique[i]];
+					Stats.DuplicateCels++;
+					Stats.DuplicateBytes += Decoded[i] ? Decoded[i]->size() : 0;
+				}
+				else
+				{
+					Stats.DecodedBytes += Decoded[i] ? Decoded[i]->size() : 0;
+				}
+			}
+
+			for (auto& Cel : Cels)
+			{
+				//A tilemap's bounds are the whole grid in pixels
+				if (Cel.Tileset)
+				{
+					Cel.Bounds = { 0, 0, (uint32_t)Cel.Source->Width * Cel.Tileset->TileWidth, (uint32_t)Cel.Source->Height * Cel.Tileset->TileHeight };
+					Stats.TilemapCels++;
+					continue;
+				}
+				Cel.Pixels = Decoded[SourceIndex[Cel.Source]];
+				Cel.Bounds = { 0, 0, Cel.Source->Width, Cel.Source->Height };
+				Cel.Stride = Cel.Source->Width;
+				Cel.Offset = 0;
+				Stats.SharedBytes += Cel.Pixels ? Cel.Pixels->size() : 0;
+			}
+			Stats.SharedBytes -= Stats.DecodedBytes + Stats.DuplicateBytes;
+
+			return Stats;
+		}
+
+		//Shrinks every decoded cel's Bounds down to the pixels that aren't transparent, so blending skips the empty border.
+		//With Trim those pixels are also copied out into a buffer of just that size and the old one let go, otherwise Offset and Stride point into the original.
+		//Either way GetX/GetY are where the bounds go on the canvas. Cels sharing pixels are only scanned once.
+		//TransparentIndex is the file's transparent colour for indexed cels, background layers never have a transparent pixel.
+		//Deduplicated cels can share a buffer across a background layer and a normal one, so indexed cels are scanned once per buffer and kind of layer. Returns the bytes left out
+		static size_t FindBounds(std::vector<DecodedCel>& Cels, size_t BytesPerPixel, uint8_t TransparentIndex, uint32_t ThreadCount, bool Trim = false)
+		{
+			auto IsOpaque = [BytesPerPixel](const DecodedCel& Cel) { return BytesPerPixel == 1 && Cel.IsBackground; };
+
+			std::unordered_map<const std::vector<uint8_t>*, size_t> BufferIndex[2]; // By whether the cel is opaque
+			std::vector<size_t> Unique;
+			for (size_t c = 0; c < Cels.size(); c++)
+			{
+				if (Cels[c].Pixels && BufferIndex[IsOpaque(Cels[c])].emplace(Cels[c].Pixels.get(), Unique.size()).second)
+				{
+					Unique.push_back(c);
+				}
+			}
+
+			std::vector<PixelRect> Bounds(Unique.size());
+			std::vector<std::shared_ptr<const std::vector<uint8_t>>> Trimmed(Unique.size());
+			Utils::ParallelFor(Unique.size(), ThreadCount, [&](size_t i)
+				{
+					const DecodedCel& Cel = Cels[Unique[i]];
+					const AsepriteCelChunk& C = *Cel.Source;
+					Bounds[i] = AlphaBounds::Find(Cel.Pixels->data(), C.Width, C.Height, C.Width, BytesPerPixel, Cel.IsBackground ? -1 : TransparentIndex);
+					if (!Trim || (Bounds[i].Width == C.Width && Bounds[i].Height == C.Height))
+					{
+						return;
+					}
+
+					auto Pixels = std::make_shared<std::vector<uint8_t>>((size_t)Bounds[i].Width * Bounds[i].Height * BytesPerPixel);
+					for (uint32_t y = 0; y < Bounds[i].Height; y++)
+					{
+						const uint8_t* Src = Cel.Pixels->data() + ((size_t)(Bounds[i].Y + y) * C.Width + Bounds[i].X) * BytesPerPixel;
+						std::copy(Src, Src + (size_t)Bounds[i].Width * BytesPerPixel, Pixels->data() + (size_t)y * Bounds[i].Width * BytesPerPixel);
+					}
+					Trimmed[i] = Pixels;
+				});
+
+			size_t TransparentBytes = 0;
+			for (size_t i = 0; i < Unique.size(); i++)
+			{
+				const AsepriteCelChunk& C = *Cels[Unique[i]].Source;
+				TransparentBytes += ((size_t)C.Width * C.Height - (size_t)Bounds[i].Width * Bounds[i].Height) * BytesPerPixel;
+			}
+
+			for (auto& Cel : Cels)
+			{
+				if (!Cel.Pixels)
+				{
+					continue;
+				}
+
+				size_t i = BufferIndex[IsOpaque(Cel)][Cel.Pixels.get()];
+				Cel.Bounds = Bounds[i];
+				if (Trimmed[i])
+				{
+					Cel.Pixels = Trimmed[i];
+					Cel.Stride = Bounds[i].Width;
+					Cel.Offset = 0;
+				}
+				else
+				{
+					Cel.Stride = Cel.Source->Width;
+					Cel.Offset = (size_t)Bounds[i].Y * Cel.Stride + Bounds[i].X;
+				}
+			}
+			return TransparentBytes;
+		}
+
+		//Returns null if the cel couldn't be inflated
+		static std::shared_ptr<const std::vector<uint8_t>> Decode(const AsepriteCelChunk& C, size_t BytesPerPixel)
+		{
+			const AsepritePixelData& Data = C.PixelDatas[0];
+			auto Pixels = std::make_shared<std::vector<uint8_t>>((size_t)C.Width * C.Height * BytesPerPixel);
+
+			if (C.CelType == 0)
+			{
+				//Raw cels are stored uncompressed
+				std::copy(Data.GetData(), Data.GetData() + std::min(Data.GetSize(), Pixels->size()), Pixels->begin());
+				return Pixels;
+			}
+
+			if (!Inflate(Data.GetData(), Data.GetSize(), Pixels->data(), Pixels->size()))
+			{
+				return nullptr;
+			}
+			return Pixels;
+		}
+
+		//Inflates a whole zlib stream into exactly DstSize bytes, for cels and anything else in the file stored the same way (tilesets, tilemaps)
+		static bool Inflate(const uint8_t* Src, size_t SrcSize, uint8_t* Dst, size_t DstSize)
+		{
+			//One inflater per thread, reset between streams instead of being set up from scratch every time
+			static thread_local CelInflater Inflater;
+			return Src && Inflater.Inflate(Src, SrcSize, Dst, DstSize);
+		}
+
+	private:
+		//Two cels decode to the same pixels if they're the same size and stored the same way with the same bytes
+		static bool SameContent(const AsepriteCelChunk& A, const AsepriteCelChunk& B)
+		{
+			const AsepritePixelData& DataA = A.PixelDatas[0];
+			const AsepritePixelData& DataB = B.PixelDatas[0];
+			return A.Width == B.Width && A.Height == B.Height && A.CelType == B.CelType && DataA.GetSize() == DataB.GetSize()
+				&& memcmp(DataA.GetData(), DataB.GetData(), DataA.GetSize()) == 0;
+		}
+
+		static const AsepriteCelChunk* FindCel(const AsepriteFileData& File, uint16_t Frame, uint16_t LayerIndex)
+		{
+			if (Frame >= File.Frames.size() || LayerIndex >= File.Frames[Frame].Layers.size())
+			{
+				return nullptr;
+			}
+
+			//A layer only ever has one cel per frame
+			const auto& Cels = File.Frames[Frame].Layers[LayerIndex].CelChunks;
+			return Cels.empty() ? nullptr : &Cels.front();
+		}
+	};
+}
@@ -0,0 +1,561 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include "Structs/Public/DataStructures.h"
+
+#if defined(__AVX2__)
+#define ASE_COMPOSITE_AVX2 1
+#endif
+#if defined(__SSE4_1__) || defined(__AVX__) || defined(__AVX2__)
+#define ASE_COMPOSITE_SSE41 1
+#include <immintrin.h>
+#endif
+
+namespace ASE
+{
+	//Blends RGBA pixels (R in the low byte, A in the high byte, the same as Aseprite stores them) the way Aseprite does.
+	//Every mode works out the blended colour first, fades it towards the source by the backdrop's alpha,
+	//then lays it over the backdrop with the source alpha * opacity. That last "normal" step runs for every mode and every pixel
+	//so it's the one that gets the SSE4.1/AVX2 treatment, the simple separable modes are vectorized too and the rest stay scalar
+	class Compositor
+	{
+	public:
+		//Blends Count source pixels over Dst in place
+		static void BlendRow(uint32_t* Dst, const uint32_t* Src, size_t Count, AsepriteBlendMode Mode, uint8_t Opacity)
+		{
+			if (Opacity == 0)
+			{
+				return;
+			}
+
+			if (Mode == AsepriteBlendMode::Normal)
+			{
+				NormalRow(Dst, Src, Count, Opacity);
+				return;
+			}
+
+			//Blend into a small stack buffer, then lay that over the backdrop
+			constexpr size_t ChunkSize = 256;
+			uint32_t Blended[ChunkSize];
+			for (size_t Start = 0; Start < Count; Start += ChunkSize)
+			{
+				size_t Num = std::min(ChunkSize, Count - Start);
+				ModeRow(Dst + Start, Src + Start, Blended, Num, Mode);
+				NormalRow(Dst + Start, Blended, Num, Opacity);
+			}
+		}
+
+		//Blends a whole cel into a canvas at X/Y, anything hanging off the canvas gets clipped.
+		//CanvasStride and CelStride are in pixels
+		static void CompositeCel(uint32_t* Canvas, uint32_t CanvasWidth, uint32_t CanvasHeight, size_t CanvasStride,
+			const uint32_t* Cel, int X, int Y, uint32_t CelWidth, uint32_t CelHeight, size_t CelStride,
+			AsepriteBlendMode Mode, uint8_t Opacity)
+		{
+			int X0 = std::max(X, 0);
+			int Y0 = std::max(Y, 0);
+			int X1 = std::min(X + (int)CelWidth, (int)CanvasWidth);
+			int Y1 = std::min(Y + (int)CelHeight, (int)CanvasHeight);
+			if (X0 >= X1 || Y0 >= Y1)
+			{
+				return;
+			}
+
+			for (int y = Y0; y < Y1; ++y)
+			{
+				BlendRow(Canvas + (size_t)y * CanvasStride + X0, Cel + (size_t)(y - Y) * CelStride + (X0 - X), (size_t)(X1 - X0), Mode, Opacity);
+			}
+		}
+
+		//Indexed pixels can't be blended without going through the palette, so like Aseprite drawing indexed onto indexed
+		//a pixel just replaces what's under it unless it's the transparent index. TransparentIndex of -1 copies every pixel (background layers)
+		static void CopyIndexedRow(uint8_t* Dst, const uint8_t* Src, size_t Count, int TransparentIndex)
+		{
+			if (TransparentIndex < 0)
+			{
+				std::copy(Src, Src + Count, Dst);
+				return;
+			}
+
+			size_t i = 0;
+#if defined(ASE_COMPOSITE_AVX2)
+			__m256i Transparent32 = _mm256_set1_epi8((char)TransparentIndex);
+			for (; i + 32 <= Count; i += 32)
+			{
+				__m256i B = _mm256_loadu_si256((const __m256i*)(Dst + i));
+				__m256i S = _mm256_loadu_si256((const __m256i*)(Src + i));
+				_mm256_storeu_si256((__m256i*)(Dst + i), _mm256_blendv_epi8(S, B, _mm256_cmpeq_epi8(S, Transparent32)));
+			}
+#endif
+#if defined(ASE_COMPOSITE_SSE41)
+			__m128i Transparent16 = _mm_set1_epi8((char)TransparentIndex);
+			for (; i + 16 <= Count; i += 16)
+			{
+				__m128i B = _mm_loadu_si128((const __m128i*)(Dst + i));
+				__m128i S = _mm_loadu_si128((const __m128i*)(Src + i));
+				_mm_storeu_si128((__m128i*)(Dst + i), _mm_blendv_epi8(S, B, _mm_cmpeq_epi8(S, Transparent16)));
+			}
+#endif
+			for (; i < Count; i++)
+			{
+				Dst[i] = Src[i] == TransparentIndex ? Dst[i] : Src[i];
+			}
+		}
+
+		static void CompositeIndexedCel(uint8_t* Canvas, uint32_t CanvasWidth, uint32_t CanvasHeight, size_t CanvasStride,
+			const uint8_t* Cel, int X, int Y, uint32_t CelWidth, uint32_t CelHeight, size_t CelStride, int TransparentIndex)
+		{
+			int X0 = std::max(X, 0);
+			int Y0 = std::max(Y, 0);
+			int X1 = std::min(X + (int)CelWidth, (int)CanvasWidth);
+			int Y1 = std::min(Y + (int)CelHeight, (int)CanvasHeight);
+			if (X0 >= X1 || Y0 >= Y1)
+			{
+				return;
+			}
+
+			for (int y = Y0; y < Y1; ++y)
+			{
+				CopyIndexedRow(Canvas + (size_t)y * CanvasStride + X0, Cel + (size_t)(y - Y) * CelStride + (X0 - X), (size_t)(X1 - X0), TransparentIndex);
+			}
+		}
+
+		//Single pixel version of BlendRow
+		static uint32_t BlendPixel(uint32_t Backdrop, uint32_t Src, AsepriteBlendMode Mode, uint8_t Opacity)
+		{
+			//Same as BlendRow, otherwise a transparent backdrop would still pick up the source's colour
+			if (Opacity == 0)
+			{
+				return Backdrop;
+			}
+			if (Mode != AsepriteBlendMode::Normal)
+			{
+				Src = ModePixel(Backdrop, Src, Mode);
+			}
+			return NormalPixel(Backdrop, Src, Opacity);
+		}
+
+		static inline uint32_t MulUn8(uint32_t A, uint32_t B)
+		{
+			uint32_t T = A * B + 0x80;
+			return ((T >> 8) + T) >> 8;
+		}
+
+		static inline uint32_t DivUn8(uint32_t A, uint32_t B)
+		{
+			return (A * 0xFF + (B / 2)) / B;
+		}
+
+	private:
+		static inline uint32_t GetR(uint32_t C) { return C & 0xFF; }
+		static inline uint32_t GetG(uint32_t C) { return (C >> 8) & 0xFF; }
+		static inline uint32_t GetB(uint32_t C) { return (C >> 16) & 0xFF; }
+		static inline uint32_t GetA(uint32_t C) { return C >> 24; }
+		static inline uint32_t MakeRGBA(uint32_t R, uint32_t G, uint32_t B, uint32_t A) { return R | (G << 8) | (B << 16) | (A << 24); }
+
+		//https://github.com/aseprite/aseprite/blob/main/src/doc/blend_funcs.cpp rgba_blender_normal
+		static inline uint32_t NormalPixel(uint32_t Backdrop, uint32_t Src, uint32_t Opacity)
+		{
+			if (GetA(Backdrop) == 0)
+			{
+				return (Src & 0x00FFFFFF) | (MulUn8(GetA(Src), Opacity) << 24);
+			}
+			if (GetA(Src) == 0)
+			{
+				return Backdrop;
+			}
+
+			int Ba = (int)GetA(Backdrop);
+			int Sa = (int)MulUn8(GetA(Src), Opacity);
+			int Ra = Sa + Ba - (int)MulUn8(Ba, Sa);
+
+			int Rr = (int)GetR(Backdrop) + ((int)GetR(Src) - (int)GetR(Backdrop)) * Sa / Ra;
+			int Rg = (int)GetG(Backdrop) + ((int)GetG(Src) - (int)GetG(Backdrop)) * Sa / Ra;
+			int Rb = (int)GetB(Backdrop) + ((int)GetB(Src) - (int)GetB(Backdrop)) * Sa / Ra;
+
+			return MakeRGBA(Rr, Rg, Rb, Ra);
+		}
+
+		static void NormalRow(uint32_t* Dst, const uint32_t* Src, size_t Count, uint32_t Opacity)
+		{
+			size_t i = 0;
+#if defined(ASE_COMPOSITE_AVX2)
+			__m256i Opacity8 = _mm256_set1_epi32((int)Opacity);
+			for (; i + 8 <= Count; i += 8)
+			{
+				__m256i B = _mm256_loadu_si256((const __m256i*)(Dst + i));
+				__m256i S = _mm256_loadu_si256((const __m256i*)(Src + i));
+				_mm256_storeu_si256((__m256i*)(Dst + i), NormalPixels(B, S, Opacity8));
+			}
+#endif
+#if defined(ASE_COMPOSITE_SSE41)
+			__m128i Opacity4 = _mm_set1_epi32((int)Opacity);
+			for (; i + 4 <= Count; i += 4)
+			{
+				__m128i B = _mm_loadu_si128((const __m128i*)(Dst + i));
+				__m128i S = _mm_loadu_si128((const __m128i*)(Src + i));
+				_mm_storeu_si128((__m128i*)(Dst + i), NormalPixels(B, S, Opacity4));
+			}
+#endif
+			for (; i < Count; i++)
+			{
+				Dst[i] = NormalPixel(Dst[i], Src[i], Opacity);
+			}
+		}
+
+#if defined(ASE_COMPOSITE_SSE41)
+		static inline __m128i MulUn8(__m128i A, __m128i B)
+		{
+			__m128i T = _mm_add_epi32(_mm_mullo_epi32(A, B), _mm_set1_epi32(0x80));
+			return _mm_srli_epi32(_mm_add_epi32(_mm_srli_epi32(T, 8), T), 8);
+		}
+
+		//Same as NormalPixel for 4 pixels. The division by Ra is done in float, every numerator and denominator is well inside
+		//float's exact integer range and the gap to the next integer is always bigger than the rounding error so truncating matches the integer version
+		template<int Shift>
+		static inline __m128i NormalChannel(__m128i B, __m128i S, __m128i Sa, __m128 Ra)
+		{
+			const __m128i Mask = _mm_set1_epi32(0xFF);
+			__m128i Bc = _mm_and_si128(_mm_srli_epi32(B, Shift), Mask);
+			__m128i Sc = _mm_and_si128(_mm_srli_epi32(S, Shift), Mask);
+			__m128 Num = _mm_cvtepi32_ps(_mm_mullo_epi32(_mm_sub_epi32(Sc, Bc), Sa));
+			__m128i Rc = _mm_add_epi32(Bc, _mm_cvttps_epi32(_mm_div_ps(Num, Ra)));
+			return _mm_slli_epi32(Rc, Shift);
+		}
+
+		static inline __m128i NormalPixels(__m128i B, __m128i S, __m128i Opacity)
+		{
+			const __m128i Zero = _mm_setzero_si128();
+			__m128i SrcA = _mm_srli_epi32(S, 24);
+			__m128i Ba = _mm_srli_epi32(B, 24);
+			__m128i Sa = MulUn8(SrcA, Opacity);
+			__m128i Ra = _mm_sub_epi32(_mm_add_epi32(Sa, Ba), MulUn8(Ba, Sa));
+			__m128 RaF = _mm_cvtepi32_ps(Ra);
+
+			__m128i Result = _mm_slli_epi32(Ra, 24);
+			Result = _mm_or_si128(Result, NormalChannel<0>(B, S, Sa, RaF));
+			Result = _mm_or_si128(Result, NormalChannel<8>(B, S, Sa, RaF));
+			Result = _mm_or_si128(Result, NormalChannel<16>(B, S, Sa, RaF));
+
+			__m128i OverEmpty = _mm_or_si128(_mm_and_si128(S, _mm_set1_epi32(0x00FFFFFF)), _mm_slli_epi32(Sa, 24));
+			Result = _mm_blendv_epi8(Result, B, _mm_cmpeq_epi32(SrcA, Zero));
+			return _mm_blendv_epi8(Result, OverEmpty, _mm_cmpeq_epi32(Ba, Zero));
+		}
+#endif
+
+#if defined(ASE_COMPOSITE_AVX2)
+		static inline __m256i MulUn8(__m256i A, __m256i B)
+		{
+			__m256i T = _mm256_add_epi32(_mm256_mullo_epi32(A, B), _mm256_set1_epi32(0x80));
+			return _mm256_srli_epi32(_mm256_add_epi32(_mm256_srli_epi32(T, 8), T), 8);
+		}
+
+		template<int Shift>
+		static inline __m256i NormalChannel(__m256i B, __m256i S, __m256i Sa, __m256 Ra)
+		{
+			const __m256i Mask = _mm256_set1_epi32(0xFF);
+			__m256i Bc = _mm256_and_si256(_mm256_srli_epi32(B, Shift), Mask);
+			__m256i Sc = _mm256_and_si256(_mm256_srli_epi32(S, Shift), Mask);
+			__m256 Num = _mm256_cvtepi32_ps(_mm256_mullo_epi32(_mm256_sub_epi32(Sc, Bc), Sa));
+			__m256i Rc = _mm256_add_epi32(Bc, _mm256_cvttps_epi32(_mm256_div_ps(Num, Ra)));
+			return _mm256_slli_epi32(Rc, Shift);
+		}
+
+		static inline __m256i NormalPixels(__m256i B, __m256i S, __m256i Opacity)
+		{
+			const __m256i Zero = _mm256_setzero_si256();
+			__m256i SrcA = _mm256_srli_epi32(S, 24);
+			__m256i Ba = _mm256_srli_epi32(B, 24);
+			__m256i Sa = MulUn8(SrcA, Opacity);
+			__m256i Ra = _mm256_sub_epi32(_mm256_add_epi32(Sa, Ba), MulUn8(Ba, Sa));
+			__m256 RaF = _mm256_cvtepi32_ps(Ra);
+
+			__m256i Result = _mm256_slli_epi32(Ra, 24);
+			Result = _mm256_or_si256(Result, NormalChannel<0>(B, S, Sa, RaF));
+			Result = _mm256_or_si256(Result, NormalChannel<8>(B, S, Sa, RaF));
+			Result = _mm256_or_si256(Result, NormalChannel<16>(B, S, Sa, RaF));
+
+			__m256i OverEmpty = _mm256_or_si256(_mm256_and_si256(S, _mm256_set1_epi32(0x00FFFFFF)), _mm256_slli_epi32(Sa, 24));
+			Result = _mm256_blendv_epi8(Result, B, _mm256_cmpeq_epi32(SrcA, Zero));
+			return _mm256_blendv_epi8(Result, OverEmpty, _mm256_cmpeq_epi32(Ba, Zero));
+		}
+#endif
+
+		//Separable modes, one channel at a time. B is the backdrop, S the source
+		static inline uint32_t BlendChannel(AsepriteBlendMode Mode, uint32_t B, uint32_t S)
+		{
+			switch (Mode)
+			{
+			case AsepriteBlendMode::Multiply: return MulUn8(B, S);
+			case AsepriteBlendMode::Screen: return B + S - MulUn8(B, S);
+			case AsepriteBlendMode::Overlay: return HardLight(S, B);
+			case AsepriteBlendMode::Darken: return std::min(B, S);
+			case AsepriteBlendMode::Lighten: return std::max(B, S);
+			case AsepriteBlendMode::ColorDodge:
+			{
+				if (B == 0)
+				{
+					return 0;
+				}
+				S = 255 - S;
+				return B >= S ? 255 : DivUn8(B, S);
+			}
+			case AsepriteBlendMode::ColorBurn:
+			{
+				if (B == 255)
+				{
+					return 255;
+				}
+				B = 255 - B;
+				return B >= S ? 0 : 255 - DivUn8(B, S);
+			}
+			case AsepriteBlendMode::HardLight: return HardLight(B, S);
+			case AsepriteBlendMode::SoftLight:
+			{
+				double b = B / 255.0;
+				double s = S / 255.0;
+				double d = b <= 0.25 ? ((16 * b - 12) * b + 4) * b : std::sqrt(b);
+				double r = s <= 0.5 ? b - (1 - 2 * s) * b * (1 - b) : b + (2 * s - 1) * (d - b);
+				return (uint32_t)(r * 255 + 0.5);
+			}
+			case AsepriteBlendMode::Difference: return B > S ? B - S : S - B;
+			case AsepriteBlendMode::Exclusion: return B + S - 2 * MulUn8(B, S);
+			case AsepriteBlendMode::Addition: return std::min(B + S, 255u);
+			case AsepriteBlendMode::Subtract: return B > S ? B - S : 0;
+			case AsepriteBlendMode::Divide:
+			{
+				if (B == 0)
+				{
+					return 0;
+				}
+				return B >= S ? 255 : DivUn8(B, S);
+			}
+			default: return S;
+			}
+		}
+
+		static inline uint32_t HardLight(uint32_t B, uint32_t S)
+		{
+			if (S < 128)
+			{
+				return MulUn8(B, S << 1);
+			}
+			uint32_t S2 = (S << 1) - 255;
+			return B + S2 - MulUn8(B, S2);
+		}
+
+		//Hue, Saturation, Color and Luminosity work on the whole colour at once
+		static double Lum(double R, double G, double B) { return 0.3 * R + 0.59 * G + 0.11 * B; }
+		static double Sat(double R, double G, double B) { return std::max({ R, G, B }) - std::min({ R, G, B }); }
+
+		static void ClipColor(double& R, double& G, double& B)
+		{
+			double L = Lum(R, G, B);
+			double N = std::min({ R, G, B });
+			double X = std::max({ R, G, B });
+
+			if (N < 0)
+			{
+				R = L + (((R - L) * L) / (L - N));
+				G = L + (((G - L) * L) / (L - N));
+				B = L + (((B - L) * L) / (L - N));
+			}
+			if (X > 1)
+			{
+				R = L + (((R - L) * (1 - L)) / (X - L));
+				G = L + (((G - L) * (1 - L)) / (X - L));
+				B = L + (((B - L) * (1 - L)) / (X - L));
+			}
+		}
+
+		static void SetLum(double& R, double& G, double& B, double L)
+		{
+			double D = L - Lum(R, G, B);
+			R += D;
+			G += D;
+			B += D;
+			ClipColor(R, G, B);
+		}
+
+		static void SetSat(double& R, double& G, double& B, double S)
+		{
+			double* Max = &R;
+			double* Mid = &G;
+			double* Min = &B;
+			if (*Mid > *Max) std::swap(Mid, Max);
+			if (*Min > *Max) std::swap(Min, Max);
+			if (*Min > *Mid) std::swap(Min, Mid);
+
+			if (*Max > *Min)
+			{
+				*Mid = ((*Mid - *Min) * S) / (*Max - *Min);
+				*Max = S;
+			}
+			else
+			{
+				*Mid = 0;
+				*Max = 0;
+			}
+			*Min = 0;
+		}
+
+		static uint32_t BlendNonSeparable(uint32_t Backdrop, uint32_t Src, AsepriteBlendMode Mode)
+		{
+			double Br = GetR(Backdrop) / 255.0, Bg = GetG(Backdrop) / 255.0, Bb = GetB(Backdrop) / 255.0;
+			double Sr = GetR(Src) / 255.0, Sg = GetG(Src) / 255.0, Sb = GetB(Src) / 255.0;
+			double R, G, B;
+
+			switch (Mode)
+			{
+			case AsepriteBlendMode::Hue:
+			{
+				R = Sr; G = Sg; B = Sb;
+				SetSat(R, G, B, Sat(Br, Bg, Bb));
+				SetLum(R, G, B, Lum(Br, Bg, Bb));
+				break;
+			}
+			case AsepriteBlendMode::Saturation:
+			{
+				R = Br; G = Bg; B = Bb;
+				SetSat(R, G, B, Sat(Sr, Sg, Sb));
+				SetLum(R, G, B, Lum(Br, Bg, Bb));
+				break;
+			}
+			case AsepriteBlendMode::Color:
+			{
+				R = Sr; G = Sg; B = Sb;
+				SetLum(R, G, B, Lum(Br, Bg, Bb));
+				break;
+			}
+			default:
+			{
+				R = Br; G = Bg; B = Bb;
+				SetLum(R, G, B, Lum(Sr, Sg, Sb));
+				break;
+			}
+			}
+
+			auto ToByte = [](double V) { return (uint32_t)std::clamp(V * 255.0 + 0.5, 0.0, 255.0); };
+			return MakeRGBA(ToByte(R), ToByte(G), ToByte(B), 0);
+		}
+
+		//Works out the blended colour and fades it back towards the source where the backdrop is see-through,
+		//keeps the source's alpha so NormalPixel can lay it down
+		static inline uint32_t ModePixel(uint32_t Backdrop, uint32_t Src, AsepriteBlendMode Mode)
+		{
+			uint32_t Blended;
+			if (Mode >= AsepriteBlendMode::Hue && Mode <= AsepriteBlendMode::Luminosity)
+			{
+				Blended = BlendNonSeparable(Backdrop, Src, Mode);
+			}
+			else
+			{
+				Blended = MakeRGBA(BlendChannel(Mode, GetR(Backdrop), GetR(Src)), BlendChannel(Mode, GetG(Backdrop), GetG(Src)), BlendChannel(Mode, GetB(Backdrop), GetB(Src)), 0);
+			}
+
+			uint32_t Ba = GetA(Backdrop);
+			auto Mix = [Ba](uint32_t S, uint32_t M) { return std::min(MulUn8(S, 255 - Ba) + MulUn8(M, Ba), 255u); };
+			return MakeRGBA(Mix(GetR(Src), GetR(Blended)), Mix(GetG(Src), GetG(Blended)), Mix(GetB(Src), GetB(Blended)), GetA(Src));
+		}
+
+		static void ModeRow(const uint32_t* Dst, const uint32_t* Src, uint32_t* Out, size_t Count, AsepriteBlendMode Mode)
+		{
+			size_t i = 0;
+#if defined(ASE_COMPOSITE_SSE41)
+			if (HasSimdMode(Mode))
+			{
+				for (; i + 4 <= Count; i += 4)
+				{
+					__m128i B = _mm_loadu_si128((const __m128i*)(Dst + i));
+					__m128i S = _mm_loadu_si128((const __m128i*)(Src + i));
+					_mm_storeu_si128((__m128i*)(Out + i), ModePixels(B, S, Mode));
+				}
+			}
+#endif
+			for (; i < Count; i++)
+			{
+				Out[i] = ModePixel(Dst[i], Src[i], Mode);
+			}
+		}
+
+#if defined(ASE_COMPOSITE_SSE41)
+		static bool HasSimdMode(AsepriteBlendMode Mode)
+		{
+			switch (Mode)
+			{
+			case AsepriteBlendMode::Multiply:
+			case AsepriteBlendMode::Screen:
+			case AsepriteBlendMode::Overlay:
+			case AsepriteBlendMode::HardLight:
+			case AsepriteBlendMode::Darken:
+			case AsepriteBlendMode::Lighten:
+			case AsepriteBlendMode::Difference:
+			case AsepriteBlendMode::Exclusion:
+			case AsepriteBlendMode::Addition:
+			case AsepriteBlendMode::Subtract:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		//MulUn8 on 8 16 bit lanes, a * b + 0x80 never leaves 16 bits for bytes
+		static inline __m128i MulUn8x16(__m128i A, __m128i B)
+		{
+			__m128i T = _mm_add_epi16(_mm_mullo_epi16(A, B), _mm_set1_epi16(0x80));
+			return _mm_srli_epi16(_mm_add_epi16(_mm_srli_epi16(T, 8), T), 8);
+		}
+
+		static inline __m128i HardLight16(__m128i B, __m128i S)
+		{
+			__m128i S2 = _mm_slli_epi16(S, 1);
+			__m128i Dark = MulUn8x16(B, S2);
+			S2 = _mm_sub_epi16(S2, _mm_set1_epi16(255));
+			__m128i Light = _mm_sub_epi16(_mm_add_epi16(B, S2), MulUn8x16(B, S2));
+			return _mm_blendv_epi8(Light, Dark, _mm_cmplt_epi16(S, _mm_set1_epi16(128)));
+		}
+
+		static inline __m128i BlendChannels16(__m128i B, __m128i S, AsepriteBlendMode Mode)
+		{
+			switch (Mode)
+			{
+			case AsepriteBlendMode::Multiply: return MulUn8x16(B, S);
+			case AsepriteBlendMode::Screen: return _mm_sub_epi16(_mm_add_epi16(B, S), MulUn8x16(B, S));
+			case AsepriteBlendMode::Overlay: return HardLight16(S, B);
+			case AsepriteBlendMode::HardLight: return HardLight16(B, S);
+			case AsepriteBlendMode::Darken: return _mm_min_epi16(B, S);
+			case AsepriteBlendMode::Lighten: return _mm_max_epi16(B, S);
+			case AsepriteBlendMode::Difference: return _mm_or_si128(_mm_subs_epu16(B, S), _mm_subs_epu16(S, B));
+			case AsepriteBlendMode::Exclusion: return _mm_sub_epi16(_mm_add_epi16(B, S), _mm_slli_epi16(MulUn8x16(B, S), 1));
+			case AsepriteBlendMode::Addition: return _mm_min_epi16(_mm_add_epi16(B, S), _mm_set1_epi16(255));
+			case AsepriteBlendMode::Subtract: return _mm_subs_epu16(B, S);
+			default: return S;
+			}
+		}
+
+		//ModePixel for 4 pixels, worked in 16 bit lanes two pixels at a time
+		static inline __m128i ModePixels(__m128i B, __m128i S, AsepriteBlendMode Mode)
+		{
+			const __m128i Zero = _mm_setzero_si128();
+			const __m128i AlphaSpread = _mm_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+			const __m128i AlphaMask = _mm_set1_epi32((int)0xFF000000);
+
+			__m128i Ba = _mm_shuffle_epi8(B, AlphaSpread);
+			__m128i InvBa = _mm_sub_epi8(_mm_set1_epi8((char)0xFF), Ba);
+
+			auto Half = [&](__m128i B16, __m128i S16, __m128i Ba16, __m128i InvBa16)
+				{
+					__m128i M16 = BlendChannels16(B16, S16, Mode);
+					return _mm_add_epi16(MulUn8x16(S16, InvBa16), MulUn8x16(M16, Ba16));
+				};
+
+			__m128i Lo = Half(_mm_unpacklo_epi8(B, Zero), _mm_unpacklo_epi8(S, Zero), _mm_unpacklo_epi8(Ba, Zero), _mm_unpacklo_epi8(InvBa, Zero));
+			__m128i Hi = Half(_mm_unpackhi_epi8(B, Zero), _mm_unpackhi_epi8(S, Zero), _mm_unpackhi_epi8(Ba, Zero), _mm_unpackhi_epi8(InvBa, Zero));
+
+			__m128i Mixed = _mm_packus_epi16(Lo, Hi);
+			return _mm_blendv_epi8(Mixed, S, AlphaMask);
+		}
+#endif
+	};
+}
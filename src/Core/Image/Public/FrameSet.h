@@ -0,0 +1,243 @@
+#pragma once
+#include <vector>
+#include <cstring>
+#include <unordered_map>
+#include "Log/Public/Log.h"
+#include "Structs/Public/DataStructures.h"
+#include "Image/Public/CelDecoder.h"
+#include "Image/Public/Compositor.h"
+#include "Image/Public/Palette.h"
+#include "Image/Public/PixelExpander.h"
+#include "Image/Public/TilemapRenderer.h"
+#include "Image/Public/PixelBuffer.h"
+#include "Utils/Public/ParallelFor.h"
+#include "Utils/Public/Hash.h"
+
+namespace ASE
+{
+	//Every frame of a file composited into RGBA, all of them in one allocation one after another.
+	//Frame i starts at GetFrameStride() * GetFrameSlot(i) pixels, so the whole buffer can go to a texture array in one upload.
+	//Slots are the frame numbers unless the set was deduplicated, then frames that came out the same share a slot
+	class FrameSet
+	{
+	public:
+		FrameSet() = default;
+		//ThreadCount is how many threads cels get inflated and frames composited on, 0 uses every hardware thread.
+		//Deduplicate shares cels with the same compressed bytes and frames with the same pixels, see GetDecodeStats() and GetDuplicateFrameCount() for what it saved
+		FrameSet(const AsepriteFileData& File, uint32_t ThreadCount = 0, bool Deduplicate = false)
+			:m_Width(File.Header.Width), m_Height(File.Header.Height), m_FrameCount((uint16_t)File.Frames.size()), m_SlotCount((uint16_t)File.Frames.size())
+		{
+			size_t BytesPerPixel = File.Header.Depth / 8;
+			if (BytesPerPixel != sizeof(uint32_t) && BytesPerPixel != sizeof(uint16_t) && BytesPerPixel != sizeof(uint8_t))
+			{
+				CoreLogger::Warn("Unable to make a FrameSet from a {} bit sprite", File.Header.Depth);
+				m_FrameCount = 0;
+				m_SlotCount = 0;
+				return;
+			}
+
+			m_Pixels = PixelBuffer(GetFrameStride() * m_FrameCount * sizeof(uint32_t));
+			std::fill(m_Pixels.As<uint32_t>(), m_Pixels.As<uint32_t>() + GetFrameStride() * m_FrameCount, 0);
+			m_Durations.resize(m_FrameCount);
+			m_Slots.resize(m_FrameCount);
+			for (uint16_t f = 0; f < m_FrameCount; f++)
+			{
+				m_Slots[f] = f;
+			}
+
+			//Indexed frames look up through the palette as it is at that frame, layers other than the background see the transparent index as see-through.
+			//Frames that don't change the palette share it, and the see-through copy is only made once per distinct palette
+			std::vector<std::shared_ptr<const Palette>> Palettes;
+			std::vector<std::shared_ptr<const Palette>> LayerPalettes;
+			if (BytesPerPixel == sizeof(uint8_t))
+			{
+				Palettes = Palette::ForAllFrames(File);
+				for (size_t f = 0; f < Palettes.size(); f++)
+				{
+					bool Shared = f > 0 && Palettes[f] == Palettes[f - 1];
+					LayerPalettes.push_back(Shared ? LayerPalettes[f - 1] : std::make_shared<const Palette>(Palettes[f]->WithTransparentIndex(File.Header.EntryIndex)));
+				}
+			}
+
+			//Every frame's cels go in one list so the inflating is balanced across the whole file, not frame by frame
+			std::vector<DecodedCel> Cels;
+			std::vector<size_t> FrameStart(m_FrameCount + 1);
+			for (uint16_t f = 0; f < m_FrameCount; f++)
+			{
+				m_Durations[f] = File.Frames[f].FrameDuration;
+				FrameStart[f] = Cels.size();
+
+				std::vector<DecodedCel> FrameCels = CelDecoder::CollectFrameCels(File, f);
+				for (auto& Cel : FrameCels)
+				{
+					Cels.push_back(std::move(Cel));
+				}
+			}
+			FrameStart[m_FrameCount] = Cels.size();
+
+			m_DecodeStats = CelDecoder::DecodeAll(Cels, BytesPerPixel, ThreadCount, Deduplicate);
+			m_DecodeStats.TransparentBytes = CelDecoder::FindBounds(Cels, BytesPerPixel, File.Header.EntryIndex, ThreadCount);
+
+			//Tilesets are expanded once per palette they're drawn with here, frames only walk their tile indices
+			ExpandedTilesets Tilesets;
+			for (uint16_t f = 0; f < m_FrameCount; f++)
+			{
+				for (size_t c = FrameStart[f]; c < FrameStart[f + 1]; c++)
+				{
+					if (Cels[c].Tileset && !Cels[c].Bounds.IsEmpty())
+					{
+						Tilesets.Add(*Cels[c].Tileset, BytesPerPixel, GetCelColors(Cels[c], f, Palettes, LayerPalettes));
+					}
+				}
+			}
+
+			//Frames don't share any pixels, so each one is composited on its own thread
+			Utils::ParallelFor(m_FrameCount, ThreadCount, [&](size_t f)
+				{
+					uint32_t* Canvas = GetFrame((uint16_t)f);
+					std::vector<uint32_t> Converted;
+					std::vector<uint8_t> FlippedTile;
+					for (size_t c = FrameStart[f]; c < FrameStart[f + 1]; c++)
+					{
+						const DecodedCel& Cel = Cels[c];
+						if ((!Cel.Pixels && !Cel.Tileset) || Cel.Bounds.IsEmpty())
+						{
+							continue;
+						}
+
+						const uint32_t* Colors = GetCelColors(Cel, f, Palettes, LayerPalettes);
+
+						//Tilemaps go straight from the expanded tileset to the canvas a tile at a time
+						if (Cel.Tileset)
+						{
+							const uint32_t* Tiles = Tilesets.Find(*Cel.Tileset, BytesPerPixel, Colors);
+							if (!Tiles)
+							{
+								continue;
+							}
+							TilemapRenderer::ForEachTile(Cel.Source->Tilemap, *Cel.Tileset, (const uint8_t*)Tiles, sizeof(uint32_t), Cel.GetX(), Cel.GetY(), FlippedTile,
+								[&](const uint8_t* Tile, int X, int Y, uint32_t Width, uint32_t Height, size_t Stride)
+								{
+									Compositor::CompositeCel(Canvas, m_Width, m_Height, m_Width, (const uint32_t*)Tile, X, Y, Width, Height, Stride, Cel.Mode, Cel.Opacity);
+								});
+							continue;
+						}
+
+						const uint32_t* Src = PixelExpander::ToRGBA(*Cel.Pixels, BytesPerPixel, Colors, Converted);
+						Compositor::CompositeCel(Canvas, m_Width, m_Height, m_Width, Src + Cel.Offset, Cel.GetX(), Cel.GetY(), Cel.Bounds.Width, Cel.Bounds.Height, Cel.Stride, Cel.Mode, Cel.Opacity);
+					}
+				});
+
+			if (Deduplicate)
+			{
+				DeduplicateFrames(ThreadCount);
+			}
+		}
+
+		//The pixels have one owner, share a set as a std::shared_ptr<const FrameSet> instead of copying it
+		FrameSet(const FrameSet&) = delete;
+		FrameSet(FrameSet&&) = default;
+		FrameSet& operator=(const FrameSet&) = delete;
+		FrameSet& operator=(FrameSet&&) = default;
+		~FrameSet() = default;
+
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+		uint16_t GetFrameCount() const { return m_FrameCount; }
+		//Frames actually stored in the buffer, less than GetFrameCount() if deduplicating found frames that look the same
+		uint16_t GetSlotCount() const { return m_SlotCount; }
+		//Which of the stored frames frame Frame is, its layer in a texture array made from GetBuffer()
+		uint16_t GetFrameSlot(uint16_t Frame) const { return m_Slots[Frame]; }
+		//Pixels from the start of one frame to the next
+		size_t GetFrameStride() const { return (size_t)m_Width * m_Height; }
+		//How long a frame is shown for in milliseconds
+		uint16_t GetFrameDuration(uint16_t Frame) const { return m_Durations[Frame]; }
+		const uint16_t* GetDurations() const { return m_Durations.data(); }
+
+		uint32_t* GetFrame(uint16_t Frame) { return m_Pixels.As<uint32_t>() + GetFrameStride() * m_Slots[Frame]; }
+		const uint32_t* GetFrame(uint16_t Frame) const { return m_Pixels.As<uint32_t>() + GetFrameStride() * m_Slots[Frame]; }
+
+		uint32_t* GetBuffer() { return m_Pixels.As<uint32_t>(); }
+		const uint32_t* GetBuffer() const { return m_Pixels.As<uint32_t>(); }
+		size_t GetByteSize() const { return GetFrameStride() * m_SlotCount * sizeof(uint32_t); }
+
+		//Memory report for the cels that went into the frames, SharedBytes is what linked cels would have cost without sharing their source's pixels
+		const CelDecodeStats& GetDecodeStats() const { return m_DecodeStats; }
+		//Frames that were dropped for looking exactly like an earlier one, and the bytes that saved
+		uint16_t GetDuplicateFrameCount() const { return m_FrameCount - m_SlotCount; }
+		size_t GetDuplicateFrameBytes() const { return GetDuplicateFrameCount() * GetFrameStride() * sizeof(uint32_t); }
+
+	private:
+		//The palette an indexed cel is looked up through on frame Frame, null for other depths
+		static const uint32_t* GetCelColors(const DecodedCel& Cel, size_t Frame, const std::vector<std::shared_ptr<const Palette>>& Palettes,
+			const std::vector<std::shared_ptr<const Palette>>& LayerPalettes)
+		{
+			if (Palettes.empty())
+			{
+				return nullptr;
+			}
+			return Cel.IsBackground ? Palettes[Frame]->GetColors() : LayerPalettes[Frame]->GetColors();
+		}
+
+		//Points frames with the same pixels at the first of them and packs the rest down so the buffer only holds each look once
+		void DeduplicateFrames(uint32_t ThreadCount)
+		{
+			size_t Stride = GetFrameStride();
+			std::vector<uint64_t> Hashes(m_FrameCount);
+			Utils::ParallelFor(m_FrameCount, ThreadCount, [&](size_t f)
+				{
+					Hashes[f] = Utils::Hash64(m_Pixels.As<uint32_t>() + Stride * f, Stride * sizeof(uint32_t));
+				});
+
+			std::unordered_map<uint64_t, std::vector<uint16_t>> Seen;
+			uint16_t Slot = 0;
+			for (uint16_t f = 0; f < m_FrameCount; f++)
+			{
+				const uint32_t* Pixels = m_Pixels.As<uint32_t>() + Stride * f;
+				auto& Candidates = Seen[Hashes[f]];
+
+				bool Found = false;
+				for (uint16_t c : Candidates)
+				{
+					if (memcmp(m_Pixels.As<uint32_t>() + Stride * c, Pixels, Stride * sizeof(uint32_t)) == 0)
+					{
+						m_Slots[f] = c;
+						Found = true;
+						break;
+					}
+				}
+				if (Found)
+				{
+					continue;
+				}
+
+				//Slots only ever move down, so the frame being moved into has already been looked at
+				if (Slot != f)
+				{
+					memcpy(m_Pixels.As<uint32_t>() + Stride * Slot, Pixels, Stride * sizeof(uint32_t));
+				}
+				m_Slots[f] = Slot;
+				Candidates.push_back(Slot);
+				Slot++;
+			}
+
+			//The full size block goes back to the pool for the next sprite this size
+			m_SlotCount = Slot;
+			if (m_SlotCount < m_FrameCount)
+			{
+				PixelBuffer Packed(Stride * m_SlotCount * sizeof(uint32_t));
+				memcpy(Packed.GetData(), m_Pixels.GetData(), Packed.GetSize());
+				m_Pixels = std::move(Packed);
+			}
+		}
+
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint16_t m_FrameCount = 0;
+		uint16_t m_SlotCount = 0;
+		PixelBuffer m_Pixels; // 64 byte aligned, recycled through the PixelBufferPool
+		std::vector<uint16_t> m_Slots;
+		std::vector<uint16_t> m_Durations;
+		CelDecodeStats m_DecodeStats;
+	};
+}
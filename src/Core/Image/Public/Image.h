@@ -1,8 +1,15 @@
 #pragma once
 #include <vector>
+#include <utility>
+#include <algorithm>
 #include "Log/Public/Log.h"
 #include "Structs/Public/DataStructures.h"
 #include "Serializer/Public/DataReader.h"
+#include "Image/Public/CelDecoder.h"
+#include "Image/Public/TilemapRenderer.h"
+#include "Image/Public/Palette.h"
+#include "Image/Public/PixelExpander.h"
+#include "Image/Public/PixelBuffer.h"
 
 namespace ASE
 {
@@ -38,8 +45,13 @@ namespace ASE
 			}
 			case PixelType::Greyscale:
 			{
-				CoreLogger::Warn("There is currently no implementation for textures with 2 channels!");
 				PixelsPerByte = 0;
+				break;
+			}
+			case PixelType::Indexed:
+			{
+				PixelsPerByte = 1;
+				break;
 			}
 			default:
 			{
@@ -70,9 +82,15 @@ namespace ASE
 			}
 			case PixelType::Greyscale:
 			{
-				CoreLogger::Warn("There is currently no implementation for textures with 2 channels!");
 				Channels = 2;
 				PixelsPerByte = 0;
+				break;
+			}
+			case PixelType::Indexed:
+			{
+				Channels = 1;
+				PixelsPerByte = 1;
+				break;
 			}
 			default:
 			{
@@ -137,6 +155,8 @@ namespace ASE
 		}
 
 		AsepriteFileData& GetFileData() { return FileData; }
+		//Which frame of the file the Image composites
+		uint16_t GetFrame() const { return Frame; }
 
 
 		void SetFileData(const AsepriteFileData& Data) { FileData = Data; }
@@ -147,6 +167,7 @@ namespace ASE
 		void SetPixelType(const PixelType& type) { Type = type; }
 		void SetSize(const AGESize& size) { Size = Size; }
 		void SetBounds(const AGERect& bounds) { Bounds = bounds; }
+		void SetFrame(uint16_t frame) { Frame = frame; }
 
 
 	private:
@@ -158,6 +179,7 @@ namespace ASE
 		AGESize Size = { 0,0 };
 		AGERect Bounds = { 0,0,0,0 };
 		int PixelsPerByte = 0;
+		uint16_t Frame = 0;
 
 	};
 
@@ -165,103 +187,74 @@ namespace ASE
 	{
 	public:
 		Image() = default;
-		Image(ImageSpecification& Spec, bool FlipVerticallyOnLoad = false)
+		//ThreadCount is how many threads the cels get inflated on, 0 uses every hardware thread
+		Image(ImageSpecification& Spec, bool FlipVerticallyOnLoad = false, uint32_t ThreadCount = 0)
 			:m_Spec(Spec), bShouldFlip(FlipVerticallyOnLoad)
 		{
-			size_t ForRows;
-			size_t NumOfPixels;
-			size_t Size;
-
+			//https://github.com/aseprite/aseprite/blob/main/src/doc/image_impl.h
 			switch (Spec.GetPixelType())
 			{
 			case PixelType::RGBA:
 			case PixelType::RGB:
 			{
-				//https://github.com/aseprite/aseprite/blob/main/src/doc/image_impl.h
-
-				m_RowBytes = sizeof(uint32_t) * m_Spec.GetWidth();
-				size_t ForRows = sizeof(uint32_t*) * Spec.GetHeight();
-				size_t Size = ForRows + m_RowBytes * Spec.GetHeight();
-				m_ByteSize = Size;
-
-				ResizeImage(Spec.GetPixelType(), Size);
-
-
-				std::fill(m_Buffer, m_Buffer + (Size), 0);
-
-				m_RGBRows = (uint32_t**)m_Buffer;
-				m_RGBBits = (uint32_t*)(m_Buffer + ForRows);
-
-
-				auto Addr = m_RGBBits;
-				for (int y = 0; y < Spec.GetHeight(); ++y)
-				{
-					m_RGBRows[y] = Addr;
-					Addr = (uint32_t*)(((uint8_t*)Addr) + m_RowBytes);
-				}
+				AllocateRows(m_RGBRows, m_RGBBits);
+				std::fill(m_RGBBits, m_RGBBits + m_ByteSize / sizeof(uint32_t), 0);
 				break;
 			}
 			case PixelType::Greyscale:
 			{
-				//https://github.com/aseprite/aseprite/blob/main/src/doc/image_impl.h
-
-				m_RowBytes = sizeof(uint16_t) * m_Spec.GetWidth();
-				size_t ForRows = sizeof(uint16_t*) * Spec.GetHeight();
-				size_t Size = ForRows + m_RowBytes * Spec.GetHeight();
-				m_ByteSize = Size;
-
-				ResizeImage(Spec.GetPixelType(), Size);
-
-
-				std::fill(m_Buffer, m_Buffer + Size, 0);
-
-				m_GSRows = (uint16_t**)m_Buffer;
-				m_GSBits = (uint16_t*)(m_Buffer + ForRows);
-
-
-				auto Addr = m_GSBits;
-				for (int y = 0; y < Spec.GetHeight(); ++y)
-				{
-					m_GSRows[y] = Addr;
-					Addr = (uint16_t*)(((uint8_t*)Addr) + m_RowBytes);
-				}
+				AllocateRows(m_GSRows, m_GSBits);
+				std::fill(m_GSBits, m_GSBits + m_ByteSize / sizeof(uint16_t), 0);
+				break;
+			}
+			case PixelType::Indexed:
+			{
+				//One byte per pixel plus the palette, only for indexed sprites.
+				//Anything no cel covers is left as the transparent index
+				AllocateRows(m_IndexedRows, m_IndexedBits);
+				std::fill(m_IndexedBits, m_IndexedBits + m_ByteSize, Spec.GetFileData().Header.EntryIndex);
 				break;
 			}
 			default:
 			{
 				CoreLogger::Warn("Unable to make Image from this PixelType");
-				break;
+				return;
 			}
 			}
 
-			for (auto& F : m_Spec.GetFileData().Frames)
+			DecodeCels(ThreadCount);
+			if (bShouldFlip)
 			{
-				for (auto& L : F.Layers)
-				{
-					for (auto& C : L.CelChunks)
-					{
-						for (auto& PD : C.PixelDatas)
-						{
-							InflateChunk(PD.Pixels, C.x, C.y);
-						}
-					}
-				}
+				FlipVertically();
 			}
 		}
-		Image(const Image& Other) = default;
-		Image(const Image&& Other) noexcept
+		//Pixels are only ever owned by one Image, share one as a std::shared_ptr<const Image> rather than copying it
+		Image(const Image&) = delete;
+		Image(Image&& Other) noexcept
 		{
-			m_Spec = Other.m_Spec;
-			m_RowBytes = Other.m_RowBytes;
-			m_ByteSize = Other.m_ByteSize;
-			m_Buffer = Other.m_Buffer;
-			m_RGBImage = Other.m_RGBImage;
-			m_GSImage = Other.m_GSImage;
-			m_RGBRows = Other.m_RGBRows;
-			m_RGBBits = Other.m_RGBBits;
-			m_GSRows = Other.m_GSRows;
-			m_GSBits = Other.m_GSBits;
-		};
+			*this = std::move(Other);
+		}
+		Image& operator=(const Image&) = delete;
+		//The row pointers point into m_Buffer, which doesn't move when the buffer does, so they come along as they are
+		Image& operator=(Image&& Other) noexcept
+		{
+			if (this != &Other)
+			{
+				m_Spec = std::move(Other.m_Spec);
+				m_Buffer = std::move(Other.m_Buffer);
+				m_RowBytes = std::exchange(Other.m_RowBytes, 0);
+				m_ByteSize = std::exchange(Other.m_ByteSize, 0);
+				m_RGBRows = std::exchange(Other.m_RGBRows, nullptr);
+				m_RGBBits = std::exchange(Other.m_RGBBits, nullptr);
+				m_GSRows = std::exchange(Other.m_GSRows, nullptr);
+				m_GSBits = std::exchange(Other.m_GSBits, nullptr);
+				m_IndexedRows = std::exchange(Other.m_IndexedRows, nullptr);
+				m_IndexedBits = std::exchange(Other.m_IndexedBits, nullptr);
+				m_Palette = std::move(Other.m_Palette);
+				bShouldFlip = Other.bShouldFlip;
+			}
+			return *this;
+		}
 
 		virtual ~Image() = default;
 
@@ -280,10 +273,22 @@ namespace ASE
 		}
 		ImageSpecification& GetImageSpec() { return m_Spec; }
 		const ImageSpecification& GetImageSpec() const { return m_Spec; }
-		uint32_t* GetImageBuffer() { return m_RGBImage; }
-		const uint32_t* GetImageBuffer() const { return m_RGBImage; }
-
-		size_t GetImageByteSize()
+		//RGB images only, Width * Height RGBA pixels one row after another, 64 byte aligned
+		uint32_t* GetImageBuffer() { return m_RGBBits; }
+		const uint32_t* GetImageBuffer() const { return m_RGBBits; }
+		//Greyscale images only, value + alpha pixels laid out the same way
+		uint16_t* GetGreyscaleBuffer() { return m_GSBits; }
+		const uint16_t* GetGreyscaleBuffer() const { return m_GSBits; }
+		//Indexed images only, Width * Height palette indices one row after another
+		uint8_t* GetIndexedBuffer() { return m_IndexedBits; }
+		const uint8_t* GetIndexedBuffer() const { return m_IndexedBits; }
+		//Indexed images only, the 256 colours GetIndexedBuffer indexes into. The transparent index is see-through unless the sprite has a background layer
+		const Palette& GetPalette() const { return m_Palette; }
+		//Swapping the palette recolours the image without decoding it again
+		void SetPalette(const Palette& Colors) { m_Palette = Colors; }
+
+		//Bytes of pixels, without the row pointers in front of them
+		size_t GetImageByteSize() const
 		{
 			return m_ByteSize;
 		}
@@ -370,6 +375,11 @@ namespace ASE
 			return m_GSRows[y];
 		}
 
+		uint8_t* GetIndexedLineAddress(int y)
+		{
+			return m_IndexedRows[y];
+		}
+
 
 		uint32_t* GetRGBAddress(int x, int y)
 		{
@@ -381,158 +391,184 @@ namespace ASE
 			return GetGSLineAddress(y) + x;
 		}
 
+		uint8_t* GetIndexedAddress(int x, int y)
+		{
+			return GetIndexedLineAddress(y) + x;
+		}
+
+		//One pooled block holds the row pointers and then the rows, with the pixels starting on a 64 byte boundary
 		template<typename T>
-		T* ReadImage(T* Addr, uint32_t Width, T** Buffer)
+		void AllocateRows(T**& Rows, T*& Bits)
 		{
-			T* Img;
+			size_t Height = m_Spec.GetHeight();
+			size_t ForRows = PixelBufferPool::RoundUp(sizeof(T*) * Height);
+			m_RowBytes = sizeof(T) * m_Spec.GetWidth();
+			m_ByteSize = m_RowBytes * Height;
+			m_Buffer = PixelBuffer(ForRows + m_ByteSize);
 
-			if (bShouldFlip)
+			Rows = (T**)m_Buffer.GetData();
+			Bits = (T*)(m_Buffer.GetData() + ForRows);
+			for (size_t y = 0; y < Height; ++y)
 			{
-				Img = new T[(m_Spec.GetWidth() * m_Spec.GetHeight()) * 2];
-				for (int i = m_Spec.GetHeight() - 1; i >= 0; --i)
-				{
-					const T* Begin = Buffer[i];
-					const T* End = Begin + m_Spec.GetWidth();
-
-					std::copy(Begin, End, Img + m_Spec.GetWidth() * ((m_Spec.GetHeight() - 1) - i));
-
-				}
-
-				return Img;
-
+				Rows[y] = (T*)((uint8_t*)Bits + m_RowBytes * y);
 			}
-			else
-			{
-				Img = new T[(m_Spec.GetWidth() * m_Spec.GetHeight()) * 2];
-
-				for (uint32_t i = 0; i < m_Spec.GetHeight(); ++i)
-				{
-					const T* Begin = Buffer[i];
-					const T* End = Begin + m_Spec.GetWidth();
-
-					std::copy(Begin, End, Img + m_Spec.GetWidth() * i);
-				}
-
-				return Img;
+		}
 
+		//Swaps rows top to bottom in place, so the buffer is ready for APIs that want the bottom row first
+		void FlipVertically()
+		{
+			uint8_t* Bits = m_RGBBits ? (uint8_t*)m_RGBBits : m_GSBits ? (uint8_t*)m_GSBits : m_IndexedBits;
+			uint32_t Height = m_Spec.GetHeight();
+			for (uint32_t y = 0; y < Height / 2; ++y)
+			{
+				std::swap_ranges(Bits + m_RowBytes * y, Bits + m_RowBytes * (y + 1), Bits + m_RowBytes * (Height - 1 - y));
 			}
 		}
 
-		void ResizeImage(PixelType Type, size_t BufferSize)
+		//Cels get inflated into their own buffer in parallel and only compositing them into the image happens on one thread, bottom layer first
+		void DecodeCels(uint32_t ThreadCount)
 		{
-			switch (Type)
-			{
-			case PixelType::RGBA:
-			case PixelType::RGB:
+			AsepriteFileData& File = m_Spec.GetFileData();
+			std::vector<DecodedCel> Cels = CelDecoder::CollectFrameCels(File, m_Spec.GetFrame());
+			size_t BytesPerPixel = File.Header.Depth / 8;
+			CelDecoder::DecodeAll(Cels, BytesPerPixel, ThreadCount);
+			CelDecoder::FindBounds(Cels, BytesPerPixel, File.Header.EntryIndex, ThreadCount);
+
+			if (m_Spec.GetPixelType() == PixelType::Indexed)
 			{
-				m_RGBImage = new uint32_t[(m_Spec.GetWidth() * m_Spec.GetHeight())];
-				break;
+				CompositeIndexed(Cels, BytesPerPixel);
+				return;
 			}
-			case PixelType::Greyscale:
+
+			//Indexed cels get expanded through the palette, every layer but the background sees the transparent index as see-through
+			Palette Colors;
+			Palette LayerColors;
+			if (BytesPerPixel == sizeof(uint8_t))
 			{
-				m_GSImage = new uint16_t[m_Spec.GetWidth() * m_Spec.GetHeight()];
-				break;
+				Colors = Palette::ForFrame(File, m_Spec.GetFrame());
+				LayerColors = Colors.WithTransparentIndex(File.Header.EntryIndex);
 			}
+
+			//Tilemap layers sharing a tileset and palette share one expanded copy of it
+			std::vector<uint32_t> Converted;
+			ExpandedTilesets Tilesets;
+			for (auto& Cel : Cels)
+			{
+				CompositeCel(Cel, BytesPerPixel, Cel.IsBackground ? Colors : LayerColors, Tilesets, Converted);
 			}
-			m_Buffer = new uint8_t[BufferSize];
 		}
 
-		void InflateChunk(std::vector<uint8_t>& Data, int x, int y)
+		//Indices are copied over each other rather than blended, so blend modes and opacity don't apply here
+		void CompositeIndexed(const std::vector<DecodedCel>& Cels, size_t BytesPerPixel)
 		{
-			//https://github.com/aseprite/aseprite/blob/8e91d22b704d6d1e95e1482544318cee9f166c4d/src/doc/image_io.cpp
-
-			MemoryStreamReader Stream(Data.data(), Data.size());
-			int AvailBytes = Data.size();
-
-			z_stream ZStream;
-			ZStream.zalloc = (alloc_func)0;
-			ZStream.zfree = (free_func)0;
-			ZStream.opaque = (voidpf)0;
-
-			int err = inflateInit(&ZStream);
-			if (err != Z_OK)
+			const AsepriteFileData& File = m_Spec.GetFileData();
+			if (BytesPerPixel != sizeof(uint8_t))
 			{
-				CoreLogger::Error("Error in inflateInit()");
+				CoreLogger::Warn("Only indexed sprites can be made into an indexed image, this one is {} bits per pixel", File.Header.Depth);
+				return;
 			}
 
-			int Remain = AvailBytes;
-			std::vector<uint8_t> compressed(4096);
-
-			int Y = 0;
-			uint8_t* Addr = (uint8_t*)GetRGBAddress(0, 0);
-			uint8_t* AddrEnd = (uint8_t*)GetRGBAddress(0, 0) + m_Spec.GetHeight() * m_RowBytes;
-			int uncompressed_offset = 0;
-
-			while (Remain > 0)
+			bool HasBackground = false;
+			std::vector<uint8_t> FlippedTile;
+			for (auto& Cel : Cels)
 			{
-				int Len = std::min(Remain, int(compressed.size()));
-
-
-				uint64_t StartPositon = Stream.GetStreamPosition();
-				Stream.ReadBytes(&compressed[0], Len);
-				if (!Stream.IsStreamGood())
+				HasBackground |= Cel.IsBackground;
+				if ((!Cel.Pixels && !Cel.Tileset) || Cel.Bounds.IsEmpty())
 				{
-					CoreLogger::Error("Error Reading Aseprite Image Data!");
+					continue;
 				}
 
-				size_t bytesRead = Stream.GetStreamPosition() - StartPositon;
-				if (bytesRead == 0)
+				int TransparentIndex = Cel.IsBackground ? -1 : File.Header.EntryIndex;
+				if (Cel.Tileset)
 				{
-					break;
+					TilemapRenderer::ForEachTile(Cel.Source->Tilemap, *Cel.Tileset, Cel.Tileset->Pixels->data(), sizeof(uint8_t), Cel.GetX(), Cel.GetY(), FlippedTile,
+						[&](const uint8_t* Tile, int X, int Y, uint32_t Width, uint32_t Height, size_t Stride)
+						{
+							Compositor::CompositeIndexedCel(m_IndexedBits, m_Spec.GetWidth(), m_Spec.GetHeight(), m_RowBytes, Tile, X, Y, Width, Height, Stride, TransparentIndex);
+						});
+					continue;
 				}
 
-				Remain -= bytesRead;
-
-				ZStream.next_in = (Bytef*)&compressed[0];
-				ZStream.avail_in = (uInt)bytesRead;
+				Compositor::CompositeIndexedCel(m_IndexedBits, m_Spec.GetWidth(), m_Spec.GetHeight(), m_RowBytes, Cel.Pixels->data() + Cel.Offset,
+					Cel.GetX(), Cel.GetY(), Cel.Bounds.Width, Cel.Bounds.Height, Cel.Stride, TransparentIndex);
+			}
 
-				do
-				{
+			m_Palette = Palette::ForFrame(File, m_Spec.GetFrame());
+			if (!HasBackground)
+			{
+				m_Palette = m_Palette.WithTransparentIndex(File.Header.EntryIndex);
+			}
+		}
 
-					//if (Addr == AddrEnd)
-					//{
-					//	if (Y < m_Spec.GetHeight())
-					//	{
-					//		Addr = (uint8_t*)GetRGBAddress(0, Y++);
-					//		AddrEnd = Addr + m_Spec.GetWidthBytes();
-					//	}
-					//}
-					ZStream.next_out = (Bytef*)Addr;
-					ZStream.avail_out = AddrEnd - Addr;
-
-					err = inflate(&ZStream, Z_NO_FLUSH);
-					if (err != Z_OK && err != Z_STREAM_END && err != Z_BUF_ERROR)
-					{
-						CoreLogger::Error("Error in inflate");
-						CoreLogger::Error("\tError:{}", err);
-					}
+		//Blends a decoded cel into the image at its x/y with its layer's blend mode and opacity, anything hanging off the canvas gets clipped
+		//RGB images take cels of any depth, they're expanded to RGBA first. Greyscale images only take greyscale cels.
+		//Tilemap cels are drawn a tile at a time straight out of their tileset, expanded through Tilesets the first time it's drawn with these Colors
+		void CompositeCel(const DecodedCel& Cel, size_t BytesPerPixel, const Palette& Colors, ExpandedTilesets& Tilesets, std::vector<uint32_t>& Converted)
+		{
+			if ((!Cel.Pixels && !Cel.Tileset) || Cel.Bounds.IsEmpty())
+			{
+				return;
+			}
 
+			bool IsRGB = m_Spec.GetPixelType() == PixelType::RGBA || m_Spec.GetPixelType() == PixelType::RGB;
+			bool IsGreyscale = m_Spec.GetPixelType() == PixelType::Greyscale && BytesPerPixel == sizeof(uint16_t);
+			const std::vector<uint8_t>& Pixels = Cel.Tileset ? *Cel.Tileset->Pixels : *Cel.Pixels;
+			const uint32_t* Src = nullptr;
+			if (IsRGB)
+			{
+				Src = Cel.Tileset ? Tilesets.Add(*Cel.Tileset, BytesPerPixel, Colors.GetColors()) : PixelExpander::ToRGBA(Pixels, BytesPerPixel, Colors.GetColors(), Converted);
+			}
+			if ((IsRGB && !Src) || (!IsRGB && !IsGreyscale))
+			{
+				CoreLogger::Warn("Unable to composite a {} byte per pixel cel into this image", BytesPerPixel);
+				return;
+			}
 
-					int uncompressed_bytes = (int)((AddrEnd - Addr) - ZStream.avail_out);
-					if (uncompressed_bytes > 0)
+			const uint8_t* Bytes = IsRGB ? (const uint8_t*)Src : Pixels.data();
+			size_t SrcBytesPerPixel = IsRGB ? sizeof(uint32_t) : sizeof(uint16_t);
+			if (Cel.Tileset)
+			{
+				std::vector<uint8_t> FlippedTile;
+				TilemapRenderer::ForEachTile(Cel.Source->Tilemap, *Cel.Tileset, Bytes, SrcBytesPerPixel, Cel.GetX(), Cel.GetY(), FlippedTile,
+					[&](const uint8_t* Tile, int X, int Y, uint32_t Width, uint32_t Height, size_t Stride)
 					{
-						if (uncompressed_offset + uncompressed_bytes > m_Spec.GetHeight() * m_RowBytes)
-						{
-							throw std::exception("Bad compressed image.");
-						}
-						uncompressed_offset += uncompressed_bytes;
-						Addr += uncompressed_bytes;
-					}
-
-				} while (ZStream.avail_in != 0 && ZStream.avail_out == 0);
+						CompositeRect(Tile, X, Y, Width, Height, Stride, IsRGB, Cel.Mode, Cel.Opacity);
+					});
+				return;
 			}
 
+			CompositeRect(Bytes + Cel.Offset * SrcBytesPerPixel, Cel.GetX(), Cel.GetY(), Cel.Bounds.Width, Cel.Bounds.Height, Cel.Stride, IsRGB, Cel.Mode, Cel.Opacity);
+		}
+
+		//Blends Width x Height pixels at X/Y into the image, RGBA pixels for RGB images and value + alpha ones for greyscale
+		void CompositeRect(const uint8_t* Pixels, int X, int Y, uint32_t Width, uint32_t Height, size_t Stride, bool IsRGB, AsepriteBlendMode Mode, uint8_t Opacity)
+		{
+			if (IsRGB)
+			{
+				Compositor::CompositeCel(m_RGBBits, m_Spec.GetWidth(), m_Spec.GetHeight(), m_RowBytes / sizeof(uint32_t),
+					(const uint32_t*)Pixels, X, Y, Width, Height, Stride, Mode, Opacity);
+				return;
+			}
 
-			err = inflateEnd(&ZStream);
+			//Greyscale is value + alpha, blended as a grey RGBA pixel and the value taken back out of red
+			int X0 = std::max<int>(X, 0);
+			int Y0 = std::max<int>(Y, 0);
+			int X1 = std::min<int>(X + Width, (int)m_Spec.GetWidth());
+			int Y1 = std::min<int>(Y + Height, (int)m_Spec.GetHeight());
+			auto ToRGBA = [](uint16_t P) { uint32_t V = P & 0xFF; return V | (V << 8) | (V << 16) | ((uint32_t)(P >> 8) << 24); };
 
-			if (err != Z_OK)
+			for (int y = Y0; y < Y1; ++y)
 			{
-				CoreLogger::Error("Zlib Error in inflateEnd()");
-				CoreLogger::Error("\t {}", ZStream.msg);
+				const uint16_t* Src = (const uint16_t*)Pixels + (size_t)(y - Y) * Stride;
+				for (int x = X0; x < X1; ++x)
+				{
+					uint16_t* Dst = GetGSAddress(x, y);
+					uint32_t Result = Compositor::BlendPixel(ToRGBA(*Dst), ToRGBA(Src[x - X]), Mode, Opacity);
+					*Dst = (uint16_t)((Result & 0xFF) | ((Result >> 24) << 8));
+				}
 			}
 		}
 
-
 		template<typename T>
 		inline bool IsSameColor(const T A, const T B)
 		{
@@ -591,38 +627,20 @@ namespace ASE
 		size_t m_ByteSize = 0;
 
 
-		uint8_t* m_Buffer;
+		PixelBuffer m_Buffer;
 
-		uint32_t* m_RGBImage;
-		uint16_t* m_GSImage;
+		uint32_t** m_RGBRows = nullptr;
+		uint32_t* m_RGBBits = nullptr;
 
-		uint32_t** m_RGBRows;
-		uint32_t* m_RGBBits;
+		uint16_t** m_GSRows = nullptr;
+		uint16_t* m_GSBits = nullptr;
 
-		uint16_t** m_GSRows;
-		uint16_t* m_GSBits;
+		uint8_t** m_IndexedRows = nullptr;
+		uint8_t* m_IndexedBits = nullptr;
+		Palette m_Palette;
 
 		ImageSpecification m_Spec;
 
 		bool bShouldFlip = false;
-
-
-	public:
-		Image& Image::operator=(const Image& Other)
-		{
-			m_Spec = Other.m_Spec;
-			m_RowBytes = Other.m_RowBytes;
-			m_ByteSize = Other.m_ByteSize;
-			m_Buffer = Other.m_Buffer;
-			m_RGBImage = Other.m_RGBImage;
-			m_GSImage = Other.m_GSImage;
-			m_RGBRows = Other.m_RGBRows;
-			m_RGBBits = Other.m_RGBBits;
-			m_GSRows = Other.m_GSRows;
-			m_GSBits = Other.m_GSBits;
-
-
-			return *this;
-		}
 	};
 }
\ No newline at end of file
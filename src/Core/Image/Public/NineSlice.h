@@ -0,0 +1,178 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "Log/Public/Log.h"
+#include "Structs/Public/DataStructures.h"
+
+namespace ASE
+{
+	//Where one piece of a slice goes on screen and the part of the texture it shows
+	struct SliceQuad
+	{
+		float X, Y, Width, Height;
+		float U0, V0, U1, V1;
+	};
+
+	//Up to 9 quads of a slice drawn at some size, pieces that come out empty (a nine-patch with no border on one side) are left out.
+	//Fixed size so building one never allocates
+	struct NineSliceQuads
+	{
+		SliceQuad Quads[9];
+		uint32_t Count = 0;
+
+		const SliceQuad* begin() const { return Quads; }
+		const SliceQuad* end() const { return Quads + Count; }
+	};
+
+	//Runtime side of slices: which key is active on a frame, and the quads to draw a slice stretched to any size.
+	//Nine-patch slices keep their corners at their size in pixels, the edges stretch one way and the center both.
+	//A slice that isn't a nine-patch is one quad stretched over the whole thing
+	class NineSlice
+	{
+	public:
+		//Null if the file has no slice called Name
+		static const AsepriteSliceChunk* FindSlice(const AsepriteFileData& File, const std::string& Name)
+		{
+			return FindSlice(File.Slices.begin(), File.Slices.end(), Name);
+		}
+		//Same for slices that came from somewhere else, BakedSprite::GetSlices() for instance
+		static const AsepriteSliceChunk* FindSlice(const std::vector<AsepriteSliceChunk>& Slices, const std::string& Name)
+		{
+			return FindSlice(Slices.begin(), Slices.end(), Name);
+		}
+
+		//The key Slice uses on Frame, the last one starting at or before it. Null if the slice doesn't start until after Frame
+		static const AsepriteSliceKey* GetKey(const AsepriteSliceChunk& Slice, uint32_t Frame)
+		{
+			auto It = std::upper_bound(Slice.Slices.begin(), Slice.Slices.end(), Frame, [](uint32_t F, const AsepriteSliceKey& Key)
+				{
+					return F < Key.FrameNumber;
+				});
+			return It == Slice.Slices.begin() ? nullptr : &*(It - 1);
+		}
+
+		//Quads to draw Key at X, Y stretched to Width x Height. UVs are for a TextureWidth x TextureHeight texture with the (untrimmed) frame's top left at FrameX, FrameY,
+		//so a FrameSet layer is the defaults and an atlas page passes where the frame was packed.
+		//Targets smaller than the corners shrink the corners to fit rather than overlapping them
+		static NineSliceQuads Build(const AsepriteSliceChunk& Slice, const AsepriteSliceKey& Key, float X, float Y, float Width, float Height,
+			uint32_t TextureWidth, uint32_t TextureHeight, int32_t FrameX = 0, int32_t FrameY = 0)
+		{
+			NineSliceQuads Out;
+			Edges Cols = GetEdges(Slice.IsNinePatch(), Key.CenterX, Key.CenterWidth, Key.SliceWidth, Width);
+			Edges Rows = GetEdges(Slice.IsNinePatch(), Key.CenterY, Key.CenterHeight, Key.SliceHeight, Height);
+
+			float TexelU = TextureWidth ? 1.0f / TextureWidth : 0.0f;
+			float TexelV = TextureHeight ? 1.0f / TextureHeight : 0.0f;
+			float OriginU = (float)(FrameX + Key.SliceX);
+			float OriginV = (float)(FrameY + Key.SliceY);
+
+			for (uint32_t r = 0; r + 1 < Rows.Count; r++)
+			{
+				for (uint32_t c = 0; c + 1 < Cols.Count; c++)
+				{
+					SliceQuad& Q = Out.Quads[Out.Count];
+					Q.X = X + Cols.Target[c];
+					Q.Y = Y + Rows.Target[r];
+					Q.Width = Cols.Target[c + 1] - Cols.Target[c];
+					Q.Height = Rows.Target[r + 1] - Rows.Target[r];
+					if (Q.Width <= 0.0f || Q.Height <= 0.0f || Cols.Source[c + 1] == Cols.Source[c] || Rows.Source[r + 1] == Rows.Source[r])
+					{
+						continue;
+					}
+
+					Q.U0 = (OriginU + Cols.Source[c]) * TexelU;
+					Q.U1 = (OriginU + Cols.Source[c + 1]) * TexelU;
+					Q.V0 = (OriginV + Rows.Source[r]) * TexelV;
+					Q.V1 = (OriginV + Rows.Source[r + 1]) * TexelV;
+					Out.Count++;
+				}
+			}
+			return Out;
+		}
+
+		//Where Key's pivot ends up, relative to the top left of the slice drawn at Width x Height. It moves with whichever piece it's in,
+		//so a pivot in a corner stays put and one in the center scales with it. False (and 0, 0) if the slice has no pivot
+		static bool GetPivot(const AsepriteSliceChunk& Slice, const AsepriteSliceKey& Key, float Width, float Height, float& PivotX, float& PivotY)
+		{
+			PivotX = 0.0f;
+			PivotY = 0.0f;
+			if (!Slice.HasPivot())
+			{
+				return false;
+			}
+			PivotX = Edges::Map(GetEdges(Slice.IsNinePatch(), Key.CenterX, Key.CenterWidth, Key.SliceWidth, Width), (float)Key.PivotX);
+			PivotY = Edges::Map(GetEdges(Slice.IsNinePatch(), Key.CenterY, Key.CenterHeight, Key.SliceHeight, Height), (float)Key.PivotY);
+			return true;
+		}
+
+	private:
+		template<typename It>
+		static const AsepriteSliceChunk* FindSlice(It Begin, It End, const std::string& Name)
+		{
+			for (; Begin != End; ++Begin)
+			{
+				if (std::string_view(Begin->Name) == Name)
+				{
+					return &*Begin;
+				}
+			}
+			CoreLogger::Warn("There's no slice called {}", Name);
+			return nullptr;
+		}
+
+		//Where the cuts across one axis are in the slice (Source, pixels) and in the target (Target), first to last
+		struct Edges
+		{
+			float Source[4];
+			float Target[4];
+			uint32_t Count;
+
+			//A position in the slice taken to the target by the piece it falls in
+			static float Map(const Edges& E, float Position)
+			{
+				uint32_t i = 0;
+				while (i + 2 < E.Count && Position >= E.Source[i + 1])
+				{
+					i++;
+				}
+				float Span = E.Source[i + 1] - E.Source[i];
+				float Scale = Span > 0.0f ? (E.Target[i + 1] - E.Target[i]) / Span : 0.0f;
+				return E.Target[i] + (Position - E.Source[i]) * Scale;
+			}
+		};
+
+		static Edges GetEdges(bool NinePatch, int32_t Center, uint32_t CenterSize, uint32_t Size, float TargetSize)
+		{
+			Edges E;
+			if (!NinePatch)
+			{
+				E.Source[0] = 0.0f;
+				E.Source[1] = (float)Size;
+				E.Target[0] = 0.0f;
+				E.Target[1] = TargetSize;
+				E.Count = 2;
+				return E;
+			}
+
+			//Broken keys can put the center outside the slice
+			float Start = (float)std::clamp<int64_t>(Center, 0, Size);
+			float End = (float)std::clamp<int64_t>((int64_t)Center + CenterSize, (int64_t)Start, Size);
+			float Border = Start + (float)Size - End;
+			float Shrink = Border > TargetSize && Border > 0.0f ? TargetSize / Border : 1.0f;
+
+			E.Source[0] = 0.0f;
+			E.Source[1] = Start;
+			E.Source[2] = End;
+			E.Source[3] = (float)Size;
+			E.Target[0] = 0.0f;
+			E.Target[1] = Start * Shrink;
+			E.Target[2] = TargetSize - ((float)Size - End) * Shrink;
+			E.Target[3] = TargetSize;
+			E.Count = 4;
+			return E;
+		}
+	};
+}
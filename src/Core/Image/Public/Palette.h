@@ -0,0 +1,122 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "Structs/Public/DataStructures.h"
+
+namespace ASE
+{
+	//The 256 colour lookup table indexed cels go through, stored as RGBA the same way the Compositor wants it.
+	//Aseprite lets palette chunks in later frames change the palette from that frame on, so it's always the palette as of some frame
+	class Palette
+	{
+	public:
+		Palette() { m_Colors.fill(0); }
+		//Size entries of Colors, anything past them is transparent black
+		Palette(const uint32_t* Colors, size_t Size)
+			:m_Size(std::min<size_t>(Size, 256))
+		{
+			m_Colors.fill(0);
+			std::copy(Colors, Colors + m_Size, m_Colors.begin());
+		}
+		Palette(const Palette&) = default;
+		Palette& operator=(const Palette&) = default;
+
+		//Palette as it is at Frame, with every palette chunk up to and including that frame applied
+		static Palette ForFrame(const AsepriteFileData& File, uint16_t Frame)
+		{
+			Palette P;
+			bool UseOldChunks = !HasNewPalette(File);
+			for (size_t f = 0; f <= Frame && f < File.Frames.size(); f++)
+			{
+				P.Apply(File.Frames[f], UseOldChunks);
+			}
+			return P;
+		}
+
+		//Old palette chunks are only meant to be read when the file has no new ones
+		static bool HasNewPalette(const AsepriteFileData& File)
+		{
+			for (auto& F : File.Frames)
+			{
+				if (!F.NewPaletteChunks.empty())
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		//Palette of every frame. Frames with no palette chunks of their own point at the same Palette as the frame before them,
+		//so a file that sets its palette once only ever has the one
+		static std::vector<std::shared_ptr<const Palette>> ForAllFrames(const AsepriteFileData& File)
+		{
+			std::vector<std::shared_ptr<const Palette>> Palettes;
+			Palettes.reserve(File.Frames.size());
+
+			bool UseOldChunks = !HasNewPalette(File);
+			auto Current = std::make_shared<const Palette>();
+			for (auto& F : File.Frames)
+			{
+				if (!F.NewPaletteChunks.empty() || (UseOldChunks && !F.OldPaletteChunks.empty()))
+				{
+					auto Changed = std::make_shared<Palette>(*Current);
+					Changed->Apply(F, UseOldChunks);
+					Current = Changed;
+				}
+				Palettes.push_back(Current);
+			}
+			return Palettes;
+		}
+
+		//Applies a frame's palette chunks on top of what's already there
+		void Apply(const AsepriteFrameData& F, bool UseOldChunks)
+		{
+			for (auto& Chunk : F.NewPaletteChunks)
+			{
+				size_t Count = std::min(Chunk.Colors.size(), m_Colors.size() - std::min<size_t>(Chunk.FirstIndexToChange, m_Colors.size()));
+				std::copy(Chunk.Colors.begin(), Chunk.Colors.begin() + Count, m_Colors.begin() + std::min<size_t>(Chunk.FirstIndexToChange, m_Colors.size()));
+				m_Size = std::max<size_t>(m_Size, std::min<size_t>(Chunk.Size, m_Colors.size()));
+			}
+
+			if (!UseOldChunks)
+			{
+				return;
+			}
+
+			for (auto& Chunk : F.OldPaletteChunks)
+			{
+				size_t Index = 0;
+				for (auto& Packet : Chunk.Packets)
+				{
+					Index = std::min(Index + Packet.NumOfEntriesToSkip, m_Colors.size());
+					size_t Count = std::min(Packet.Colors.size(), m_Colors.size() - Index);
+					std::copy(Packet.Colors.begin(), Packet.Colors.begin() + Count, m_Colors.begin() + Index);
+					Index += Count;
+					m_Size = std::max(m_Size, Index);
+				}
+			}
+		}
+
+		//Same palette with Index see-through, that's what every layer but the background draws its transparent colour as
+		Palette WithTransparentIndex(uint8_t Index) const
+		{
+			Palette P = *this;
+			P.m_Colors[Index] = 0;
+			return P;
+		}
+
+		//256 packed RGBA entries, ready to go into a palette texture
+		const uint32_t* GetColors() const { return m_Colors.data(); }
+		uint32_t GetColor(uint8_t Index) const { return m_Colors[Index]; }
+		void SetColor(uint8_t Index, uint32_t RGBA) { m_Colors[Index] = RGBA; }
+		//How many entries the file's palette actually uses, the rest of the 256 are transparent black
+		size_t GetSize() const { return m_Size; }
+
+	private:
+		std::array<uint32_t, 256> m_Colors;
+		size_t m_Size = 0;
+	};
+}
@@ -5,12 +5,44 @@
 #include <unordered_map>
 #include <memory>
 #include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <memory_resource>
 #include "Log/Public/Log.h"
 #include "Structs/Public/DataStructures.h"
+#include "Serializer/Public/MappedFileReader.h"
+#include "Utils/Public/ParallelFor.h"
+#include "Utils/Public/Handle.h"
+#include "Utils/Public/StringTable.h"
 #include "Image.h"
+#include "FrameSet.h"
+#include "SpriteCache.h"
 
 namespace ASE
 {
+	enum class AsepriteParseMode : uint8_t
+	{
+		Stream = 0, // Copies every chunk body out of an std::ifstream
+		Mapped = 1, // Maps the file and chunks point straight into it, no per-chunk allocations
+		Lazy = 2,   // Maps the file and only indexes the frames, cels aren't read until AsepriteParser::LoadFrame asks for them
+		Arena = 3   // Like Mapped, but everything the file is parsed into is allocated from one arena the file data owns, so unloading it frees a few blocks instead of every container
+	};
+
+	//Handles to what's been loaded into an AsepriteParser. They stay valid until the sprite is unloaded (or loaded again from the same path),
+	//after that they just don't find anything. Layers, tags and slices go stale along with their sprite
+	using SpriteId = Handle<struct SpriteHandleTag>;
+	using LayerId = ChildHandle<struct LayerHandleTag, SpriteId>;
+	using TagId = ChildHandle<struct TagHandleTag, SpriteId>;
+	using SliceId = ChildHandle<struct SliceHandleTag, SpriteId>;
+
+	struct AsepriteLoadResult
+	{
+		std::filesystem::path Path;
+		std::string Name; // Name the sprite can be found by in the parser
+		SpriteId Id; // Invalid if it failed to load
+		bool Success = false;
+		double Milliseconds = 0.0; // Time spent parsing this file
+	};
 
 	namespace Utils
 	{
@@ -48,73 +80,532 @@ namespace ASE
 		AsepriteParser(const AsepriteParser&) = default; // Despite not wanting a bunch of objects floating around we might still need to copy the data from place to place idk yet though.
 		AsepriteParser(const AsepriteParser&&) = delete;
 
-		void ReadData(const std::filesystem::path& Filepath)
+		//Returns an invalid SpriteId if the file couldn't be read
+		SpriteId ReadData(const std::filesystem::path& Filepath, AsepriteParseMode Mode = AsepriteParseMode::Stream)
 		{
-			std::string Name = GetFileName(Filepath);
-			AsepriteHeader Header;
 			AsepriteFileData FileData;
+			if (ParseFile(Filepath, Mode, FileData))
+			{
+				return AddSprite(Filepath, std::move(FileData));
+			}
+			return SpriteId();
+		}
 
-			FileStreamReader Stream(Filepath);
-			uint32_t NotNeeded;
-			uint8_t IgnoreThese;
-			uint8_t ForFutureUse;
-			if (Stream)
-			{
-				Stream.ReadRaw<uint32_t>(Header.FileSize);
-				Stream.ReadRaw<uint16_t>(Header.MagicNumber);
-				Stream.ReadRaw<uint16_t>(Header.Frames);
-				Stream.ReadRaw<uint16_t>(Header.Width);
-				Stream.ReadRaw<uint16_t>(Header.Height);
-				Stream.ReadRaw<uint16_t>(Header.Depth);
-				Stream.ReadRaw<uint32_t>(Header.Flags);
-				Stream.ReadRaw<uint16_t>(Header.Speed);
-				Stream.ReadRaw<uint32_t>(NotNeeded);
-				Stream.ReadRaw<uint32_t>(NotNeeded);
-				Stream.ReadRaw<uint8_t>(Header.EntryIndex);
-				Stream.ReadRaw<uint8_t>(IgnoreThese);
-				Stream.ReadRaw<uint8_t>(IgnoreThese);
-				Stream.ReadRaw<uint8_t>(IgnoreThese);
-				Stream.ReadRaw<uint16_t>(Header.NumOfColors);
-				Stream.ReadRaw<uint8_t>(Header.PixelWidth);
-				Stream.ReadRaw<uint8_t>(Header.PixelHeight);
-				Stream.ReadRaw<int16_t>(Header.x);
-				Stream.ReadRaw<int16_t>(Header.y);
-				Stream.ReadRaw<uint16_t>(Header.GridWidth);
-				Stream.ReadRaw<uint16_t>(Header.GridHeight);
-				for (int i = 0; i < 84; i++)
+		//Parses every file on a pool of ThreadCount workers (0 uses every hardware thread).
+		//Workers only ever write their own slot of a results vector, the sprites are added on the calling thread once they've all finished.
+		//The results come back in the same order as Paths
+		std::vector<AsepriteLoadResult> LoadAll(const std::vector<std::filesystem::path>& Paths, uint32_t ThreadCount = 0, AsepriteParseMode Mode = AsepriteParseMode::Mapped)
+		{
+			std::vector<AsepriteLoadResult> Results(Paths.size());
+			std::vector<AsepriteFileData> Parsed(Paths.size());
+
+			Utils::ParallelFor(Paths.size(), ThreadCount, [&](size_t i)
+				{
+					auto Start = std::chrono::steady_clock::now();
+
+					Results[i].Path = Paths[i];
+					Results[i].Name = GetFileName(Paths[i]);
+					Results[i].Success = ParseFile(Paths[i], Mode, Parsed[i]);
+					Results[i].Milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+				});
+
+			for (size_t i = 0; i < Paths.size(); i++)
+			{
+				if (Results[i].Success)
+				{
+					Results[i].Id = AddSprite(Paths[i], std::move(Parsed[i]));
+				}
+			}
+
+			return Results;
+		}
+
+		//Collects every .aseprite/.ase file in Directory and hands them to LoadAll
+		std::vector<AsepriteLoadResult> LoadDirectory(const std::filesystem::path& Directory, bool Recursive = false, uint32_t ThreadCount = 0, AsepriteParseMode Mode = AsepriteParseMode::Mapped)
+		{
+			std::vector<std::filesystem::path> Paths;
+			std::error_code Error;
+
+			auto Collect = [&Paths](const std::filesystem::directory_entry& Entry)
 				{
-					Stream.ReadRaw<uint8_t>(ForFutureUse);
+					if (!Entry.is_regular_file())
+					{
+						return;
+					}
+					std::string Extension = Entry.path().extension().string();
+					if (Extension == ".aseprite" || Extension == ".ase")
+					{
+						Paths.push_back(Entry.path());
+					}
+				};
+
+			if (Recursive)
+			{
+				for (const auto& Entry : std::filesystem::recursive_directory_iterator(Directory, Error))
+				{
+					Collect(Entry);
+				}
+			}
+			else
+			{
+				for (const auto& Entry : std::filesystem::directory_iterator(Directory, Error))
+				{
+					Collect(Entry);
+				}
+			}
+
+			if (Error)
+			{
+				CoreLogger::Error("Unable to read directory {}: {}", Directory.string(), Error.message());
+			}
+
+			return LoadAll(Paths, ThreadCount, Mode);
+		}
+
+		//Reads only the 128 byte header with one unbuffered read, for asset browsers and manifests that just need the size, depth and frame count.
+		//Returns false if the file can't be read or isn't an Aseprite file. Doesn't touch the parser so it's fine to call from any thread
+		static bool ProbeHeader(const std::filesystem::path& Filepath, AsepriteHeader& Header)
+		{
+			constexpr size_t HeaderSize = 128;
+			uint8_t Bytes[HeaderSize];
+
+			std::ifstream File;
+			File.rdbuf()->pubsetbuf(nullptr, 0);
+			File.open(Filepath, std::ifstream::in | std::ifstream::binary);
+			if (!File || !File.read((char*)Bytes, HeaderSize))
+			{
+				return false;
+			}
+
+			MemorySpanReader Stream(Bytes, HeaderSize);
+			ReadHeader(&Stream, Header);
+			return Header.MagicNumber == 0xA5E0;
+		}
+
+		//Reads the cels of a frame that was parsed with AsepriteParseMode::Lazy, along with any frames its linked cels point at.
+		//Frames that are already loaded are left alone. Not thread safe, don't load frames of the same sprite from two threads
+		bool LoadFrame(const std::string& SpriteName, uint16_t Frame)
+		{
+			AsepriteFileData* File = GetFileData(SpriteName);
+			if (!File)
+			{
+				CoreLogger::Error("No sprite named {} has been loaded", SpriteName);
+				return false;
+			}
+			return LoadFrame(*File, Frame);
+		}
+
+		bool LoadFrame(AsepriteFileData& File, uint16_t Frame)
+		{
+			if (Frame >= File.Frames.size())
+			{
+				CoreLogger::Error("Frame {} is out of range, the file only has {} frames", Frame, File.Frames.size());
+				return false;
+			}
+
+			AsepriteFrameData& F = File.Frames[Frame];
+			if (F.CelsLoaded)
+			{
+				return true;
+			}
+			F.CelsLoaded = true;
+
+			for (auto& Chunk : F.ChunkData)
+			{
+				if (Chunk.Type == AsepriteChunkType::CelChunk)
+				{
+					DispatchChunk(File, F, Chunk);
+				}
+			}
+			SortFrameCels(F);
+
+			bool Loaded = true;
+			for (auto& L : F.Layers)
+			{
+				for (auto& C : L.CelChunks)
+				{
+					if (C.CelType == 1 && C.FramePosition < File.Frames.size())
+					{
+						Loaded &= LoadFrame(File, C.FramePosition);
+					}
 				}
-				FileData.Header = Header;
-				FileData.Frames.resize(Header.Frames);
-				m_AsepriteData[Name] = FileData;
-				m_AsepriteData[Name].Frames.resize(Header.Frames);
-				ReadFrameData(Name, &Stream, Header.Frames);
+			}
+			return Loaded;
+		}
 
+		//Loads every frame that hasn't been yet, for when the whole animation is needed after all
+		bool LoadAllFrames(AsepriteFileData& File)
+		{
+			bool Loaded = true;
+			for (uint16_t f = 0; f < File.Frames.size(); f++)
+			{
+				Loaded &= LoadFrame(File, f);
+			}
+			return Loaded;
+		}
 
+		//Header, layers, palettes and the frame index of a loaded sprite. Null if nothing called SpriteName has been loaded
+		AsepriteFileData* GetFileData(const std::string& SpriteName)
+		{
+			return GetFileData(FindSprite(SpriteName));
+		}
 
+		//Constant time, null if Sprite is stale. Loading another sprite can move the ones already loaded, so keep the SpriteId rather than this pointer
+		AsepriteFileData* GetFileData(SpriteId Sprite)
+		{
+			LoadedSprite* Entry = m_Sprites.Get(Sprite);
+			return Entry ? &Entry->Data : nullptr;
+		}
+		const AsepriteFileData* GetFileData(SpriteId Sprite) const
+		{
+			const LoadedSprite* Entry = m_Sprites.Get(Sprite);
+			return Entry ? &Entry->Data : nullptr;
+		}
+
+		//Composites every frame of an already loaded sprite, see FrameSet. Lazy sprites get all their frames loaded first.
+		//Empty if nothing called SpriteName has been loaded
+		FrameSet BuildFrameSet(const std::string& SpriteName, uint32_t ThreadCount = 0, bool Deduplicate = false)
+		{
+			SpriteId Sprite = FindSprite(SpriteName);
+			if (!Sprite)
+			{
+				CoreLogger::Error("No sprite named {} has been loaded", SpriteName);
+				return FrameSet();
+			}
+			return BuildFrameSet(Sprite, ThreadCount, Deduplicate);
+		}
+
+		FrameSet BuildFrameSet(SpriteId Sprite, uint32_t ThreadCount = 0, bool Deduplicate = false)
+		{
+			AsepriteFileData* File = GetFileData(Sprite);
+			if (!File)
+			{
+				CoreLogger::Error("Sprite {} has been unloaded", Sprite.Index);
+				return FrameSet();
 			}
+			LoadAllFrames(*File);
+			return FrameSet(*File, ThreadCount, Deduplicate);
+		}
+
+		//The sprite loaded from a file called SpriteName (no folder or extension). If several files share that name it's the one loaded last,
+		//the rest are still there under their own SpriteId. This hashes the name, look it up once and keep the SpriteId
+		SpriteId FindSprite(const std::string& SpriteName) const
+		{
+			auto It = m_SpritesByName.find(m_Names.Find(SpriteName));
+			return It == m_SpritesByName.end() ? SpriteId() : It->second;
+		}
+
+		//The sprite loaded from exactly this file, whatever else shares its name
+		SpriteId FindSpriteByPath(const std::filesystem::path& Filepath) const
+		{
+			auto It = m_SpritesByPath.find(GetPathKey(Filepath));
+			return It == m_SpritesByPath.end() ? SpriteId() : It->second;
+		}
+
+		const std::string& GetSpriteName(SpriteId Sprite) const
+		{
+			const LoadedSprite* Entry = m_Sprites.Get(Sprite);
+			return m_Names.Get(Entry ? Entry->Name : 0);
+		}
+
+		size_t GetSpriteCount() const { return m_Sprites.GetSize(); }
+
+		//Frees the sprite, every handle to it or its layers, tags and slices stops finding anything. False if it was already gone
+		bool Unload(SpriteId Sprite)
+		{
+			const LoadedSprite* Entry = m_Sprites.Get(Sprite);
+			if (!Entry)
+			{
+				return false;
+			}
+
+			m_SpritesByPath.erase(Entry->PathKey);
+			auto It = m_SpritesByName.find(Entry->Name);
+			if (It != m_SpritesByName.end() && It->second == Sprite)
+			{
+				m_SpritesByName.erase(It);
+			}
+			return m_Sprites.Remove(Sprite);
+		}
+
+		//Layers, tags and slices are found by name once, after that their handles get straight to them.
+		//The NameId versions only compare integers, the string versions hash Name once to get its NameId
+		LayerId FindLayer(SpriteId Sprite, NameId Name) const
+		{
+			const AsepriteFileData* File = GetFileData(Sprite);
+			if (!File || File->Frames.empty())
+			{
+				return LayerId();
+			}
+			return { Sprite, FindByName(File->Frames[0].Layers, Name) };
+		}
+		LayerId FindLayer(SpriteId Sprite, std::string_view Name) const { return FindLayer(Sprite, m_Names.Find(Name)); }
+
+		TagId FindTag(SpriteId Sprite, NameId Name) const
+		{
+			const AsepriteFileData* File = GetFileData(Sprite);
+			return File ? TagId{ Sprite, FindByName(File->Tags, Name) } : TagId();
+		}
+		TagId FindTag(SpriteId Sprite, std::string_view Name) const { return FindTag(Sprite, m_Names.Find(Name)); }
+
+		SliceId FindSlice(SpriteId Sprite, NameId Name) const
+		{
+			const AsepriteFileData* File = GetFileData(Sprite);
+			return File ? SliceId{ Sprite, FindByName(File->Slices, Name) } : SliceId();
+		}
+		SliceId FindSlice(SpriteId Sprite, std::string_view Name) const { return FindSlice(Sprite, m_Names.Find(Name)); }
+
+		//Null if the handle is stale. Layers are as declared in the first frame
+		const AsepriteLayer* GetLayer(LayerId Layer) const
+		{
+			const AsepriteFileData* File = GetFileData(Layer.Parent);
+			return File && !File->Frames.empty() && Layer.Index < File->Frames[0].Layers.size() ? &File->Frames[0].Layers[Layer.Index] : nullptr;
+		}
+		const AsepriteTag* GetTag(TagId Tag) const
+		{
+			const AsepriteFileData* File = GetFileData(Tag.Parent);
+			return File && Tag.Index < File->Tags.size() ? &File->Tags[Tag.Index] : nullptr;
+		}
+		const AsepriteSliceChunk* GetSlice(SliceId Slice) const
+		{
+			const AsepriteFileData* File = GetFileData(Slice.Parent);
+			return File && Slice.Index < File->Slices.size() ? &File->Slices[Slice.Index] : nullptr;
+		}
+
+		//Every sprite, layer, tag and slice name the parser has seen, NameKey on layers, tags and slices indexes into it
+		const StringTable& GetNames() const { return m_Names; }
+		NameId FindName(std::string_view Name) const { return m_Names.Find(Name); }
+		const std::string& GetName(NameId Name) const { return m_Names.Get(Name); }
+
+		//Finished frames of Filepath through the sprite cache in CacheDirectory, for callers that only need the frames and not the layers or chunks.
+		//If there's an up to date cache it's mapped and that's it. Otherwise the file is parsed and composited, and the cache is (re)written for next time.
+		//Nothing is added to the parser either way
+		BakedSprite LoadCached(const std::filesystem::path& Filepath, const std::filesystem::path& CacheDirectory, uint32_t ThreadCount = 0)
+		{
+			std::filesystem::path CachePath = SpriteCache::GetCachePath(CacheDirectory, Filepath);
+			BakedSprite Sprite = SpriteCache::Load(Filepath, CachePath);
+			if (Sprite)
+			{
+				return Sprite;
+			}
+
+			AsepriteFileData File;
+			if (!ParseFile(Filepath, AsepriteParseMode::Mapped, File))
+			{
+				return BakedSprite();
+			}
+			auto Frames = std::make_shared<const FrameSet>(File, ThreadCount);
+			Palette P = Palette::ForFrame(File, 0);
+
+			if (SpriteCache::Bake(*Frames, P, File, Filepath, CachePath))
+			{
+				Sprite = SpriteCache::Load(Filepath, CachePath);
+				if (Sprite)
+				{
+					return Sprite;
+				}
+			}
+			return BakedSprite(Frames, P, File);
 		}
 
-	
 
 	protected:
-		std::vector<AsepriteFrameData>& GetSpriteFrameData(const std::string& SpriteName)
+		//Null if no sprite called SpriteName is loaded
+		std::pmr::vector<AsepriteFrameData>* GetSpriteFrameData(const std::string& SpriteName)
 		{
-			return m_AsepriteData[SpriteName].Frames;
+			AsepriteFileData* File = GetFileData(SpriteName);
+			if (!File)
+			{
+				CoreLogger::Error("No sprite named {} has been loaded", SpriteName);
+				return nullptr;
+			}
+			return &File->Frames;
 		}
 
 
 	private:
-		void ReadFrameData(const std::string& Filename, FileStreamReader* Stream, size_t Size)
+		struct LoadedSprite
+		{
+			AsepriteFileData Data;
+			NameId Name = 0;
+			std::string PathKey;
+		};
+
+		//Files loaded from the same path replace what was loaded from it before. Files that only share a name are both kept,
+		//the name finds the newest and the older one is still reachable by its SpriteId
+		SpriteId AddSprite(const std::filesystem::path& Filepath, AsepriteFileData&& Data)
+		{
+			std::string PathKey = GetPathKey(Filepath);
+			auto Existing = m_SpritesByPath.find(PathKey);
+			if (Existing != m_SpritesByPath.end())
+			{
+				Unload(Existing->second);
+			}
+
+			NameId Name = m_Names.Intern(GetFileName(Filepath));
+			if (m_SpritesByName.count(Name))
+			{
+				CoreLogger::Warn("{} has the same name as an already loaded sprite, {} now finds this one. Use their SpriteIds to tell them apart", Filepath.string(), m_Names.Get(Name));
+			}
+
+			InternNames(Data);
+			SpriteId Sprite = m_Sprites.Insert({ std::move(Data), Name, PathKey });
+			m_SpritesByName[Name] = Sprite;
+			m_SpritesByPath[PathKey] = Sprite;
+			return Sprite;
+		}
+
+		//Gives every layer, tag and slice the NameKey of its name. Every frame has the same layers as the first
+		void InternNames(AsepriteFileData& Data)
+		{
+			for (size_t f = 0; f < Data.Frames.size(); f++)
+			{
+				auto& Layers = Data.Frames[f].Layers;
+				for (size_t l = 0; l < Layers.size(); l++)
+				{
+					bool SameAsFirst = f > 0 && l < Data.Frames[0].Layers.size() && Layers[l].Name == Data.Frames[0].Layers[l].Name;
+					Layers[l].NameKey = SameAsFirst ? Data.Frames[0].Layers[l].NameKey : m_Names.Intern(Layers[l].Name);
+				}
+			}
+			for (auto& Tag : Data.Tags)
+			{
+				Tag.NameKey = m_Names.Intern(Tag.Name);
+			}
+			for (auto& Slice : Data.Slices)
+			{
+				Slice.NameKey = m_Names.Intern(Slice.Name);
+			}
+		}
+
+		template<typename T>
+		static uint32_t FindByName(const std::pmr::vector<T>& Items, NameId Name)
+		{
+			for (uint32_t i = 0; Name != 0 && i < Items.size(); i++)
+			{
+				if (Items[i].NameKey == Name)
+				{
+					return i;
+				}
+			}
+			return SpriteId::InvalidIndex;
+		}
+
+		//Same file however the path was written, so loading it again replaces it instead of adding a copy
+		static std::string GetPathKey(const std::filesystem::path& Filepath)
+		{
+			std::error_code Error;
+			std::filesystem::path Full = std::filesystem::absolute(Filepath, Error);
+			return (Error ? Filepath : Full).lexically_normal().generic_string();
+		}
+
+		//Doesn't touch any parser state so it's safe to call from several threads at once
+		bool ParseFile(const std::filesystem::path& Filepath, AsepriteParseMode Mode, AsepriteFileData& FileData)
+		{
+			std::string Name = GetFileName(Filepath);
+
+			if (Mode != AsepriteParseMode::Stream)
+			{
+				MappedFileReader Stream(Filepath);
+				if (!Stream)
+				{
+					return false;
+				}
+
+				//Names, layers, cels and palettes take up a small part of the file since cel pixels stay in the mapping,
+				//so a block of an eighth of the file is usually all the arena ever needs
+				if (Mode == AsepriteParseMode::Arena)
+				{
+					size_t BlockSize = std::max<size_t>((size_t)(Stream.GetFile()->GetSize() / 8), 4096);
+					FileData = AsepriteFileData(std::make_shared<std::pmr::monotonic_buffer_resource>(BlockSize));
+				}
+
+				ReadHeader(&Stream, FileData.Header);
+				if (!IsAsepriteHeader(FileData.Header, Name))
+				{
+					return false;
+				}
+				FileData.Mapping = Stream.GetFile();
+				ReadFrameData(FileData, Name, &Stream, &Stream, Mode == AsepriteParseMode::Lazy);
+				ReorderLayers(FileData);
+				return true;
+			}
+
+			FileStreamReader Stream(Filepath);
+			if (!Stream)
+			{
+				return false;
+			}
+
+			ReadHeader(&Stream, FileData.Header);
+			if (!IsAsepriteHeader(FileData.Header, Name))
+			{
+				return false;
+			}
+			ReadFrameData(FileData, Name, &Stream);
+			ReorderLayers(FileData);
+			return true;
+		}
+
+		bool IsAsepriteHeader(const AsepriteHeader& Header, const std::string& Filename)
+		{
+			if (Header.MagicNumber != 0xA5E0)
+			{
+				CoreLogger::Error("{} isn't an Aseprite file, its magic number is {:#x}", Filename, Header.MagicNumber);
+				return false;
+			}
+			return true;
+		}
+		static void ReadHeader(DataReader* Stream, AsepriteHeader& Header)
+		{
+			uint32_t NotNeeded;
+			uint8_t IgnoreThese;
+			uint8_t ForFutureUse;
+
+			Stream->ReadRaw<uint32_t>(Header.FileSize);
+			Stream->ReadRaw<uint16_t>(Header.MagicNumber);
+			Stream->ReadRaw<uint16_t>(Header.Frames);
+			Stream->ReadRaw<uint16_t>(Header.Width);
+			Stream->ReadRaw<uint16_t>(Header.Height);
+			Stream->ReadRaw<uint16_t>(Header.Depth);
+			Stream->ReadRaw<uint32_t>(Header.Flags);
+			Stream->ReadRaw<uint16_t>(Header.Speed);
+			Stream->ReadRaw<uint32_t>(NotNeeded);
+			Stream->ReadRaw<uint32_t>(NotNeeded);
+			Stream->ReadRaw<uint8_t>(Header.EntryIndex);
+			Stream->ReadRaw<uint8_t>(IgnoreThese);
+			Stream->ReadRaw<uint8_t>(IgnoreThese);
+			Stream->ReadRaw<uint8_t>(IgnoreThese);
+			Stream->ReadRaw<uint16_t>(Header.NumOfColors);
+			Stream->ReadRaw<uint8_t>(Header.PixelWidth);
+			Stream->ReadRaw<uint8_t>(Header.PixelHeight);
+			Stream->ReadRaw<int16_t>(Header.x);
+			Stream->ReadRaw<int16_t>(Header.y);
+			Stream->ReadRaw<uint16_t>(Header.GridWidth);
+			Stream->ReadRaw<uint16_t>(Header.GridHeight);
+			for (int i = 0; i < 84; i++)
+			{
+				Stream->ReadRaw<uint8_t>(ForFutureUse);
+			}
+		}
+
+		//When Mapping is set the chunk bodies are left in the mapping and AsepriteChunk::View points at them,
+		//otherwise every body gets copied into AsepriteChunk::Data. Each chunk is decoded as soon as it has been read,
+		//except cels when Lazy is set, those are only indexed and left for LoadFrame
+		void ReadFrameData(AsepriteFileData& File, const std::string& Filename, DataReader* Stream, MappedFileReader* Mapping = nullptr, bool Lazy = false)
 		{
-			AsepriteFrameData Data;
-			AsepriteChunk Chunk;
 			uint8_t NotNeeded[2];
-			uint16_t Type;
 
-			for (int i = 0; i < Size; i++)
+			File.Frames.reserve(File.Header.Frames);
+			for (uint16_t i = 0; i < File.Header.Frames; i++)
+			{
+				File.Frames.emplace_back(File.GetResource());
+			}
+
+			for (size_t i = 0; i < File.Frames.size(); i++)
 			{
+				AsepriteFrameData& Data = File.Frames[i];
+				Data.Offset = Stream->GetStreamPosition();
+
 				//Read Frame header data
 				Stream->ReadRaw<uint32_t>(Data.BytesInFrame);
 				Stream->ReadRaw<uint16_t>(Data.MagicNumber);
@@ -124,659 +615,754 @@ namespace ASE
 				Stream->ReadRaw<uint8_t>(NotNeeded[1]);
 				Stream->ReadRaw<uint32_t>(Data.NewNumOfChunks);
 
-				//Read each chunk
+				//Layers are only declared in the first frame but the cels of every frame index into them
+				if (i > 0)
+				{
+					CopyLayerLayout(File.Frames[0], Data);
+				}
 
-				if (Data.NewNumOfChunks == 0)
+				//Read each chunk
+				uint32_t NumOfChunks = Data.NewNumOfChunks == 0 ? Data.NumOfChunks : Data.NewNumOfChunks;
+				Data.ChunkData.reserve(NumOfChunks);
+				for (uint32_t x = 0; x < NumOfChunks; x++)
 				{
-					Data.ChunkData.resize(Data.NumOfChunks);
-					for (int x = 0; x < Data.NumOfChunks; x++)
+					AsepriteChunk& Chunk = Data.ChunkData.emplace_back(File.GetResource());
+					Stream->ReadRaw<uint32_t>(Chunk.Size);
+					Stream->ReadRaw<AsepriteChunkType>(Chunk.Type);
+					Chunk.Offset = Stream->GetStreamPosition();
+
+					if (Mapping)
+					{
+						Chunk.View = Mapping->ReadView(Chunk.GetDataSize());
+					}
+					else
 					{
-						Stream->ReadRaw<uint32_t>(Chunk.Size);
-						Stream->ReadRaw<AsepriteChunkType>(Chunk.Type);
-						Chunk.Data.resize(Chunk.Size - 6);
-						Stream->ReadBytes(Chunk.Data, Chunk.Size - 6);
-						Data.ChunkData[x] = Chunk;
+						Chunk.Data.resize(Chunk.GetDataSize());
+						Stream->ReadBytes((uint8_t*)Chunk.Data.data(), Chunk.GetDataSize());
 					}
 
-				}
-				else
-				{
-					Data.ChunkData.resize(Data.NewNumOfChunks);
-					for (int x = 0; x < Data.NewNumOfChunks; x++)
+					if (!Stream->IsStreamGood())
+					{
+						CoreLogger::Error("Unexpected end of file while reading chunks of frame {} in {}", i, Filename);
+						Data.ChunkData.pop_back();
+						return;
+					}
+
+					if (Lazy && Chunk.Type == AsepriteChunkType::CelChunk)
 					{
-						Stream->ReadRaw<uint32_t>(Chunk.Size);
-						Stream->ReadRaw<AsepriteChunkType>(Chunk.Type);
-						Chunk.Data.resize(Chunk.Size - 6);
-						Stream->ReadBytes(Chunk.Data, Chunk.Size - 6);
-						Data.ChunkData[x] = Chunk;
+						Data.CelsLoaded = false;
+						continue;
 					}
+					DispatchChunk(File, Data, Chunk);
 				}
 
-				//Add Data to vector
-				m_AsepriteData[Filename].Frames[i] = Data;
+				//Only the chunk headers were needed, skip straight to the next frame
+				if (Lazy)
+				{
+					Stream->SetStreamPosition(Data.Offset + Data.BytesInFrame);
+				}
 			}
 		}
-		void ReadOldPaletteChunk(AsepriteFileData& Data)
-		{
-			AsepriteOldPaletteChunk Chunk;
-			uint8_t Color[3];
 
-			for (auto& F : Data.Frames)
+		void CopyLayerLayout(const AsepriteFrameData& From, AsepriteFrameData& To)
+		{
+			To.Layers.reserve(From.Layers.size());
+			for (size_t l = 0; l < From.Layers.size(); l++)
 			{
-				for (auto& C : F.ChunkData)
-				{
-					if (C.Type == AsepriteChunkType::OldPaletteChunk1 || C.Type == AsepriteChunkType::OldPaletteChunk2)
-					{
-						Chunk.Type = C.Type;
+				const AsepriteLayer& Src = From.Layers[l];
+				AsepriteLayer& Dst = To.Layers.emplace_back(To.Layers.get_allocator().resource());
+				Dst.Layerindex = Src.Layerindex;
+				Dst.zIndex = Src.zIndex;
+				Dst.Flags = Src.Flags;
+				Dst.Type = Src.Type;
+				Dst.Child = Src.Child;
+				Dst.BlendMode = Src.BlendMode;
+				Dst.Opacity = Src.Opacity;
+				Dst.TilesetIndex = Src.TilesetIndex;
+				Dst.Name = Src.Name;
+			}
+		}
+		void ReadOldPaletteChunk(AsepriteFileData& File, AsepriteFrameData& F, const AsepriteChunk& C)
+		{
+			AsepriteOldPaletteChunk Chunk(File.GetResource());
 
-						MemoryStreamReader Stream((void*)C.Data.data(), C.Size);
+			Chunk.Type = C.Type;
+			bool SixBit = C.Type == AsepriteChunkType::OldPaletteChunk2;
 
-						Stream.ReadRaw<uint16_t>(Chunk.NumOfPackets);
-						Stream.ReadRaw<uint8_t>(Chunk.NumOfPalettesToSkip);
-						for (int i = (int)Chunk.NumOfPalettesToSkip; i < Chunk.NumOfPackets; i++)
-						{
-							Stream.ReadRaw<uint8_t>(Chunk.NumOfColors);
-							if ((int)Chunk.NumOfColors == 0)
-							{
-								Chunk.Colors.resize(256);
-							}
-							else
-							{
-								Chunk.Colors.resize((size_t)Chunk.NumOfColors);
-							}
-							for (int x = 0; x < (int)Chunk.NumOfColors; x++)
-							{
-								Stream.ReadRaw<uint8_t[3]>(Color);
-								Chunk.Colors[x] = Color;
-							}
-						}
-						F.OldPaletteChunks.push_back(Chunk);
-					}
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
 
+			Stream.ReadRaw<uint16_t>(Chunk.NumOfPackets);
+			Chunk.Packets.reserve(Chunk.NumOfPackets);
+			for (uint16_t p = 0; p < Chunk.NumOfPackets; p++)
+			{
+				AsepriteOldPalettePacket& Packet = Chunk.Packets.emplace_back(File.GetResource());
+				uint8_t NumOfColors;
+				Stream.ReadRaw<uint8_t>(Packet.NumOfEntriesToSkip);
+				Stream.ReadRaw<uint8_t>(NumOfColors);
+
+				//0 means all 256
+				size_t Count = NumOfColors == 0 ? 256 : NumOfColors;
+				const uint8_t* RGB = Stream.ReadView(Count * 3);
+				if (!RGB)
+				{
+					CoreLogger::Error("Old palette chunk is shorter than its packets say!");
+					break;
+				}
+
+				Packet.Colors.resize(Count);
+				for (size_t i = 0; i < Count; i++, RGB += 3)
+				{
+					//0x0011 chunks are 0-63 per channel
+					uint32_t R = SixBit ? RGB[0] * 255 / 63 : RGB[0];
+					uint32_t G = SixBit ? RGB[1] * 255 / 63 : RGB[1];
+					uint32_t B = SixBit ? RGB[2] * 255 / 63 : RGB[2];
+					Packet.Colors[i] = R | (G << 8) | (B << 16) | 0xFF000000;
 				}
 			}
+			F.OldPaletteChunks.push_back(std::move(Chunk));
 		}
-		void ReadLayerChunk(AsepriteFileData& Data)
+		void ReadLayerChunk(AsepriteFileData& File, AsepriteFrameData& F, const AsepriteChunk& C)
 		{
-			AsepriteLayer LayerChunk;
+			AsepriteLayer LayerChunk(File.GetResource());
 			uint8_t Useless;
 			uint16_t Ignored[2];
 
-			for (auto& F : Data.Frames)
-			{
-				for (auto& C : F.ChunkData)
-				{
-					if (C.Type == AsepriteChunkType::LayerChunk)
-					{
-						MemoryStreamReader Stream((void*)C.Data.data(), C.Size);
-
-						Stream.ReadRaw<uint16_t>(LayerChunk.Flags);
-						Stream.ReadRaw<uint16_t>(LayerChunk.Type);
-						Stream.ReadRaw<uint16_t>(LayerChunk.Child);
-						Stream.ReadRaw<uint16_t>(Ignored[0]);
-						Stream.ReadRaw<uint16_t>(Ignored[1]);
-						Stream.ReadRaw<uint16_t>(LayerChunk.BlendMode);
-						Stream.ReadRaw<uint8_t>(LayerChunk.Opacity);
-						for (int i = 0; i < 3; i++)
-						{
-							Stream.ReadRaw<uint8_t>(Useless);
-						}
-						uint16_t StrLen;
-						Stream.ReadRaw<uint16_t>(StrLen);
-						Stream.ReadString(LayerChunk.Name, StrLen);
-
-						if (LayerChunk.Type == 2)
-						{
-							CoreLogger::Error("Tilesets Currently not Supported!");
-						}
-						F.Layers.push_back(LayerChunk);
-					}
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
 
-				}
+			Stream.ReadRaw<uint16_t>(LayerChunk.Flags);
+			Stream.ReadRaw<uint16_t>(LayerChunk.Type);
+			Stream.ReadRaw<uint16_t>(LayerChunk.Child);
+			Stream.ReadRaw<uint16_t>(Ignored[0]);
+			Stream.ReadRaw<uint16_t>(Ignored[1]);
+			Stream.ReadRaw<uint16_t>(LayerChunk.BlendMode);
+			Stream.ReadRaw<uint8_t>(LayerChunk.Opacity);
+			for (int i = 0; i < 3; i++)
+			{
+				Stream.ReadRaw<uint8_t>(Useless);
+			}
+			uint16_t StrLen;
+			Stream.ReadRaw<uint16_t>(StrLen);
+			Stream.ReadString(LayerChunk.Name, StrLen);
+			LayerChunk.Layerindex = (int)F.Layers.size();
+			LayerChunk.zIndex = 0;
+
+			//Tilemap layers say which tileset their cels draw with
+			if (LayerChunk.Type == 2)
+			{
+				Stream.ReadRaw<uint32_t>(LayerChunk.TilesetIndex);
 			}
+			F.Layers.push_back(std::move(LayerChunk));
 		}
-		AsepriteCelChunk ReadCelChunk(AsepriteFileData& Data)
+		void ReadCelChunk(AsepriteFileData& File, AsepriteFrameData& F, const AsepriteChunk& C)
 		{
-			AsepriteCelChunk CelChunk;
+			AsepriteCelChunk CelChunk(File.GetResource());
 			uint8_t Useless;
-			int Index = 0;
 
-			for (auto& F : Data.Frames)
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
+
+			Stream.ReadRaw<uint16_t>(CelChunk.LayerIndex);
+			Stream.ReadRaw<int16_t>(CelChunk.x);
+			Stream.ReadRaw<int16_t>(CelChunk.y);
+			Stream.ReadRaw<uint8_t>(CelChunk.Opacity);
+			Stream.ReadRaw<uint16_t>(CelChunk.CelType);
+			Stream.ReadRaw<int16_t>(CelChunk.zIndex);
+			for (int i = 0; i < 5; i++)
 			{
-				for (auto& C : F.ChunkData)
-				{
-					if (C.Type == AsepriteChunkType::CelChunk)
-					{
-						MemoryStreamReader Stream((char*)C.Data.data(), C.Size);
-
-						Stream.ReadRaw<uint16_t>(CelChunk.LayerIndex);
-						Stream.ReadRaw<int16_t>(CelChunk.x);
-						Stream.ReadRaw<int16_t>(CelChunk.y);
-						Stream.ReadRaw<uint8_t>(CelChunk.Opacity);
-						Stream.ReadRaw<uint16_t>(CelChunk.CelType);
-						Stream.ReadRaw<int16_t>(CelChunk.zIndex);
-						for (int i = 0; i < 5; i++)
-						{
-							Stream.ReadRaw<uint8_t>(Useless);
-						}
+				Stream.ReadRaw<uint8_t>(Useless);
+			}
 
-						switch (CelChunk.CelType)
-						{
-						case 0:
-						{
-							CelChunk.PixelDatas.resize(CelChunk.PixelDatas.size() + 1);
-							Stream.ReadRaw<uint16_t>(CelChunk.Width);
-							Stream.ReadRaw<uint16_t>(CelChunk.Height);
-							for (int i = 0; i < (C.Size - 20); ++i)
-							{
-								uint8_t Pixel;
-								Stream.ReadRaw<uint8_t>(Pixel);
-								CelChunk.PixelDatas[Index].Pixels.push_back(Pixel);
-							}
-							F.Layers[CelChunk.LayerIndex].CelChunks.push_back(CelChunk);
-							Index++;
-							break;
-						}
-						case 1:
-						{
-							Stream.ReadRaw<uint16_t>(CelChunk.FramePosition);
-							F.Layers[CelChunk.LayerIndex].CelChunks.push_back(CelChunk);
-							break;
-						}
-						case 2:
-						{
-							CelChunk.PixelDatas.resize(CelChunk.PixelDatas.size() + 1);
-							Stream.ReadRaw<uint16_t>(CelChunk.Width);
-							Stream.ReadRaw<uint16_t>(CelChunk.Height);
-							for (int i = 0; i < (C.Size - 26); ++i)
-							{
-								uint8_t Pixel;
-								Stream.ReadRaw<uint8_t>(Pixel);
-								CelChunk.PixelDatas[Index].Pixels.push_back(Pixel);
-							}
-							F.Layers[CelChunk.LayerIndex].CelChunks.push_back(CelChunk);
-							Index++;
-							break;
-						}
-						default:
-						{
-							CoreLogger::Warn("Cel Chunk Type not supported!");
-							break;
-						}
-						}
-					}
-				}
+			if (CelChunk.LayerIndex >= F.Layers.size())
+			{
+				CoreLogger::Error("Cel Chunk references layer {} but only {} layers exist!", CelChunk.LayerIndex, F.Layers.size());
+				return;
 			}
 
+			switch (CelChunk.CelType)
+			{
+			case 0:
+			case 2:
+			{
+				Stream.ReadRaw<uint16_t>(CelChunk.Width);
+				Stream.ReadRaw<uint16_t>(CelChunk.Height);
+				size_t PixelBytes = Stream.GetRemaining();
+				const uint8_t* Pixels = Stream.ReadView(PixelBytes);
+				AsepritePixelData& Data = CelChunk.PixelDatas.emplace_back(File.GetResource());
+				Data.ChunkType = AsepriteChunkType::CelChunk;
+				//A mapped file outlives its cels, so they can point straight at their bytes in it
+				if (C.View)
+				{
+					Data.View = Pixels;
+					Data.ViewSize = PixelBytes;
+				}
+				else
+				{
+					Data.Pixels.assign(Pixels, Pixels + PixelBytes);
+				}
+				break;
+			}
+			case 1:
+			{
+				Stream.ReadRaw<uint16_t>(CelChunk.FramePosition);
+				break;
+			}
+			case 3:
+			{
+				if (!ReadTilemap(Stream, CelChunk))
+				{
+					return;
+				}
+				break;
+			}
+			default:
+			{
+				CoreLogger::Warn("Cel Chunk Type not supported!");
+				return;
+			}
+			}
 
-			return CelChunk;
+			F.Layers[CelChunk.LayerIndex].CelChunks.push_back(std::move(CelChunk));
 		}
-		void ReadColorProfileChunk(AsepriteFileData& Data)
+		//Tilemaps are small next to the pixels they stand for, so they're inflated as soon as they're read and kept as tile IDs from then on
+		bool ReadTilemap(MemorySpanReader& Stream, AsepriteCelChunk& CelChunk)
 		{
-			AsepriteColorProfileChunk Chunk;
-			uint8_t Useless;
+			AsepriteTilemap& Map = CelChunk.Tilemap;
+			Stream.ReadRaw<uint16_t>(Map.Width);
+			Stream.ReadRaw<uint16_t>(Map.Height);
+			Stream.ReadRaw<uint16_t>(Map.BitsPerTile);
+			Stream.ReadRaw<uint32_t>(Map.TileIDMask);
+			Stream.ReadRaw<uint32_t>(Map.XFlipMask);
+			Stream.ReadRaw<uint32_t>(Map.YFlipMask);
+			Stream.ReadRaw<uint32_t>(Map.DiagonalFlipMask);
+			Stream.Skip(10);
+			CelChunk.Width = Map.Width;
+			CelChunk.Height = Map.Height;
+
+			size_t BytesPerTile = Map.BitsPerTile / 8;
+			if (BytesPerTile != sizeof(uint8_t) && BytesPerTile != sizeof(uint16_t) && BytesPerTile != sizeof(uint32_t))
+			{
+				CoreLogger::Error("Tilemap cel on layer {} has {} bits per tile, only 8, 16 and 32 are supported", CelChunk.LayerIndex, Map.BitsPerTile);
+				return false;
+			}
 
-			for (auto& F : Data.Frames)
+			//32 bit tiles (all Aseprite writes) inflate straight into the grid, narrower ones get widened after
+			size_t Count = (size_t)Map.Width * Map.Height;
+			Map.Tiles.resize(Count);
+			std::vector<uint8_t> Packed(BytesPerTile == sizeof(uint32_t) ? 0 : Count * BytesPerTile);
+			uint8_t* Dst = Packed.empty() ? (uint8_t*)Map.Tiles.data() : Packed.data();
+			size_t Compressed = Stream.GetRemaining();
+			if (!CelDecoder::Inflate(Stream.ReadView(Compressed), Compressed, Dst, Count * BytesPerTile))
 			{
-				for (auto& C : F.ChunkData)
-				{
-					if (C.Type == AsepriteChunkType::ColorProfileChunk)
-					{
-						MemoryStreamReader Stream((void*)C.Data.data(), C.Size);
+				CoreLogger::Error("Unable to inflate the tilemap cel on layer {}", CelChunk.LayerIndex);
+				return false;
+			}
 
-						Stream.ReadRaw<uint16_t>(Chunk.Type);
-						Stream.ReadRaw<uint16_t>(Chunk.Flags);
-						Stream.ReadRaw<double>(Chunk.Gamma);
+			for (size_t i = 0; i < Packed.size() / BytesPerTile; i++)
+			{
+				Map.Tiles[i] = BytesPerTile == sizeof(uint8_t) ? Packed[i] : (uint32_t)Packed[i * 2] | ((uint32_t)Packed[i * 2 + 1] << 8);
+			}
+			return true;
+		}
+		void ReadColorProfileChunk(AsepriteFileData&, AsepriteFrameData&, const AsepriteChunk& C)
+		{
+			AsepriteColorProfileChunk Chunk;
+			uint8_t Useless;
 
-						for (int i = 0; i < 8; i++)
-						{
-							Stream.ReadRaw<uint8_t>(Useless);
-						}
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
 
-						if (Chunk.Type == 2)
-						{
-							Stream.ReadRaw<uint32_t>(Chunk.ICCProfileDataLength);
-							Stream.ReadBytes(Chunk.ICCProfileData, Chunk.ICCProfileDataLength);
-						}
-					}
+			Stream.ReadRaw<uint16_t>(Chunk.Type);
+			Stream.ReadRaw<uint16_t>(Chunk.Flags);
+			Stream.ReadRaw<double>(Chunk.Gamma);
 
+			for (int i = 0; i < 8; i++)
+			{
+				Stream.ReadRaw<uint8_t>(Useless);
+			}
 
-				}
+			if (Chunk.Type == 2)
+			{
+				Stream.ReadRaw<uint32_t>(Chunk.ICCProfileDataLength);
+				Stream.ReadBytes(Chunk.ICCProfileData, Chunk.ICCProfileDataLength);
 			}
 		}
-		void ReadExternalFilesChunk(AsepriteFileData& Data)
+		void ReadExternalFilesChunk(AsepriteFileData&, AsepriteFrameData&, const AsepriteChunk& C)
 		{
 			AsepriteExternalFilesChunk Chunk;
 			uint8_t Useless;
 
-			for (auto& F : Data.Frames)
-			{
-				for (auto& C : F.ChunkData)
-				{
-					if (C.Type == AsepriteChunkType::ExternalFilesChunk)
-					{
-						MemoryStreamReader Stream((void*)C.Data.data(), C.Size);
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
 
-						Stream.ReadRaw<uint32_t>(Chunk.NumOfEntries);
+			Stream.ReadRaw<uint32_t>(Chunk.NumOfEntries);
 
-						Chunk.Entries.resize(Chunk.NumOfEntries);
-						for (uint32_t i = 0; i < Chunk.NumOfEntries; i++)
-						{
-							Stream.ReadRaw<uint32_t>(Chunk.Entries[i].ID);
-							Stream.ReadRaw<uint8_t>(Chunk.Entries[i].Type);
-							for (int x = 0; x < 7; x++)
-							{
-								Stream.ReadRaw<uint8_t>(Useless);
-							}
+			Chunk.Entries.resize(Chunk.NumOfEntries);
+			for (uint32_t i = 0; i < Chunk.NumOfEntries; i++)
+			{
+				Stream.ReadRaw<uint32_t>(Chunk.Entries[i].ID);
+				Stream.ReadRaw<uint8_t>(Chunk.Entries[i].Type);
+				for (int x = 0; x < 7; x++)
+				{
+					Stream.ReadRaw<uint8_t>(Useless);
+				}
 
-							uint16_t StrLen;
-							Stream.ReadRaw<uint16_t>(StrLen);
-							Stream.ReadString(Chunk.Entries[i].Name, StrLen);
+				uint16_t StrLen;
+				Stream.ReadRaw<uint16_t>(StrLen);
+				Stream.ReadString(Chunk.Entries[i].Name, StrLen);
 
-						}
-					}
-				}
 			}
 		}
 		//While this is currently deprecated in the newest versions of Aseprite I have no clue what version people are using so this might be important
-		void ReadMaskChunk(AsepriteFileData& Data)
+		void ReadMaskChunk(AsepriteFileData&, AsepriteFrameData&, const AsepriteChunk& C)
 		{
 			AsepriteMaskChunk Chunk;
 			uint8_t Useless;
 
-			for (auto& F : Data.Frames)
-			{
-				for (auto& C : F.ChunkData)
-				{
-					if (C.Type == AsepriteChunkType::MaskChunk)
-					{
-						MemoryStreamReader Stream((void*)C.Data.data(), C.Size);
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
 
-						Stream.ReadRaw<int16_t>(Chunk.x);
-						Stream.ReadRaw<int16_t>(Chunk.y);
-						Stream.ReadRaw<uint16_t>(Chunk.Width);
-						Stream.ReadRaw<uint16_t>(Chunk.Height);
+			Stream.ReadRaw<int16_t>(Chunk.x);
+			Stream.ReadRaw<int16_t>(Chunk.y);
+			Stream.ReadRaw<uint16_t>(Chunk.Width);
+			Stream.ReadRaw<uint16_t>(Chunk.Height);
 
-						for (int i = 0; i < 8; i++)
-						{
-							Stream.ReadRaw<uint8_t>(Useless);
-						}
+			for (int i = 0; i < 8; i++)
+			{
+				Stream.ReadRaw<uint8_t>(Useless);
+			}
 
-						uint16_t StrLen;
-						Stream.ReadRaw<uint16_t>(StrLen);
-						Stream.ReadString(Chunk.Name, StrLen);
-						Stream.ReadBytes(Chunk.Data, (Chunk.Height * ((Chunk.Width + 7) / 8)));
+			uint16_t StrLen;
+			Stream.ReadRaw<uint16_t>(StrLen);
+			Stream.ReadString(Chunk.Name, StrLen);
+			Stream.ReadBytes(Chunk.Data, (Chunk.Height * ((Chunk.Width + 7) / 8)));
+		}
+		void ReadTagsChunk(AsepriteFileData& File, AsepriteFrameData&, const AsepriteChunk& C)
+		{
+			AsepriteTagsChunk Chunk(File.GetResource());
+			uint8_t Useless;
 
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
 
-					}
+			Stream.ReadRaw<uint16_t>(Chunk.NumOfTags);
+			Chunk.Tags.reserve(Chunk.NumOfTags);
+			for (int i = 0; i < 8; i++)
+			{
+				Stream.ReadRaw<uint8_t>(Useless);
+			}
+
+			for (int i = 0; i < Chunk.NumOfTags; i++)
+			{
+				Chunk.Tags.emplace_back(File.GetResource());
+				Stream.ReadRaw<uint16_t>(Chunk.Tags[i].FromFrame);
+				Stream.ReadRaw<uint16_t>(Chunk.Tags[i].ToFrame);
+				Stream.ReadRaw<uint8_t>(Chunk.Tags[i].LoopDirection);
+				Stream.ReadRaw<uint16_t>(Chunk.Tags[i].RepeatTimes);
+				for (int x = 0; x < 6; x++)
+				{
+					Stream.ReadRaw<uint8_t>(Useless);
 				}
+				Stream.ReadRaw<uint8_t[3]>(Chunk.Tags[i].RGB);
+				Stream.ReadRaw<uint8_t>(Useless);
+				uint16_t StrLen;
+				Stream.ReadRaw<uint16_t>(StrLen);
+				Stream.ReadString(Chunk.Tags[i].Name, StrLen);
 			}
+
+			File.Tags.insert(File.Tags.end(), std::make_move_iterator(Chunk.Tags.begin()), std::make_move_iterator(Chunk.Tags.end()));
 		}
-		void ReadTagsChunk(AsepriteFileData& Data)
+		void ReadNewPaletteChunk(AsepriteFileData& File, AsepriteFrameData& F, const AsepriteChunk& C)
 		{
-			AsepriteTagsChunk Chunk;
+			AsepritePaletteChunk Chunk(File.GetResource());
 			uint8_t Useless;
 
-			for (auto& F : Data.Frames)
-			{
-				for (auto& C : F.ChunkData)
-				{
-					if (C.Type == AsepriteChunkType::TagsChunk)
-					{
-						MemoryStreamReader Stream((void*)C.Data.data(), C.Size);
-
-						Stream.ReadRaw<uint16_t>(Chunk.NumOfTags);
-						Chunk.Tags.resize(Chunk.NumOfTags);
-						for (int i = 0; i < 8; i++)
-						{
-							Stream.ReadRaw<uint8_t>(Useless);
-						}
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
 
-						for (int i = 0; i < Chunk.NumOfTags; i++)
-						{
-							Stream.ReadRaw<uint16_t>(Chunk.Tags[i].FromFrame);
-							Stream.ReadRaw<uint16_t>(Chunk.Tags[i].ToFrame);
-							Stream.ReadRaw<uint8_t>(Chunk.Tags[i].LoopDirection);
-							Stream.ReadRaw<uint16_t>(Chunk.Tags[i].RepeatTimes);
-							for (int x = 0; x < 6; x++)
-							{
-								Stream.ReadRaw<uint8_t>(Useless);
-							}
-							Stream.ReadRaw<uint8_t[3]>(Chunk.Tags[i].RGB);
-							Stream.ReadRaw<uint8_t>(Useless);
-							uint16_t StrLen;
-							Stream.ReadRaw<uint16_t>(StrLen);
-							Stream.ReadString(Chunk.Tags[i].Name, StrLen);
-						}
+			Stream.ReadRaw<uint32_t>(Chunk.Size);
+			Stream.ReadRaw<uint32_t>(Chunk.FirstIndexToChange);
+			Stream.ReadRaw<uint32_t>(Chunk.LastIndexToChange);
+			if (Chunk.LastIndexToChange < Chunk.FirstIndexToChange || Chunk.LastIndexToChange >= Chunk.Size)
+			{
+				CoreLogger::Error("Palette chunk changes entries {} to {} of a {} color palette!", Chunk.FirstIndexToChange, Chunk.LastIndexToChange, Chunk.Size);
+				return;
+			}
+			for (int i = 0; i < 8; i++)
+			{
+				Stream.ReadRaw<uint8_t>(Useless);
+			}
 
+			//Entries are 2 bytes of flags then RGBA, which is already how the colours are kept, so each one is a single 4 byte copy
+			Chunk.Colors.resize((size_t)Chunk.LastIndexToChange - Chunk.FirstIndexToChange + 1);
+			for (size_t i = 0; i < Chunk.Colors.size(); i++)
+			{
+				const uint8_t* Entry = Stream.ReadView(6);
+				if (!Entry)
+				{
+					CoreLogger::Error("Palette chunk is shorter than its {} entries!", Chunk.Colors.size());
+					Chunk.Colors.resize(i);
+					break;
+				}
 
+				uint16_t Flags = Entry[0] | (Entry[1] << 8);
+				memcpy(&Chunk.Colors[i], Entry + 2, sizeof(uint32_t));
 
-					}
+				if (Flags & 1)
+				{
+					uint16_t StrLen;
+					AsepritePaletteEntryName Name(File.GetResource());
+					Name.Index = Chunk.FirstIndexToChange + (uint32_t)i;
+					Stream.ReadRaw<uint16_t>(StrLen);
+					Stream.ReadString(Name.Name, StrLen);
+					Chunk.Names.push_back(std::move(Name));
 				}
 			}
+
+			F.NewPaletteChunks.push_back(std::move(Chunk));
 		}
-		void ReadNewPaletteChunk(AsepriteFileData& Data)
+		void ReadUserDataChunk(AsepriteFileData&, AsepriteFrameData&, const AsepriteChunk& C)
 		{
-			AsepritePaletteChunk Chunk;
-			uint8_t Useless;
-			for (auto& F : Data.Frames)
-			{
-				for (auto& C : F.ChunkData)
-				{
-					if (C.Type == AsepriteChunkType::NewPaletteChunk)
-					{
-						MemoryStreamReader Stream((void*)C.Data.data(), C.Size);
+			AsepriteUserData Chunk;
 
-						Stream.ReadRaw<uint32_t>(Chunk.Size);
-						Chunk.Entries.resize(Chunk.Size);
-						Stream.ReadRaw<uint32_t>(Chunk.FirstIndexToChange);
-						Stream.ReadRaw<uint32_t>(Chunk.LastIndexToChange);
-						for (int i = 0; i < 8; i++)
-						{
-							Stream.ReadRaw<uint8_t>(Useless);
-						}
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
 
-						for (auto& E : Chunk.Entries)
-						{
-							uint8_t Pixel;
-							E.ChunkType = AsepriteChunkType::NewPaletteChunk;
-							Stream.ReadRaw<uint16_t>(E.Flags);
-							Stream.ReadRaw<uint8_t>(Pixel);
-							E.Pixels.push_back(Pixel);
-							Stream.ReadRaw<uint8_t>(Pixel);
-							E.Pixels.push_back(Pixel);
-							Stream.ReadRaw<uint8_t>(Pixel);
-							E.Pixels.push_back(Pixel);
-							Stream.ReadRaw<uint8_t>(Pixel);
-							E.Pixels.push_back(Pixel);
-
-							if (E.Flags == 1)
-							{
-								uint16_t StrLen;
-								Stream.ReadRaw<uint16_t>(StrLen);
-								Stream.ReadString(E.Name, StrLen);
-							}
-						}
+			Stream.ReadRaw<uint32_t>(Chunk.Flags);
 
-						F.NewPaletteChunks.push_back(Chunk);
-					}
 
-				}
+
+			if (Utils::EngineStatics::IsBitSet<uint32_t>(Chunk.Flags, 1))
+			{
+				uint16_t StrLen;
+				Stream.ReadRaw<uint16_t>(StrLen);
+				Stream.ReadString(Chunk.Text, StrLen);
 			}
-		}
-		void ReadUserDataChunk(AsepriteFileData& Data)
-		{
-			AsepriteUserData Chunk;
-			uint8_t Useless;
-			for (auto& F : Data.Frames)
+			if (Utils::EngineStatics::IsBitSet<uint32_t>(Chunk.Flags, 2))
+			{
+				Stream.ReadRaw<uint8_t[4]>(Chunk.RGBA);
+			}
+			if (Utils::EngineStatics::IsBitSet<uint32_t>(Chunk.Flags, 4))
 			{
-				for (auto& C : F.ChunkData)
+				Stream.ReadRaw<uint32_t>(Chunk.Size);
+				Stream.ReadRaw<uint32_t>(Chunk.NumOfPropMaps);
+
+				for (uint32_t i = 0; i < Chunk.NumOfPropMaps; i++)
 				{
-					if (C.Type == AsepriteChunkType::UserDataChunk)
-					{
-						MemoryStreamReader Stream((void*)C.Data.data(), C.Size);
+					uint32_t Value;
 
-						Stream.ReadRaw<uint32_t>(Chunk.Flags);
+					Stream.ReadRaw<uint32_t>(Value);
 
+					Chunk.PropMapKeyPairs.push_back(std::pair<uint32_t, uint32_t>(i, Value));
+					uint32_t NumOfProps;
+					Stream.ReadRaw<uint32_t>(NumOfProps);
+					Chunk.UserProps[i].resize(NumOfProps);
 
+					for (auto& KV : Chunk.UserProps[i])
+					{
+						uint16_t StrLen;
+						Stream.ReadRaw<uint16_t>(StrLen);
+						Stream.ReadString(KV.Name, StrLen);
+						Stream.ReadRaw<uint16_t>(KV.Type);
 
-						if (Utils::EngineStatics::IsBitSet<uint32_t>(Chunk.Flags, 1))
+						switch ((AsepritePropertyTypes)KV.Type)
+						{
+						case AsepritePropertyTypes::Boolean:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<bool>(KV.PropData.Boolean);
+							break;
+						}
+						case AsepritePropertyTypes::Int8:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<int8_t>(KV.PropData.Int8);
+							break;
+						}
+						case AsepritePropertyTypes::Int16:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<int16_t>(KV.PropData.Int16);
+							break;
+						}
+						case AsepritePropertyTypes::Uint16:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<uint16_t>(KV.PropData.Uint16);
+							break;
+						}
+						case AsepritePropertyTypes::Int32:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<int32_t>(KV.PropData.Int32);
+							break;
+						}
+						case AsepritePropertyTypes::Uint32:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<uint32_t>(KV.PropData.Uint32);
+							break;
+						}
+						case AsepritePropertyTypes::Int64:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<int64_t>(KV.PropData.Int64);
+							break;
+						}
+						case AsepritePropertyTypes::Uint64:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<uint64_t>(KV.PropData.Uint64);
+							break;
+						}
+						case AsepritePropertyTypes::Fixed:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<double>(KV.PropData.Fixed);
+							break;
+						}
+						case AsepritePropertyTypes::Float:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<float>(KV.PropData.Float);
+							break;
+						}
+						case AsepritePropertyTypes::Double:
+						{
+							KV.PropData.Type = KV.Type;
+							Stream.ReadRaw<double>(KV.PropData.Double);
+							break;
+						}
+						case AsepritePropertyTypes::String:
 						{
+							KV.PropData.Type = KV.Type;
 							uint16_t StrLen;
 							Stream.ReadRaw<uint16_t>(StrLen);
-							Stream.ReadString(Chunk.Text, StrLen);
+							Stream.ReadString(KV.PropData.String, StrLen);
+							break;
+						}
+						case AsepritePropertyTypes::Point:
+						{
+							KV.PropData.Type = KV.Type;
+							int32_t A;
+							int32_t B;
+							Stream.ReadRaw<int32_t>(A);
+							Stream.ReadRaw<int32_t>(B);
+							KV.PropData.Point = { A,B };
+							break;
 						}
-						if (Utils::EngineStatics::IsBitSet<uint32_t>(Chunk.Flags, 2))
+						case AsepritePropertyTypes::Size:
 						{
-							Stream.ReadRaw<uint8_t[4]>(Chunk.RGBA);
+							KV.PropData.Type = KV.Type;
+							int32_t A;
+							int32_t B;
+							Stream.ReadRaw<int32_t>(A);
+							Stream.ReadRaw<int32_t>(B);
+							KV.PropData.Size = { A,B };
+							break;
 						}
-						if (Utils::EngineStatics::IsBitSet<uint32_t>(Chunk.Flags, 4))
+						case AsepritePropertyTypes::Rect:
 						{
-							Stream.ReadRaw<uint32_t>(Chunk.Size);
-							Stream.ReadRaw<uint32_t>(Chunk.NumOfPropMaps);
-
-							for (uint32_t i = 0; i < Chunk.NumOfPropMaps; i++)
+							int32_t A;
+							int32_t B;
+							int32_t C;
+							int32_t D;
+							Stream.ReadRaw<int32_t>(A);
+							Stream.ReadRaw<int32_t>(B);
+							Stream.ReadRaw<int32_t>(C);
+							Stream.ReadRaw<int32_t>(D);
+							KV.PropData.Rect = { A,B, C,D };
+							break;
+						}
+						case AsepritePropertyTypes::Vector:
+						{
+							//We probably need to do some sort of recursion here
+							Stream.ReadRaw<uint32_t>(KV.NumofElementsInVec);
+							Stream.ReadRaw<uint16_t>(KV.ElementsType);
+							if (KV.ElementsType == 0)
 							{
-								uint32_t Value;
-
-								Stream.ReadRaw<uint32_t>(Value);
+								for (int i = 0; i < KV.NumofElementsInVec; i++)
+								{
+									//Get Type
+									uint16_t Type;
+									Stream.ReadRaw<uint16_t>(Type);
+									//Convert Type
 
-								Chunk.PropMapKeyPairs.push_back(std::pair<uint32_t, uint32_t>(i, Value));
-								uint32_t NumOfProps;
-								Stream.ReadRaw<uint32_t>(NumOfProps);
-								Chunk.UserProps[i].resize(NumOfProps);
+									//Start Recursion
+									ProcessElement(&Stream, ConvertToType(Type), KV);
+								}
 
-								for (auto& KV : Chunk.UserProps[i])
+							}
+							else
+							{
+								std::vector<std::byte> Bytes;
+								for (int i = 0; i < KV.NumofElementsInVec; i++)
 								{
-									uint16_t StrLen;
-									Stream.ReadRaw<uint16_t>(StrLen);
-									Stream.ReadString(KV.Name, StrLen);
-									Stream.ReadRaw<uint16_t>(KV.Type);
-
-									switch ((AsepritePropertyTypes)KV.Type)
-									{
-									case AsepritePropertyTypes::Boolean:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<bool>(KV.PropData.Boolean);
-										break;
-									}
-									case AsepritePropertyTypes::Int8:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<int8_t>(KV.PropData.Int8);
-										break;
-									}
-									case AsepritePropertyTypes::Int16:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<int16_t>(KV.PropData.Int16);
-										break;
-									}
-									case AsepritePropertyTypes::Uint16:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<uint16_t>(KV.PropData.Uint16);
-										break;
-									}
-									case AsepritePropertyTypes::Int32:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<int32_t>(KV.PropData.Int32);
-										break;
-									}
-									case AsepritePropertyTypes::Uint32:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<uint32_t>(KV.PropData.Uint32);
-										break;
-									}
-									case AsepritePropertyTypes::Int64:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<int64_t>(KV.PropData.Int64);
-										break;
-									}
-									case AsepritePropertyTypes::Uint64:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<uint64_t>(KV.PropData.Uint64);
-										break;
-									}
-									case AsepritePropertyTypes::Fixed:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<double>(KV.PropData.Fixed);
-										break;
-									}
-									case AsepritePropertyTypes::Float:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<float>(KV.PropData.Float);
-										break;
-									}
-									case AsepritePropertyTypes::Double:
-									{
-										KV.PropData.Type = KV.Type;
-										Stream.ReadRaw<double>(KV.PropData.Double);
-										break;
-									}
-									case AsepritePropertyTypes::String:
-									{
-										KV.PropData.Type = KV.Type;
-										uint16_t StrLen;
-										Stream.ReadRaw<uint16_t>(StrLen);
-										Stream.ReadString(KV.PropData.String, StrLen);
-										break;
-									}
-									case AsepritePropertyTypes::Point:
-									{
-										KV.PropData.Type = KV.Type;
-										int32_t A;
-										int32_t B;
-										Stream.ReadRaw<int32_t>(A);
-										Stream.ReadRaw<int32_t>(B);
-										KV.PropData.Point = { A,B };
-										break;
-									}
-									case AsepritePropertyTypes::Size:
-									{
-										KV.PropData.Type = KV.Type;
-										int32_t A;
-										int32_t B;
-										Stream.ReadRaw<int32_t>(A);
-										Stream.ReadRaw<int32_t>(B);
-										KV.PropData.Size = { A,B };
-										break;
-									}
-									case AsepritePropertyTypes::Rect:
-									{
-										int32_t A;
-										int32_t B;
-										int32_t C;
-										int32_t D;
-										Stream.ReadRaw<int32_t>(A);
-										Stream.ReadRaw<int32_t>(B);
-										Stream.ReadRaw<int32_t>(C);
-										Stream.ReadRaw<int32_t>(D);
-										KV.PropData.Rect = { A,B, C,D };
-										break;
-									}
-									case AsepritePropertyTypes::Vector:
-									{
-										//We probably need to do some sort of recursion here
-										Stream.ReadRaw<uint32_t>(KV.NumofElementsInVec);
-										Stream.ReadRaw<uint16_t>(KV.ElementsType);
-										if (KV.ElementsType == 0)
-										{
-											for (int i = 0; i < KV.NumofElementsInVec; i++)
-											{
-												//Get Type
-												uint16_t Type;
-												Stream.ReadRaw<uint16_t>(Type);
-												//Convert Type
-
-												//Start Recursion
-												ProcessElement(&Stream, ConvertToType(Type), KV);
-											}
-
-										}
-										else
-										{
-											std::vector<std::byte> Bytes;
-											for (int i = 0; i < KV.NumofElementsInVec; i++)
-											{
-												Stream.ReadBytes(Bytes, 4);
-											}
-										}
-										CoreLogger::Error("Not Implemented");
-										break;
-									}
-									case AsepritePropertyTypes::NestedMapProps:
-									{
-										uint32_t NumOfProps;
-										Stream.ReadRaw<uint32_t>(NumOfProps);
-										std::vector<std::byte> Bytes;
-										CoreLogger::Error("Not Implemented");
-
-										for (uint32_t i = 0; i < NumOfProps; i++)
-										{
-											Stream.ReadBytes(Bytes, sizeof(std::map<std::string, AsepriteVariant>));
-										}
-
-										break;
-									}
-									case AsepritePropertyTypes::UUID:
-									{
-
-										Stream.ReadRaw<uint8_t[16]>(KV.UUID);
-										break;
-									}
-									}
+									Stream.ReadBytes(Bytes, 4);
 								}
 							}
+							CoreLogger::Error("Not Implemented");
+							break;
+						}
+						case AsepritePropertyTypes::NestedMapProps:
+						{
+							uint32_t NumOfProps;
+							Stream.ReadRaw<uint32_t>(NumOfProps);
+							std::vector<std::byte> Bytes;
+							CoreLogger::Error("Not Implemented");
+
+							for (uint32_t i = 0; i < NumOfProps; i++)
+							{
+								Stream.ReadBytes(Bytes, sizeof(std::map<std::string, AsepriteVariant>));
+							}
 
+							break;
 						}
+						case AsepritePropertyTypes::UUID:
+						{
 
+							Stream.ReadRaw<uint8_t[16]>(KV.UUID);
+							break;
+						}
+						}
 					}
 				}
+
 			}
 		}
-		void ReadSliceChunk(AsepriteFileData& Data)
+		void ReadSliceChunk(AsepriteFileData& File, AsepriteFrameData&, const AsepriteChunk& C)
 		{
-			AsepriteSliceChunk Chunk;
+			AsepriteSliceChunk Chunk(File.GetResource());
 			uint32_t Useless;
 
-			for (auto& F : Data.Frames)
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
+
+			Stream.ReadRaw<uint32_t>(Chunk.NumOfSliceKeys);
+			Chunk.Slices.resize(Chunk.NumOfSliceKeys);
+			Stream.ReadRaw<uint32_t>(Chunk.Flags);
+			Stream.ReadRaw<uint32_t>(Useless);
+			uint16_t StrLen;
+			Stream.ReadRaw<uint16_t>(StrLen);
+			Stream.ReadString(Chunk.Name, StrLen);
+
+			for (auto& S : Chunk.Slices)
 			{
-				for (auto& C : F.ChunkData)
+				Stream.ReadRaw<uint32_t>(S.FrameNumber);
+				Stream.ReadRaw<int32_t>(S.SliceX);
+				Stream.ReadRaw<int32_t>(S.SliceY);
+				Stream.ReadRaw<uint32_t>(S.SliceWidth);
+				Stream.ReadRaw<uint32_t>(S.SliceHeight);
+
+				if (Chunk.IsNinePatch())
 				{
-					if (C.Type == AsepriteChunkType::SliceChunk)
-					{
-						MemoryStreamReader Stream((void*)C.Data.data(), C.Size);
+					Stream.ReadRaw<int32_t>(S.CenterX);
+					Stream.ReadRaw<int32_t>(S.CenterY);
+					Stream.ReadRaw<uint32_t>(S.CenterWidth);
+					Stream.ReadRaw<uint32_t>(S.CenterHeight);
+				}
 
-						Stream.ReadRaw<uint32_t>(Chunk.NumOfSliceKeys);
-						Chunk.Slices.resize(Chunk.NumOfSliceKeys);
-						Stream.ReadRaw<uint32_t>(Chunk.Flags);
-						Stream.ReadRaw<uint32_t>(Useless);
-						uint16_t StrLen;
-						Stream.ReadRaw<uint16_t>(StrLen);
-						Stream.ReadString(Chunk.Name, StrLen);
+				if (Chunk.HasPivot())
+				{
+					Stream.ReadRaw<int32_t>(S.PivotX);
+					Stream.ReadRaw<int32_t>(S.PivotY);
+				}
+			}
 
-						for (auto& S : Chunk.Slices)
-						{
-							Stream.ReadRaw<uint32_t>(S.FrameNumber);
-							Stream.ReadRaw<int32_t>(S.SliceX);
-							Stream.ReadRaw<int32_t>(S.SliceY);
-							Stream.ReadRaw<uint32_t>(S.SliceWidth);
-							Stream.ReadRaw<uint32_t>(S.SliceHeight);
+			if (!Stream.IsStreamGood())
+			{
+				CoreLogger::Error("Slice chunk {} is shorter than its {} keys say!", Chunk.Name, Chunk.NumOfSliceKeys);
+				return;
+			}
 
-							if (Utils::EngineStatics::IsBitSet<uint32_t>(Chunk.Flags, 1))
-							{
-								Stream.ReadRaw<int32_t>(S.CenterX);
-								Stream.ReadRaw<int32_t>(S.CenterY);
-								Stream.ReadRaw<uint32_t>(S.CenterWidth);
-								Stream.ReadRaw<uint32_t>(S.CenterHeight);
-							}
+			//Keys are looked up by frame with a binary search
+			std::stable_sort(Chunk.Slices.begin(), Chunk.Slices.end(), [](const AsepriteSliceKey& A, const AsepriteSliceKey& B)
+				{
+					return A.FrameNumber < B.FrameNumber;
+				});
+			File.Slices.push_back(std::move(Chunk));
+		}
+		//Embedded tiles are inflated here, once, and every tilemap cel in the file draws out of the same buffer
+		void ReadTilesetChunk(AsepriteFileData& File, AsepriteFrameData&, const AsepriteChunk& C)
+		{
+			AsepriteTileset Tileset(File.GetResource());
+
+			MemorySpanReader Stream(C.GetData(), C.GetDataSize());
+
+			Stream.ReadRaw<uint32_t>(Tileset.ID);
+			Stream.ReadRaw<uint32_t>(Tileset.Flags);
+			Stream.ReadRaw<uint32_t>(Tileset.NumOfTiles);
+			Stream.ReadRaw<uint16_t>(Tileset.TileWidth);
+			Stream.ReadRaw<uint16_t>(Tileset.TileHeight);
+			Stream.ReadRaw<int16_t>(Tileset.BaseIndex);
+			Stream.Skip(14);
+			uint16_t StrLen;
+			Stream.ReadRaw<uint16_t>(StrLen);
+			Stream.ReadString(Tileset.Name, StrLen);
+
+			if (Tileset.Flags & (uint32_t)AsepriteTilesetFlags::ExternalFile)
+			{
+				Stream.ReadRaw<uint32_t>(Tileset.ExternalFileID);
+				Stream.ReadRaw<uint32_t>(Tileset.ExternalTilesetID);
+			}
 
-							if (Utils::EngineStatics::IsBitSet<uint32_t>(Chunk.Flags, 2))
-							{
-								Stream.ReadRaw<int32_t>(S.PivotX);
-								Stream.ReadRaw<int32_t>(S.PivotY);
-							}
-						}
-					}
+			if (Tileset.Flags & (uint32_t)AsepriteTilesetFlags::EmbeddedTiles)
+			{
+				uint32_t DataLength;
+				Stream.ReadRaw<uint32_t>(DataLength);
+				const uint8_t* Data = Stream.ReadView(DataLength);
+
+				size_t BytesPerPixel = File.Header.Depth / 8;
+				auto Pixels = std::make_shared<std::vector<uint8_t>>(Tileset.GetTileStride() * Tileset.NumOfTiles * BytesPerPixel);
+				if (Data && CelDecoder::Inflate(Data, DataLength, Pixels->data(), Pixels->size()))
+				{
+					Tileset.Pixels = Pixels;
+				}
+				else
+				{
+					CoreLogger::Error("Unable to read the tiles of tileset {} ({})", Tileset.ID, Tileset.Name);
 				}
 			}
+			else
+			{
+				CoreLogger::Warn("Tileset {} ({}) lives in an external file, its tilemaps won't be drawn", Tileset.ID, Tileset.Name);
+			}
+
+			File.Tilesets.push_back(std::move(Tileset));
+		}
+
+		using ChunkHandler = void (AsepriteParser::*)(AsepriteFileData&, AsepriteFrameData&, const AsepriteChunk&);
+
+		//Every chunk type we know how to decode, ReadFrameData looks the handler up as soon as a chunk is read
+		//so the whole file gets decoded in the same pass that walks it
+		static const std::unordered_map<AsepriteChunkType, ChunkHandler>& GetChunkHandlers()
+		{
+			static const std::unordered_map<AsepriteChunkType, ChunkHandler> Handlers =
+			{
+				{ AsepriteChunkType::OldPaletteChunk1, &AsepriteParser::ReadOldPaletteChunk },
+				{ AsepriteChunkType::OldPaletteChunk2, &AsepriteParser::ReadOldPaletteChunk },
+				{ AsepriteChunkType::LayerChunk, &AsepriteParser::ReadLayerChunk },
+				{ AsepriteChunkType::CelChunk, &AsepriteParser::ReadCelChunk },
+				{ AsepriteChunkType::ColorProfileChunk, &AsepriteParser::ReadColorProfileChunk },
+				{ AsepriteChunkType::ExternalFilesChunk, &AsepriteParser::ReadExternalFilesChunk },
+				{ AsepriteChunkType::MaskChunk, &AsepriteParser::ReadMaskChunk },
+				{ AsepriteChunkType::TagsChunk, &AsepriteParser::ReadTagsChunk },
+				{ AsepriteChunkType::NewPaletteChunk, &AsepriteParser::ReadNewPaletteChunk },
+				{ AsepriteChunkType::UserDataChunk, &AsepriteParser::ReadUserDataChunk },
+				{ AsepriteChunkType::SliceChunk, &AsepriteParser::ReadSliceChunk },
+				{ AsepriteChunkType::TilesetChunk, &AsepriteParser::ReadTilesetChunk }
+			};
+
+			return Handlers;
+		}
+
+		void DispatchChunk(AsepriteFileData& File, AsepriteFrameData& F, const AsepriteChunk& C)
+		{
+			const auto& Handlers = GetChunkHandlers();
+			auto It = Handlers.find(C.Type);
+			if (It != Handlers.end())
+			{
+				(this->*(It->second))(File, F, C);
+			}
 		}
-		void ReadTilesetChunk(AsepriteFileData& Data) { CoreLogger::Error("Currently does not support Tilesets made in Aseprite!"); }
 
-		void ReorderLayers(const std::string& Filename)
+		void ReorderLayers(AsepriteFileData& Data)
 		{
 			bool ZIndexExist = false;
 
 
-			for (auto& F : m_AsepriteData[Filename].Frames)
+			for (auto& F : Data.Frames)
 			{
 				for (auto& L : F.Layers)
 				{
@@ -799,16 +1385,20 @@ namespace ASE
 			}
 
 
-			for (auto& F : m_AsepriteData[Filename].Frames)
+			for (auto& F : Data.Frames)
 			{
-				for (auto& L : F.Layers)
-				{
-					std::sort(L.CelChunks.begin(), L.CelChunks.end(), [](const AsepriteCelChunk& A, const AsepriteCelChunk& B)
-						{
-							return (A.order() < B.order()) || (A.order() == B.order() && (A.zIndex < B.zIndex));
-						});
-				}
+				SortFrameCels(F);
+			}
+		}
 
+		void SortFrameCels(AsepriteFrameData& F)
+		{
+			for (auto& L : F.Layers)
+			{
+				std::sort(L.CelChunks.begin(), L.CelChunks.end(), [](const AsepriteCelChunk& A, const AsepriteCelChunk& B)
+					{
+						return (A.order() < B.order()) || (A.order() == B.order() && (A.zIndex < B.zIndex));
+					});
 			}
 		}
 
@@ -832,7 +1422,7 @@ namespace ASE
 		{
 			return (AsepritePropertyTypes)T;
 		}
-		void ProcessElement(MemoryStreamReader* Stream, AsepritePropertyTypes T, AsepriteUserProps& Data)
+		void ProcessElement(MemorySpanReader* Stream, AsepritePropertyTypes T, AsepriteUserProps& Data)
 		{
 			switch (T)
 			{
@@ -996,7 +1586,10 @@ namespace ASE
 	private:
 
 		std::ifstream m_Stream;
-		std::unordered_map <std::string, AsepriteFileData> m_AsepriteData;
+		SlotMap<LoadedSprite, SpriteId> m_Sprites;
+		std::unordered_map<NameId, SpriteId> m_SpritesByName;
+		std::unordered_map<std::string, SpriteId> m_SpritesByPath;
+		StringTable m_Names;
 		std::unordered_map<std::string, std::shared_ptr<Image>> m_ImagePairs;
 	};
 }
@@ -1008,23 +1601,15 @@ std::shared_ptr<Texture2D> CreateImage(const std::string& Filename, bool ShouldC
 {
 	std::vector<uint8_t> ImgData;
 
-	uint32_t Width = m_AsepriteData[Filename].Header.Width;
-	uint32_t Height = m_AsepriteData[Filename].Header.Height;
-	int Channels = m_AsepriteData[Filename].Header.Depth == 32 ? 4 : 3;
-	uint8_t RGBType = m_AsepriteData[Filename].Header.Depth == 32 ? 2 : 1;
-
+	uint32_t Width = (*GetFileData(Filename)).Header.Width;
+	uint32_t Height = (*GetFileData(Filename)).Header.Height;
+	int Channels = (*GetFileData(Filename)).Header.Depth == 32 ? 4 : 3;
+	uint8_t RGBType = (*GetFileData(Filename)).Header.Depth == 32 ? 2 : 1;
 
-	ReadLayerChunk(m_AsepriteData[Filename]);
-	ReadCelChunk(m_AsepriteData[Filename]);
-	ReorderLayers(Filename);
 
-	for (auto& F : m_AsepriteData[Filename].Frames)
-	{
-		ReadOldPaletteChunk(m_AsepriteData[Filename]);
-		ReadNewPaletteChunk(m_AsepriteData[Filename]);
-	}
+	// ReadData has already decoded every chunk and ordered the cels, there's nothing left to read here
 
-	ImageSpecification Spec(Width, Height, Channels, RGBType, m_AsepriteData[Filename]);
+	ImageSpecification Spec(Width, Height, Channels, RGBType, (*GetFileData(Filename)));
 	Ref<Image> Img = CreateRef<Image>(Spec, ShouldFlipOnLoad);
 
 	m_ImagePairs[Filename] = Img;
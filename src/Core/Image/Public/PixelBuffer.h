@@ -0,0 +1,184 @@
+#pragma once
+#include <new>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <unordered_map>
+
+namespace ASE
+{
+	//Keeps the blocks PixelBuffers are done with and hands them out again to the next buffer of the same size, so loading and unloading
+	//sprites of the same size over and over stops going to the heap once it has warmed up. Every block is 64 byte aligned. Thread safe
+	class PixelBufferPool
+	{
+	public:
+		static constexpr size_t Alignment = 64;
+
+		//The pool every PixelBuffer uses. It's never destroyed so buffers freed during static destruction still have somewhere to go
+		static PixelBufferPool& Get()
+		{
+			static PixelBufferPool* Pool = new PixelBufferPool();
+			return *Pool;
+		}
+
+		//Size gets rounded up to a multiple of Alignment, blocks are only reused for buffers that round to the same size
+		uint8_t* Acquire(size_t Size)
+		{
+			size_t Rounded = RoundUp(Size);
+			{
+				std::lock_guard<std::mutex> Lock(m_Mutex);
+				auto It = m_Free.find(Rounded);
+				if (It != m_Free.end() && !It->second.empty())
+				{
+					uint8_t* Block = It->second.back();
+					It->second.pop_back();
+					m_RetainedBytes -= Rounded;
+					m_Reused++;
+					return Block;
+				}
+				m_Allocated++;
+			}
+			return (uint8_t*)::operator new(Rounded, std::align_val_t(Alignment));
+		}
+
+		//Blocks past the capacity are freed instead of kept
+		void Release(uint8_t* Block, size_t Size)
+		{
+			if (!Block)
+			{
+				return;
+			}
+
+			size_t Rounded = RoundUp(Size);
+			{
+				std::lock_guard<std::mutex> Lock(m_Mutex);
+				if (m_RetainedBytes + Rounded <= m_Capacity)
+				{
+					m_Free[Rounded].push_back(Block);
+					m_RetainedBytes += Rounded;
+					return;
+				}
+			}
+			::operator delete(Block, std::align_val_t(Alignment));
+		}
+
+		//Most bytes the pool holds on to while nothing is using them, 64MB unless it's changed. Lowering it frees blocks straight away
+		void SetCapacity(size_t Bytes)
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			m_Capacity = Bytes;
+			TrimTo(Bytes);
+		}
+		//Frees every block nothing is using, after a level is unloaded for instance
+		void Trim()
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			TrimTo(0);
+		}
+
+		size_t GetCapacity() const { std::lock_guard<std::mutex> Lock(m_Mutex); return m_Capacity; }
+		size_t GetRetainedBytes() const { std::lock_guard<std::mutex> Lock(m_Mutex); return m_RetainedBytes; }
+		//How many blocks have come from the heap and how many were handed out again instead
+		uint64_t GetAllocatedCount() const { std::lock_guard<std::mutex> Lock(m_Mutex); return m_Allocated; }
+		uint64_t GetReusedCount() const { std::lock_guard<std::mutex> Lock(m_Mutex); return m_Reused; }
+
+		static size_t RoundUp(size_t Size) { return (Size + Alignment - 1) / Alignment * Alignment; }
+
+	private:
+		PixelBufferPool() = default;
+
+		void TrimTo(size_t Bytes)
+		{
+			for (auto It = m_Free.begin(); It != m_Free.end() && m_RetainedBytes > Bytes;)
+			{
+				auto& Blocks = It->second;
+				while (!Blocks.empty() && m_RetainedBytes > Bytes)
+				{
+					::operator delete(Blocks.back(), std::align_val_t(Alignment));
+					Blocks.pop_back();
+					m_RetainedBytes -= It->first;
+				}
+				It = Blocks.empty() ? m_Free.erase(It) : std::next(It);
+			}
+		}
+
+		mutable std::mutex m_Mutex;
+		std::unordered_map<size_t, std::vector<uint8_t*>> m_Free; // Free blocks by rounded size
+		size_t m_RetainedBytes = 0;
+		size_t m_Capacity = 64ull * 1024 * 1024;
+		uint64_t m_Allocated = 0;
+		uint64_t m_Reused = 0;
+	};
+
+	class PixelBuffer;
+	//A buffer nobody can write to any more, for handing the same pixels to as many owners as need them
+	using SharedPixelBuffer = std::shared_ptr<const PixelBuffer>;
+
+	//Owns one 64 byte aligned block from the PixelBufferPool and gives it back when it's destroyed. Move only, Clone() when a copy is really wanted.
+	//The contents start out uninitialised like new[]
+	class PixelBuffer
+	{
+	public:
+		PixelBuffer() = default;
+		explicit PixelBuffer(size_t Size)
+			:m_Data(Size ? PixelBufferPool::Get().Acquire(Size) : nullptr), m_Size(Size) {}
+		PixelBuffer(const PixelBuffer&) = delete;
+		PixelBuffer(PixelBuffer&& Other) noexcept
+			:m_Data(std::exchange(Other.m_Data, nullptr)), m_Size(std::exchange(Other.m_Size, 0)) {}
+		~PixelBuffer() { Reset(); }
+
+		PixelBuffer& operator=(const PixelBuffer&) = delete;
+		PixelBuffer& operator=(PixelBuffer&& Other) noexcept
+		{
+			if (this != &Other)
+			{
+				Reset();
+				m_Data = std::exchange(Other.m_Data, nullptr);
+				m_Size = std::exchange(Other.m_Size, 0);
+			}
+			return *this;
+		}
+
+		//Gives the block back to the pool and leaves the buffer empty
+		void Reset()
+		{
+			PixelBufferPool::Get().Release(m_Data, m_Size);
+			m_Data = nullptr;
+			m_Size = 0;
+		}
+
+		PixelBuffer Clone() const
+		{
+			PixelBuffer Copy(m_Size);
+			if (m_Size)
+			{
+				memcpy(Copy.m_Data, m_Data, m_Size);
+			}
+			return Copy;
+		}
+
+		//Moves the pixels into a buffer that can only be read from and shared from then on
+		SharedPixelBuffer Share() &&
+		{
+			return std::make_shared<const PixelBuffer>(std::move(*this));
+		}
+
+		uint8_t* GetData() { return m_Data; }
+		const uint8_t* GetData() const { return m_Data; }
+		template<typename T>
+		T* As() { return reinterpret_cast<T*>(m_Data); }
+		template<typename T>
+		const T* As() const { return reinterpret_cast<const T*>(m_Data); }
+
+		size_t GetSize() const { return m_Size; }
+		bool IsEmpty() const { return m_Data == nullptr; }
+		explicit operator bool() const { return !IsEmpty(); }
+
+	private:
+		uint8_t* m_Data = nullptr;
+		size_t m_Size = 0;
+	};
+}
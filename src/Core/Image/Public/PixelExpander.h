@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#if defined(__AVX2__)
+#define ASE_EXPAND_AVX2 1
+#endif
+#if defined(__SSSE3__) || defined(__AVX__) || defined(__AVX2__)
+#define ASE_EXPAND_SSSE3 1
+#include <immintrin.h>
+#endif
+
+namespace ASE
+{
+	//Widens indexed (8 bit) and greyscale (value + alpha, 16 bit) pixels to the RGBA the Compositor works on.
+	//Indexed goes through the palette with an AVX2 gather, greyscale is a byte shuffle, and both have a plain table/loop fallback with no branches per pixel
+	class PixelExpander
+	{
+	public:
+		//Colors is a 256 entry palette
+		static void IndexedToRGBA(const uint8_t* Src, uint32_t* Dst, size_t Count, const uint32_t* Colors)
+		{
+			size_t i = 0;
+#if defined(ASE_EXPAND_AVX2)
+			for (; i + 8 <= Count; i += 8)
+			{
+				__m256i Indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(Src + i)));
+				_mm256_storeu_si256((__m256i*)(Dst + i), _mm256_i32gather_epi32((const int*)Colors, Indices, 4));
+			}
+#endif
+			for (; i < Count; i++)
+			{
+				Dst[i] = Colors[Src[i]];
+			}
+		}
+
+		static void GreyscaleToRGBA(const uint16_t* Src, uint32_t* Dst, size_t Count)
+		{
+			size_t i = 0;
+#if defined(ASE_EXPAND_AVX2)
+			//Each 128 bit lane spreads 4 of the 8 pixels, so the low lane reads bytes 0-7 and the high lane bytes 8-15
+			const __m256i Spread8 = _mm256_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7, 8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+			for (; i + 8 <= Count; i += 8)
+			{
+				__m256i Pixels = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(Src + i)));
+				_mm256_storeu_si256((__m256i*)(Dst + i), _mm256_shuffle_epi8(Pixels, Spread8));
+			}
+#endif
+#if defined(ASE_EXPAND_SSSE3)
+			const __m128i Spread4 = _mm_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7);
+			for (; i + 4 <= Count; i += 4)
+			{
+				__m128i Pixels = _mm_loadl_epi64((const __m128i*)(Src + i));
+				_mm_storeu_si128((__m128i*)(Dst + i), _mm_shuffle_epi8(Pixels, Spread4));
+			}
+#endif
+			for (; i < Count; i++)
+			{
+				uint32_t V = Src[i] & 0xFF;
+				Dst[i] = V | (V << 8) | (V << 16) | ((uint32_t)(Src[i] >> 8) << 24);
+			}
+		}
+
+		//Pixels of any depth as RGBA. 32 bit pixels are handed back as they are, anything else is expanded into Scratch.
+		//Colors is only read for indexed pixels
+		static const uint32_t* ToRGBA(const std::vector<uint8_t>& Pixels, size_t BytesPerPixel, const uint32_t* Colors, std::vector<uint32_t>& Scratch)
+		{
+			switch (BytesPerPixel)
+			{
+			case 4:
+			{
+				return (const uint32_t*)Pixels.data();
+			}
+			case 2:
+			{
+				Scratch.resize(Pixels.size() / 2);
+				GreyscaleToRGBA((const uint16_t*)Pixels.data(), Scratch.data(), Scratch.size());
+				return Scratch.data();
+			}
+			case 1:
+			{
+				Scratch.resize(Pixels.size());
+				IndexedToRGBA(Pixels.data(), Scratch.data(), Scratch.size(), Colors);
+				return Scratch.data();
+			}
+			default:
+			{
+				return nullptr;
+			}
+			}
+		}
+	};
+}
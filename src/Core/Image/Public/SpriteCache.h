@@ -0,0 +1,362 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+#include <filesystem>
+#include "Log/Public/Log.h"
+#include "Serializer/Public/DataWriter.h"
+#include "Serializer/Public/MappedFileReader.h"
+#include "Serializer/Public/DataReader.h"
+#include "Structs/Public/DataStructures.h"
+#include "Image/Public/FrameSet.h"
+#include "Image/Public/Palette.h"
+#include "Utils/Public/Hash.h"
+
+namespace ASE
+{
+	//First thing in a cache file. The Source fields are the key, a cache only counts for the file it was baked from while they still match.
+	//Every section starts on a SpriteCache::Alignment boundary so the frames can be handed straight from the mapping to SIMD code or a texture upload
+	struct SpriteCacheHeader
+	{
+		uint32_t Magic = 0;
+		uint32_t Version = 0;
+		uint64_t SourceSize = 0;
+		int64_t SourceTime = 0; // Last write time of the source in the filesystem clock's ticks
+		uint64_t PathHash = 0;
+		uint64_t ContentHash = 0;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		uint16_t FrameCount = 0;
+		uint16_t Reserved = 0;
+		uint32_t PaletteSize = 0;
+		uint64_t DurationsOffset = 0; // FrameCount uint16_t durations in milliseconds
+		uint64_t PaletteOffset = 0;   // 256 RGBA colours
+		uint64_t PixelsOffset = 0;    // FrameCount frames of Width * Height RGBA pixels, laid out like FrameSet
+		uint64_t PixelsSize = 0;
+		uint32_t TagCount = 0;
+		uint32_t SliceCount = 0;
+		uint64_t MetaOffset = 0; // TagCount tags then SliceCount slices with their keys, see SpriteCache::WriteMeta
+		uint64_t MetaSize = 0;
+	};
+
+	//Finished frames of a sprite, either read straight out of a mapped cache file or composited this run when there was no cache to write to.
+	//Same layout and getters as FrameSet, but read only since the mapping is
+	class BakedSprite
+	{
+	public:
+		BakedSprite() = default;
+		BakedSprite(const std::shared_ptr<MappedFile>& Mapping, const SpriteCacheHeader& Header, std::vector<AsepriteTag> Tags, std::vector<AsepriteSliceChunk> Slices)
+			:m_Mapping(Mapping), m_Width(Header.Width), m_Height(Header.Height), m_FrameCount(Header.FrameCount),
+			m_Pixels((const uint32_t*)(Mapping->GetData() + Header.PixelsOffset)), m_Durations((const uint16_t*)(Mapping->GetData() + Header.DurationsOffset)),
+			m_Palette((const uint32_t*)(Mapping->GetData() + Header.PaletteOffset), Header.PaletteSize), m_Tags(std::move(Tags)), m_Slices(std::move(Slices))
+		{
+		}
+		BakedSprite(const std::shared_ptr<const FrameSet>& Frames, const Palette& P, const AsepriteFileData& File)
+			:m_Frames(Frames), m_Width(Frames->GetWidth()), m_Height(Frames->GetHeight()), m_FrameCount(Frames->GetFrameCount()),
+			m_Pixels(Frames->GetBuffer()), m_Durations(Frames->GetDurations()), m_Palette(P),
+			m_Tags(File.Tags.begin(), File.Tags.end()), m_Slices(File.Slices.begin(), File.Slices.end())
+		{
+		}
+
+		bool IsValid() const { return m_Pixels != nullptr; }
+		explicit operator bool() const { return IsValid(); }
+		//True if the frames are coming from a cache file rather than having been decoded
+		bool IsMapped() const { return m_Mapping != nullptr; }
+
+		uint32_t GetWidth() const { return m_Width; }
+		uint32_t GetHeight() const { return m_Height; }
+		uint16_t GetFrameCount() const { return m_FrameCount; }
+		size_t GetFrameStride() const { return (size_t)m_Width * m_Height; }
+		uint16_t GetFrameDuration(uint16_t Frame) const { return m_Durations[Frame]; }
+
+		const uint32_t* GetFrame(uint16_t Frame) const { return m_Frames ? m_Frames->GetFrame(Frame) : m_Pixels + GetFrameStride() * Frame; }
+		//Only one frame per frame number if it came from the cache, a FrameSet can have been deduplicated
+		const uint32_t* GetBuffer() const { return m_Pixels; }
+		size_t GetByteSize() const { return m_Frames ? m_Frames->GetByteSize() : GetFrameStride() * m_FrameCount * sizeof(uint32_t); }
+
+		//Palette as of the first frame, for palette swaps and the like. The frames themselves are already RGBA
+		const Palette& GetPalette() const { return m_Palette; }
+
+		//Tags and slices of the source file, so a cached sprite can still be animated and nine-sliced. NameKeys are 0, nothing here is in a parser
+		const std::vector<AsepriteTag>& GetTags() const { return m_Tags; }
+		const std::vector<AsepriteSliceChunk>& GetSlices() const { return m_Slices; }
+
+	private:
+		std::shared_ptr<MappedFile> m_Mapping;
+		std::shared_ptr<const FrameSet> m_Frames;
+		uint32_t m_Width = 0;
+		uint32_t m_Height = 0;
+		uint16_t m_FrameCount = 0;
+		const uint32_t* m_Pixels = nullptr;
+		const uint16_t* m_Durations = nullptr;
+		Palette m_Palette;
+		std::vector<AsepriteTag> m_Tags;
+		std::vector<AsepriteSliceChunk> m_Slices;
+	};
+
+	//Opt-in on-disk cache of composited frames so a sprite that hasn't changed since the last run is one file mapping, no parsing and no inflating.
+	//Files are in native byte order, they're meant to live next to the build that wrote them, not to be shipped
+	class SpriteCache
+	{
+	public:
+		static constexpr uint32_t Magic = 0x43455341; // "ASEC"
+		static constexpr uint32_t Version = 2; // 2 added tags and slices
+		static constexpr uint64_t Alignment = 64;
+
+		//Where the cache for Source goes in Directory. It's named after a hash of Source's full path so sprites with the same name in different folders don't collide
+		static std::filesystem::path GetCachePath(const std::filesystem::path& Directory, const std::filesystem::path& Source)
+		{
+			char Name[32];
+			snprintf(Name, sizeof(Name), "%016llx.asecache", (unsigned long long)HashPath(Source));
+			return Directory / Name;
+		}
+
+		//Writes Frames, the palette and File's tags and slices out to CachePath, keyed on Source as it is right now.
+		//It's written next to CachePath first and moved over it once it's complete, so a crash mid-write never leaves a cache that looks valid
+		static bool Bake(const FrameSet& Frames, const Palette& P, const AsepriteFileData& File, const std::filesystem::path& Source, const std::filesystem::path& CachePath)
+		{
+			SpriteCacheHeader Header;
+			if (!ReadSourceKey(Source, Header))
+			{
+				return false;
+			}
+
+			MappedFile SourceFile(Source);
+			if (!SourceFile.IsValid())
+			{
+				return false;
+			}
+			Header.ContentHash = Utils::Hash64(SourceFile.GetData(), (size_t)SourceFile.GetSize());
+
+			Header.Magic = Magic;
+			Header.Version = Version;
+			Header.Width = Frames.GetWidth();
+			Header.Height = Frames.GetHeight();
+			Header.FrameCount = Frames.GetFrameCount();
+			Header.PaletteSize = (uint32_t)P.GetSize();
+			Header.DurationsOffset = Align(sizeof(SpriteCacheHeader));
+			Header.PaletteOffset = Align(Header.DurationsOffset + Header.FrameCount * sizeof(uint16_t));
+			Header.PixelsOffset = Align(Header.PaletteOffset + 256 * sizeof(uint32_t));
+			Header.PixelsSize = Frames.GetFrameStride() * Frames.GetFrameCount() * sizeof(uint32_t);
+			Header.TagCount = (uint32_t)File.Tags.size();
+			Header.SliceCount = (uint32_t)File.Slices.size();
+			Header.MetaOffset = Align(Header.PixelsOffset + Header.PixelsSize);
+
+			std::error_code Error;
+			if (CachePath.has_parent_path())
+			{
+				std::filesystem::create_directories(CachePath.parent_path(), Error);
+			}
+
+			std::filesystem::path TempPath = CachePath;
+			TempPath += ".tmp";
+			{
+				FileStreamWriter Stream(TempPath);
+				if (!Stream)
+				{
+					CoreLogger::Error("Unable to write sprite cache {}", TempPath.string());
+					return false;
+				}
+
+				Stream.WriteRaw<SpriteCacheHeader>(Header);
+				Stream.WriteZero(Header.DurationsOffset - Stream.GetStreamPosition());
+				Stream.WriteData((const char*)Frames.GetDurations(), Header.FrameCount * sizeof(uint16_t));
+				Stream.WriteZero(Header.PaletteOffset - Stream.GetStreamPosition());
+				Stream.WriteData((const char*)P.GetColors(), 256 * sizeof(uint32_t));
+				Stream.WriteZero(Header.PixelsOffset - Stream.GetStreamPosition());
+				//Frame by frame so a deduplicated FrameSet still comes out with one frame per frame number
+				for (uint16_t f = 0; f < Header.FrameCount; f++)
+				{
+					Stream.WriteData((const char*)Frames.GetFrame(f), Frames.GetFrameStride() * sizeof(uint32_t));
+				}
+				Stream.WriteZero(Header.MetaOffset - Stream.GetStreamPosition());
+				WriteMeta(Stream, File);
+
+				//The size of the metadata is only known now, so the header goes in again
+				Header.MetaSize = Stream.GetStreamPosition() - Header.MetaOffset;
+				Stream.SetStreamPosition(0);
+				Stream.WriteRaw<SpriteCacheHeader>(Header);
+
+				if (!Stream)
+				{
+					CoreLogger::Error("Failed writing sprite cache {}", TempPath.string());
+					return false;
+				}
+			}
+
+			std::filesystem::rename(TempPath, CachePath, Error);
+			if (Error)
+			{
+				CoreLogger::Error("Unable to move sprite cache into place at {}: {}", CachePath.string(), Error.message());
+				std::filesystem::remove(TempPath, Error);
+				return false;
+			}
+			return true;
+		}
+
+		//Maps CachePath if it's a cache of Source as it is right now, otherwise returns an invalid BakedSprite.
+		//Size and write time are all that's checked normally, the source is only hashed if its write time moved without its size changing (a touch, a checkout)
+		static BakedSprite Load(const std::filesystem::path& Source, const std::filesystem::path& CachePath)
+		{
+			std::error_code Error;
+			if (!std::filesystem::is_regular_file(CachePath, Error))
+			{
+				return BakedSprite();
+			}
+
+			SpriteCacheHeader Key;
+			if (!ReadSourceKey(Source, Key))
+			{
+				return BakedSprite();
+			}
+
+			MappedFileReader Stream(CachePath);
+			if (!Stream || Stream.GetFile()->GetSize() < sizeof(SpriteCacheHeader))
+			{
+				return BakedSprite();
+			}
+
+			SpriteCacheHeader Header;
+			Stream.ReadRaw<SpriteCacheHeader>(Header);
+			if (Header.Magic != Magic || Header.Version != Version || Header.PathHash != Key.PathHash || Header.SourceSize != Key.SourceSize)
+			{
+				return BakedSprite();
+			}
+			if (!HasSections(Header, Stream.GetFile()->GetSize()))
+			{
+				CoreLogger::Warn("Sprite cache {} is truncated, ignoring it", CachePath.string());
+				return BakedSprite();
+			}
+
+			if (Header.SourceTime != Key.SourceTime)
+			{
+				MappedFile SourceFile(Source);
+				if (!SourceFile.IsValid() || Utils::Hash64(SourceFile.GetData(), (size_t)SourceFile.GetSize()) != Header.ContentHash)
+				{
+					return BakedSprite();
+				}
+			}
+
+			std::vector<AsepriteTag> Tags;
+			std::vector<AsepriteSliceChunk> Slices;
+			if (!ReadMeta(Stream.GetFile()->GetData() + Header.MetaOffset, Header, Tags, Slices))
+			{
+				CoreLogger::Warn("Sprite cache {} has broken tags or slices, ignoring it", CachePath.string());
+				return BakedSprite();
+			}
+
+			return BakedSprite(Stream.GetFile(), Header, std::move(Tags), std::move(Slices));
+		}
+
+	private:
+		static uint64_t Align(uint64_t Offset)
+		{
+			return (Offset + Alignment - 1) & ~(Alignment - 1);
+		}
+
+		static uint64_t HashPath(const std::filesystem::path& Source)
+		{
+			std::error_code Error;
+			std::filesystem::path Full = std::filesystem::absolute(Source, Error);
+			std::string Path = (Error ? Source : Full).lexically_normal().generic_string();
+			return Utils::Hash64(Path.data(), Path.size());
+		}
+
+		//Fills in the Source fields of Header from the file as it is on disk
+		static bool ReadSourceKey(const std::filesystem::path& Source, SpriteCacheHeader& Header)
+		{
+			std::error_code Error;
+			Header.SourceSize = std::filesystem::file_size(Source, Error);
+			if (Error)
+			{
+				return false;
+			}
+			auto Time = std::filesystem::last_write_time(Source, Error);
+			if (Error)
+			{
+				return false;
+			}
+			Header.SourceTime = (int64_t)Time.time_since_epoch().count();
+			Header.PathHash = HashPath(Source);
+			return true;
+		}
+
+		//Each tag is its frames, loop direction, repeats and colour then its name as a uint16_t length and the characters.
+		//Each slice is its key count, flags and name the same way, then the keys as they are in memory
+		static void WriteMeta(DataWriter& Stream, const AsepriteFileData& File)
+		{
+			for (const AsepriteTag& Tag : File.Tags)
+			{
+				Stream.WriteRaw<uint16_t>(Tag.FromFrame);
+				Stream.WriteRaw<uint16_t>(Tag.ToFrame);
+				Stream.WriteRaw<uint8_t>(Tag.LoopDirection);
+				Stream.WriteRaw<uint16_t>(Tag.RepeatTimes);
+				Stream.WriteData((const char*)Tag.RGB, sizeof(Tag.RGB));
+				WriteName(Stream, Tag.Name);
+			}
+			for (const AsepriteSliceChunk& Slice : File.Slices)
+			{
+				Stream.WriteRaw<uint32_t>((uint32_t)Slice.Slices.size());
+				Stream.WriteRaw<uint32_t>(Slice.Flags);
+				WriteName(Stream, Slice.Name);
+				Stream.WriteData((const char*)Slice.Slices.data(), Slice.Slices.size() * sizeof(AsepriteSliceKey));
+			}
+		}
+		static void WriteName(DataWriter& Stream, const std::pmr::string& Name)
+		{
+			uint16_t Length = (uint16_t)std::min<size_t>(Name.size(), UINT16_MAX);
+			Stream.WriteRaw<uint16_t>(Length);
+			Stream.WriteData(Name.data(), Length);
+		}
+
+		static bool ReadMeta(const void* Data, const SpriteCacheHeader& Header, std::vector<AsepriteTag>& Tags, std::vector<AsepriteSliceChunk>& Slices)
+		{
+			MemorySpanReader Stream(Data, (size_t)Header.MetaSize);
+			uint16_t Length = 0;
+
+			Tags.resize(Header.TagCount);
+			for (AsepriteTag& Tag : Tags)
+			{
+				Stream.ReadRaw<uint16_t>(Tag.FromFrame);
+				Stream.ReadRaw<uint16_t>(Tag.ToFrame);
+				Stream.ReadRaw<uint8_t>(Tag.LoopDirection);
+				Stream.ReadRaw<uint16_t>(Tag.RepeatTimes);
+				Stream.ReadBytes(Tag.RGB, sizeof(Tag.RGB));
+				Stream.ReadRaw<uint16_t>(Length);
+				Stream.ReadString(Tag.Name, Length);
+			}
+
+			Slices.resize(Header.SliceCount);
+			for (AsepriteSliceChunk& Slice : Slices)
+			{
+				uint32_t KeyCount = 0;
+				Stream.ReadRaw<uint32_t>(KeyCount);
+				Stream.ReadRaw<uint32_t>(Slice.Flags);
+				Stream.ReadRaw<uint16_t>(Length);
+				Stream.ReadString(Slice.Name, Length);
+				if (KeyCount > Stream.GetRemaining() / sizeof(AsepriteSliceKey))
+				{
+					return false;
+				}
+				Slice.NumOfSliceKeys = KeyCount;
+				Slice.Slices.resize(KeyCount);
+				Stream.ReadBytes((uint8_t*)Slice.Slices.data(), KeyCount * sizeof(AsepriteSliceKey));
+			}
+			return Stream.IsStreamGood();
+		}
+
+		//Every section has to fit in the file and be where the format says it is
+		static bool HasSections(const SpriteCacheHeader& Header, uint64_t FileSize)
+		{
+			uint64_t PixelsSize = (uint64_t)Header.Width * Header.Height * Header.FrameCount * sizeof(uint32_t);
+			return Header.PixelsSize == PixelsSize && Header.PaletteSize <= 256 &&
+				Header.DurationsOffset % Alignment == 0 && Header.PaletteOffset % Alignment == 0 && Header.PixelsOffset % Alignment == 0 &&
+				Header.DurationsOffset + Header.FrameCount * sizeof(uint16_t) <= FileSize &&
+				Header.PaletteOffset + 256 * sizeof(uint32_t) <= FileSize &&
+				Header.PixelsOffset <= FileSize && PixelsSize <= FileSize - Header.PixelsOffset &&
+				Header.MetaOffset % Alignment == 0 && Header.MetaOffset <= FileSize && Header.MetaSize <= FileSize - Header.MetaOffset;
+		}
+	};
+}
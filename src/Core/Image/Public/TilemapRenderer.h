@@ -0,0 +1,132 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include "Structs/Public/DataStructures.h"
+#include "Image/Public/PixelExpander.h"
+
+namespace ASE
+{
+	//Walks a tilemap and hands every tile that isn't empty to a draw function as a small image straight out of the tileset,
+	//so a tilemap cel is drawn tile by tile and never expanded into a canvas sized cel of its own.
+	//Flipped tiles are the only ones copied, into a scratch buffer one tile big
+	class TilemapRenderer
+	{
+	public:
+		//Draw is called as Draw(const uint8_t* Pixels, int X, int Y, uint32_t Width, uint32_t Height, size_t Stride) with Stride in pixels.
+		//TilesetPixels is Tileset's tile strip at BytesPerPixel, which doesn't have to be the file's depth (an RGBA copy of it is fine).
+		//X and Y are where the tilemap's top left corner goes
+		template<typename Fn>
+		static void ForEachTile(const AsepriteTilemap& Map, const AsepriteTileset& Tileset, const uint8_t* TilesetPixels, size_t BytesPerPixel,
+			int X, int Y, std::vector<uint8_t>& Scratch, Fn&& Draw)
+		{
+			size_t TileBytes = Tileset.GetTileStride() * BytesPerPixel;
+			for (uint32_t ty = 0; ty < Map.Height; ty++)
+			{
+				for (uint32_t tx = 0; tx < Map.Width; tx++)
+				{
+					uint32_t Tile = Map.GetTile(tx, ty);
+					uint32_t TileID = Map.GetTileID(Tile);
+					if (Tileset.IsEmptyTile(TileID))
+					{
+						continue;
+					}
+
+					const uint8_t* Pixels = TilesetPixels + TileBytes * TileID;
+					int TileX = X + (int)(tx * Tileset.TileWidth);
+					int TileY = Y + (int)(ty * Tileset.TileHeight);
+					if (!Map.IsFlippedX(Tile) && !Map.IsFlippedY(Tile) && !Map.IsFlippedDiagonally(Tile))
+					{
+						Draw(Pixels, TileX, TileY, (uint32_t)Tileset.TileWidth, (uint32_t)Tileset.TileHeight, (size_t)Tileset.TileWidth);
+						continue;
+					}
+
+					uint32_t Width;
+					uint32_t Height;
+					FlipTile(Pixels, Tileset.TileWidth, Tileset.TileHeight, BytesPerPixel, Map.IsFlippedX(Tile), Map.IsFlippedY(Tile), Map.IsFlippedDiagonally(Tile), Scratch, Width, Height);
+					Draw(Scratch.data(), TileX, TileY, Width, Height, (size_t)Width);
+				}
+			}
+		}
+
+		//Copies a Width x Height tile into Dst as it's shown with the given flips. The diagonal flip swaps x and y first, then x and y get mirrored,
+		//so OutWidth and OutHeight are swapped for a diagonal flip
+		static void FlipTile(const uint8_t* Src, uint32_t Width, uint32_t Height, size_t BytesPerPixel, bool FlipX, bool FlipY, bool FlipDiagonal,
+			std::vector<uint8_t>& Dst, uint32_t& OutWidth, uint32_t& OutHeight)
+		{
+			OutWidth = FlipDiagonal ? Height : Width;
+			OutHeight = FlipDiagonal ? Width : Height;
+			Dst.resize((size_t)Width * Height * BytesPerPixel);
+
+			for (uint32_t y = 0; y < OutHeight; y++)
+			{
+				uint32_t FromY = FlipY ? OutHeight - 1 - y : y;
+				for (uint32_t x = 0; x < OutWidth; x++)
+				{
+					uint32_t FromX = FlipX ? OutWidth - 1 - x : x;
+					size_t From = FlipDiagonal ? (size_t)FromX * Width + FromY : (size_t)FromY * Width + FromX;
+					const uint8_t* Pixel = Src + From * BytesPerPixel;
+					std::copy(Pixel, Pixel + BytesPerPixel, Dst.data() + ((size_t)y * OutWidth + x) * BytesPerPixel);
+				}
+			}
+		}
+	};
+
+	//RGBA copies of the tilesets tilemap cels are drawn from. Each tileset is expanded once per palette it's drawn with however many cels and frames use it,
+	//so drawing a tilemap only costs walking its tile indices. RGBA tilesets are used as they are and never copied
+	class ExpandedTilesets
+	{
+	public:
+		//Expands Tileset the first time it's asked for with these Colors (the 256 entry palette for indexed files, ignored otherwise).
+		//Not thread safe, add everything up front and use Find from the threads drawing
+		const uint32_t* Add(const AsepriteTileset& Tileset, size_t BytesPerPixel, const uint32_t* Colors)
+		{
+			if (const uint32_t* Found = Find(Tileset, BytesPerPixel, Colors))
+			{
+				return Found;
+			}
+
+			Entry& Added = m_Entries.emplace_back();
+			Added.Tileset = &Tileset;
+			Added.Colors = BytesPerPixel == sizeof(uint8_t) ? Colors : nullptr;
+			const uint32_t* Pixels = PixelExpander::ToRGBA(*Tileset.Pixels, BytesPerPixel, Colors, Added.Pixels);
+			if (!Pixels)
+			{
+				m_Entries.pop_back();
+			}
+			return Pixels;
+		}
+
+		//Null if Tileset hasn't been added with these Colors
+		const uint32_t* Find(const AsepriteTileset& Tileset, size_t BytesPerPixel, const uint32_t* Colors) const
+		{
+			if (BytesPerPixel == sizeof(uint32_t))
+			{
+				return (const uint32_t*)Tileset.Pixels->data();
+			}
+
+			Colors = BytesPerPixel == sizeof(uint8_t) ? Colors : nullptr;
+			for (auto& E : m_Entries)
+			{
+				if (E.Tileset == &Tileset && E.Colors == Colors)
+				{
+					return E.Pixels.data();
+				}
+			}
+			return nullptr;
+		}
+
+		size_t GetCount() const { return m_Entries.size(); }
+
+	private:
+		//Files have a handful of tilesets and palettes, a list beats a map here
+		struct Entry
+		{
+			const AsepriteTileset* Tileset = nullptr;
+			const uint32_t* Colors = nullptr;
+			std::vector<uint32_t> Pixels;
+		};
+		std::vector<Entry> m_Entries;
+	};
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include <sstream>
+#include <fstream>
+#include <cstring>
 #include <filesystem>
 
 namespace ASE
@@ -31,6 +33,7 @@ namespace ASE
 		}
 		void ReadString(std::string& String, size_t Size)
 		{
+			String.resize(Size);
 			ReadData(&String[0], Size);
 		}
 
@@ -121,15 +124,11 @@ namespace ASE
 
 			for (uint32_t i = 0; i < Size; i++)
 			{
-				Key K;
-				if constexpr (std::is_trivial<Key>())
-				{
-					ReadRaw<Key>(K);
-				}
-				else
-				{
-					ReadObject<Key>(K);
-				}
+				//Mirrors DataWriter::WriteString
+				std::string K;
+				size_t StrLen;
+				ReadRaw<size_t>(StrLen);
+				ReadString(K, StrLen);
 
 				if constexpr (std::is_trivial<Value>())
 				{
@@ -219,6 +218,7 @@ namespace ASE
 	public:
 
 		MemoryStreamReader(void* Addr, size_t Size)
+			:m_Addr(Addr)
 		{
 			std::string s((char*)m_Addr, Size);
 			m_Stream = std::istringstream(s);
@@ -255,4 +255,109 @@ namespace ASE
 		std::string m_String;
 		std::istringstream m_Stream;
 	};
+
+	//Plain pointer cursor over memory that somebody else owns, nothing gets copied when it's made.
+	//ReadRaw/ReadString hide the DataReader versions so reading a field is a bounds check and a memcpy
+	//instead of a virtual call into an iostream. Prefer this over MemoryStreamReader for anything already in memory
+	class MemorySpanReader final : public DataReader
+	{
+	public:
+		MemorySpanReader(const void* Addr, size_t Size)
+			:m_Begin((const uint8_t*)Addr), m_Cursor((const uint8_t*)Addr), m_End((const uint8_t*)Addr + Size)
+		{
+		}
+		MemorySpanReader(const MemorySpanReader&) = delete;
+
+		virtual ~MemorySpanReader() = default;
+
+		bool IsStreamGood() const final { return m_Good; }
+		uint64_t GetStreamPosition() final { return (uint64_t)(m_Cursor - m_Begin); }
+		void SetStreamPosition(uint64_t Pos) final
+		{
+			if (Pos > (uint64_t)(m_End - m_Begin))
+			{
+				m_Good = false;
+				return;
+			}
+			m_Cursor = m_Begin + Pos;
+			m_Good = true;
+		}
+		bool ReadData(char* Data, size_t Size) final
+		{
+			return Read(Data, Size);
+		}
+		bool ReadBytes(std::vector<std::byte>& Data, size_t Size) final
+		{
+			if (Data.size() < Size)
+			{
+				Data.resize(Size);
+			}
+			return Read(Data.data(), Size);
+		}
+		bool ReadBytes(uint8_t* Data, size_t Size) final
+		{
+			return Read(Data, Size);
+		}
+
+		template<typename T>
+		inline void ReadRaw(T& Type)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "ReadRaw only works on trivially copyable types");
+			if (!Read(&Type, sizeof(T)))
+			{
+				memset(&Type, 0, sizeof(T));
+			}
+		}
+
+		//Any allocator, so names can go straight into a std::pmr::string
+		template<typename Alloc>
+		inline void ReadString(std::basic_string<char, std::char_traits<char>, Alloc>& String, size_t Size)
+		{
+			const uint8_t* Str = ReadView(Size);
+			if (!Str)
+			{
+				String.clear();
+				return;
+			}
+			String.assign((const char*)Str, Size);
+		}
+
+		//Hands back a pointer to the next Size bytes and moves past them, or nullptr if there aren't that many left
+		inline const uint8_t* ReadView(size_t Size)
+		{
+			if (Size > GetRemaining())
+			{
+				m_Good = false;
+				return nullptr;
+			}
+			const uint8_t* View = m_Cursor;
+			m_Cursor += Size;
+			return View;
+		}
+
+		inline void Skip(size_t Size)
+		{
+			ReadView(Size);
+		}
+
+		inline size_t GetRemaining() const { return (size_t)(m_End - m_Cursor); }
+
+	private:
+		inline bool Read(void* Data, size_t Size)
+		{
+			const uint8_t* Src = ReadView(Size);
+			if (!Src)
+			{
+				return false;
+			}
+			memcpy(Data, Src, Size);
+			return true;
+		}
+
+	private:
+		const uint8_t* m_Begin;
+		const uint8_t* m_Cursor;
+		const uint8_t* m_End;
+		bool m_Good = true;
+	};
 }
\ No newline at end of file
@@ -147,7 +147,7 @@ namespace ASE
 		void WriteRaw(const T& Type)
 		{
 			bool Success = WriteData((char*)&Type, sizeof(T));
-			AGE_GAME_ASSERT(Success, "Failed to Write Data");
+			ASE_CORE_ASSERT(Success, "Failed to Write Data");
 		}
 
 		template<typename T>
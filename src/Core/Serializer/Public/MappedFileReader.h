@@ -0,0 +1,203 @@
+#pragma once
+#include <memory>
+#include <cstring>
+#include <filesystem>
+#include "Log/Public/Log.h"
+#include "Serializer/Public/DataReader.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ASE
+{
+	//Read-only mapping of a whole file. This is shared between the reader and whatever got parsed out of it
+	//so chunk views stay valid for as long as someone still holds the file data
+	class MappedFile
+	{
+	public:
+		MappedFile(const std::filesystem::path& Path)
+		{
+#ifdef _WIN32
+			m_File = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (m_File == INVALID_HANDLE_VALUE)
+			{
+				CoreLogger::Error("Unable to open {} for mapping", Path.string());
+				return;
+			}
+
+			LARGE_INTEGER FileSize;
+			if (!GetFileSizeEx(m_File, &FileSize) || FileSize.QuadPart == 0)
+			{
+				CoreLogger::Error("Unable to map {}, file is empty or unreadable", Path.string());
+				return;
+			}
+
+			m_Mapping = CreateFileMappingW(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!m_Mapping)
+			{
+				CoreLogger::Error("CreateFileMapping failed for {}", Path.string());
+				return;
+			}
+
+			m_Data = (const std::byte*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+			if (!m_Data)
+			{
+				CoreLogger::Error("MapViewOfFile failed for {}", Path.string());
+				return;
+			}
+			m_Size = (uint64_t)FileSize.QuadPart;
+#else
+			m_File = open(Path.c_str(), O_RDONLY);
+			if (m_File < 0)
+			{
+				CoreLogger::Error("Unable to open {} for mapping", Path.string());
+				return;
+			}
+
+			struct stat Stat;
+			if (fstat(m_File, &Stat) != 0 || Stat.st_size == 0)
+			{
+				CoreLogger::Error("Unable to map {}, file is empty or unreadable", Path.string());
+				return;
+			}
+
+			void* Addr = mmap(nullptr, (size_t)Stat.st_size, PROT_READ, MAP_PRIVATE, m_File, 0);
+			if (Addr == MAP_FAILED)
+			{
+				CoreLogger::Error("mmap failed for {}", Path.string());
+				return;
+			}
+			madvise(Addr, (size_t)Stat.st_size, MADV_SEQUENTIAL);
+
+			m_Data = (const std::byte*)Addr;
+			m_Size = (uint64_t)Stat.st_size;
+#endif
+		}
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		~MappedFile()
+		{
+#ifdef _WIN32
+			if (m_Data)
+			{
+				UnmapViewOfFile(m_Data);
+			}
+			if (m_Mapping)
+			{
+				CloseHandle(m_Mapping);
+			}
+			if (m_File != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(m_File);
+			}
+#else
+			if (m_Data)
+			{
+				munmap((void*)m_Data, (size_t)m_Size);
+			}
+			if (m_File >= 0)
+			{
+				close(m_File);
+			}
+#endif
+		}
+
+		bool IsValid() const { return m_Data != nullptr; }
+		const std::byte* GetData() const { return m_Data; }
+		uint64_t GetSize() const { return m_Size; }
+
+	private:
+		const std::byte* m_Data = nullptr;
+		uint64_t m_Size = 0;
+
+#ifdef _WIN32
+		HANDLE m_File = INVALID_HANDLE_VALUE;
+		HANDLE m_Mapping = nullptr;
+#else
+		int m_File = -1;
+#endif
+	};
+
+	class MappedFileReader : public DataReader
+	{
+	public:
+		MappedFileReader(const std::filesystem::path& Path)
+			:m_File(std::make_shared<MappedFile>(Path))
+		{
+			m_Good = m_File->IsValid();
+		}
+		MappedFileReader(const std::shared_ptr<MappedFile>& File)
+			:m_File(File)
+		{
+			m_Good = m_File && m_File->IsValid();
+		}
+		MappedFileReader(const MappedFileReader&) = delete;
+
+		virtual ~MappedFileReader() = default;
+
+		bool IsStreamGood() const final { return m_Good; }
+		uint64_t GetStreamPosition() final { return m_Position; }
+		void SetStreamPosition(uint64_t Pos) final
+		{
+			m_Good = m_File->IsValid() && Pos <= m_File->GetSize();
+			m_Position = Pos;
+		}
+		bool ReadData(char* Data, size_t Size) final
+		{
+			const std::byte* Src = ReadView(Size);
+			if (!Src)
+			{
+				return false;
+			}
+			memcpy(Data, Src, Size);
+			return true;
+		}
+		bool ReadBytes(std::vector<std::byte>& Data, size_t Size) final
+		{
+			if (Data.size() < Size)
+			{
+				Data.resize(Size);
+			}
+			return ReadData(reinterpret_cast<char*>(Data.data()), Size);
+		}
+		bool ReadBytes(uint8_t* Data, size_t Size) final
+		{
+			return ReadData(reinterpret_cast<char*>(Data), Size);
+		}
+
+		//Returns a pointer into the mapping and skips past it, nothing gets copied
+		//Returns nullptr (and marks the stream bad) if there aren't Size bytes left
+		const std::byte* ReadView(size_t Size)
+		{
+			if (!m_Good || Size > m_File->GetSize() - m_Position)
+			{
+				m_Good = false;
+				return nullptr;
+			}
+
+			const std::byte* View = m_File->GetData() + m_Position;
+			m_Position += Size;
+			return View;
+		}
+
+		const std::shared_ptr<MappedFile>& GetFile() const { return m_File; }
+
+	private:
+		std::shared_ptr<MappedFile> m_File;
+		uint64_t m_Position = 0;
+		bool m_Good = false;
+	};
+}
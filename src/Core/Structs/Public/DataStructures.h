@@ -3,7 +3,14 @@
 #include <cstddef>
 #include <variant>
 #include <map>
+#include <memory>
 #include <cmath>
+#include <array>
+#include <vector>
+#include <string>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
 #include <immintrin.h>
 
 
@@ -259,6 +266,7 @@ namespace ASE
 	};
 
 	struct AsepriteVariant;
+	class MappedFile;
 
 	struct AGEPoint
 	{
@@ -336,6 +344,69 @@ namespace ASE
 		TilesetChunk = 0x2023
 	};
 
+	//Values of AsepriteLayer::BlendMode
+	enum class AsepriteBlendMode : uint16_t
+	{
+		Normal = 0,
+		Multiply = 1,
+		Screen = 2,
+		Overlay = 3,
+		Darken = 4,
+		Lighten = 5,
+		ColorDodge = 6,
+		ColorBurn = 7,
+		HardLight = 8,
+		SoftLight = 9,
+		Difference = 10,
+		Exclusion = 11,
+		Hue = 12,
+		Saturation = 13,
+		Color = 14,
+		Luminosity = 15,
+		Addition = 16,
+		Subtract = 17,
+		Divide = 18
+	};
+
+	//Bits of AsepriteLayer::Flags
+	enum class AsepriteLayerFlags : uint16_t
+	{
+		Visible = 1,
+		Editable = 2,
+		LockMovement = 4,
+		Background = 8,
+		PreferLinkedCels = 16,
+		DisplayCollapsed = 32,
+		Reference = 64
+	};
+
+	//Bits of AsepriteTileset::Flags
+	enum class AsepriteTilesetFlags : uint32_t
+	{
+		ExternalFile = 1,
+		EmbeddedTiles = 2,
+		EmptyTileIsZero = 4, // Otherwise the empty tile is 0xFFFFFFFF, only old internal versions of Aseprite wrote that
+		MatchXFlip = 8,
+		MatchYFlip = 16,
+		MatchDiagonalFlip = 32
+	};
+
+	//Bits of AsepriteSliceChunk::Flags
+	enum class AsepriteSliceFlags : uint32_t
+	{
+		NinePatch = 1,
+		Pivot = 2
+	};
+
+	//Values of AsepriteTag::LoopDirection
+	enum class AsepriteLoopDirection : uint8_t
+	{
+		Forward = 0,
+		Reverse = 1,
+		PingPong = 2,
+		PingPongReverse = 3
+	};
+
 	enum class AsepritePropertyTypes : uint16_t
 	{
 		Boolean = 0x0001,
@@ -421,29 +492,40 @@ namespace ASE
 
 
 
+	//Everything a file is parsed into takes the memory_resource its containers allocate from, see AsepriteFileData::GetResource
 	struct AsepritePixelData
 	{
+		AsepritePixelData() = default;
+		explicit AsepritePixelData(std::pmr::memory_resource* Resource)
+			:Pixels(Resource), Name(Resource) {}
+
 		AsepriteChunkType ChunkType;
 		uint16_t Flags;
-		std::vector<uint8_t> Pixels;
-		std::string Name;
+		std::pmr::vector<uint8_t> Pixels; // Stays empty when View points into the mapped file instead
+		std::pmr::string Name;
+		const uint8_t* View = nullptr;
+		size_t ViewSize = 0;
+
+		const uint8_t* GetData() const { return View ? View : Pixels.data(); }
+		size_t GetSize() const { return View ? ViewSize : Pixels.size(); }
 	};
 
+	//A slice as it is from FrameNumber until the next key. Center and pivot are relative to the slice's top left and stay 0 unless the slice has them
 	struct AsepriteSliceKey
 	{
-		uint32_t FrameNumber;
-		int32_t SliceX;
-		int32_t SliceY;
-		uint32_t SliceWidth;
-		uint32_t SliceHeight;
-
-		int32_t CenterX;
-		int32_t CenterY;
-		uint32_t CenterWidth;
-		uint32_t CenterHeight;
-
-		int32_t PivotX;
-		int32_t PivotY;
+		uint32_t FrameNumber = 0;
+		int32_t SliceX = 0;
+		int32_t SliceY = 0;
+		uint32_t SliceWidth = 0;
+		uint32_t SliceHeight = 0;
+
+		int32_t CenterX = 0;
+		int32_t CenterY = 0;
+		uint32_t CenterWidth = 0;
+		uint32_t CenterHeight = 0;
+
+		int32_t PivotX = 0;
+		int32_t PivotY = 0;
 	};
 
 	struct AsepriteExternalFileEntry
@@ -455,13 +537,18 @@ namespace ASE
 
 	struct AsepriteTag
 	{
+		AsepriteTag() = default;
+		explicit AsepriteTag(std::pmr::memory_resource* Resource)
+			:Name(Resource) {}
+
 		uint16_t FromFrame;
 		uint16_t ToFrame;
 		uint8_t LoopDirection;
-		uint16_t RepeatTimes;
+		uint16_t RepeatTimes; // 0 repeats forever
 
 		uint8_t RGB[3]; //Deprecated in newer versions
-		std::string Name;
+		std::pmr::string Name;
+		uint32_t NameKey = 0; // Name interned in the parser's StringTable, 0 until the sprite is added to a parser
 	};
 
 	struct AsepriteUserProps
@@ -492,12 +579,65 @@ namespace ASE
 
 	};
 
+	//Tiles of a tilemap cel as they're stored, a tile ID in the low bits and flip flags in the high ones. Each tile is 4 bytes however many bits the file used
+	struct AsepriteTilemap
+	{
+		AsepriteTilemap() = default;
+		explicit AsepriteTilemap(std::pmr::memory_resource* Resource)
+			:Tiles(Resource) {}
+
+		uint16_t Width = 0; // In tiles
+		uint16_t Height = 0;
+		uint16_t BitsPerTile = 32;
+		uint32_t TileIDMask = 0x1FFFFFFF;
+		uint32_t XFlipMask = 0x80000000;
+		uint32_t YFlipMask = 0x40000000;
+		uint32_t DiagonalFlipMask = 0x20000000;
+		std::pmr::vector<uint32_t> Tiles; // Width * Height, row by row
+
+		uint32_t GetTile(uint32_t X, uint32_t Y) const { return Tiles[(size_t)Y * Width + X]; }
+		uint32_t GetTileID(uint32_t Tile) const { return Tile & TileIDMask; }
+		bool IsFlippedX(uint32_t Tile) const { return (Tile & XFlipMask) != 0; }
+		bool IsFlippedY(uint32_t Tile) const { return (Tile & YFlipMask) != 0; }
+		bool IsFlippedDiagonally(uint32_t Tile) const { return (Tile & DiagonalFlipMask) != 0; }
+	};
+
+	//Tiles are decoded once when the chunk is read and shared by every tilemap cel that uses the tileset
+	struct AsepriteTileset
+	{
+		AsepriteTileset() = default;
+		explicit AsepriteTileset(std::pmr::memory_resource* Resource)
+			:Name(Resource) {}
+
+		uint32_t ID;
+		uint32_t Flags;
+		uint32_t NumOfTiles;
+		uint16_t TileWidth;
+		uint16_t TileHeight;
+		int16_t BaseIndex; // Only how Aseprite numbers tiles in its UI, tilemaps still store 0 based IDs
+		std::pmr::string Name;
+		uint32_t ExternalFileID = 0; // Entry of the external files chunk the tileset lives in, when it isn't embedded
+		uint32_t ExternalTilesetID = 0;
+		std::shared_ptr<const std::vector<uint8_t>> Pixels; // Every tile at the file's depth stacked top to bottom, TileWidth wide and TileHeight * NumOfTiles tall. Null if not embedded
+
+		size_t GetTileStride() const { return (size_t)TileWidth * TileHeight; } // Pixels from one tile to the next
+		//Nothing gets drawn for the empty tile, or for IDs past the end of the tileset
+		bool IsEmptyTile(uint32_t TileID) const { return TileID >= NumOfTiles || (TileID == 0 && (Flags & (uint32_t)AsepriteTilesetFlags::EmptyTileIsZero)); }
+	};
+
 	struct AsepriteCelChunk
 	{
 	public:
 		AsepriteCelChunk() = default;
+		explicit AsepriteCelChunk(std::pmr::memory_resource* Resource)
+			:PixelDatas(Resource), Tilemap(Resource) {}
+		AsepriteCelChunk(const AsepriteCelChunk&) = default;
+		AsepriteCelChunk(AsepriteCelChunk&&) = default;
 		~AsepriteCelChunk() = default;
 
+		AsepriteCelChunk& operator=(const AsepriteCelChunk&) = default;
+		AsepriteCelChunk& operator=(AsepriteCelChunk&&) = default;
+
 
 		uint16_t LayerIndex;
 		int16_t x;
@@ -505,10 +645,11 @@ namespace ASE
 		uint8_t Opacity;
 		uint16_t CelType;
 		int16_t zIndex;
-		uint16_t Width;
-		uint16_t Height;
-		uint16_t FramePosition; // Frame position to link with
-		std::vector<AsepritePixelData> PixelDatas;
+		uint16_t Width = 0;
+		uint16_t Height = 0;
+		uint16_t FramePosition = 0; // Frame position to link with
+		std::pmr::vector<AsepritePixelData> PixelDatas;
+		AsepriteTilemap Tilemap; // Only filled in for tilemap cels (CelType 3), Width and Height are in tiles for those
 
 		int order() const
 		{
@@ -522,7 +663,13 @@ namespace ASE
 		AsepriteLayer() = default;
 		AsepriteLayer(int LIndex, int ZIndex)
 			:Layerindex(LIndex), zIndex(ZIndex) {}
+		explicit AsepriteLayer(std::pmr::memory_resource* Resource)
+			:Name(Resource), CelChunks(Resource) {}
 		AsepriteLayer(const AsepriteLayer&) = default;
+		AsepriteLayer(AsepriteLayer&&) = default;
+
+		AsepriteLayer& operator=(const AsepriteLayer&) = default;
+		AsepriteLayer& operator=(AsepriteLayer&&) = default;
 
 		int Layerindex;
 		int zIndex;
@@ -532,18 +679,32 @@ namespace ASE
 		uint16_t Child;
 		uint16_t BlendMode;
 		uint8_t Opacity;
-		std::string Name;
-		std::vector<AsepriteCelChunk> CelChunks;
+		uint32_t TilesetIndex = 0; // ID of the tileset a tilemap layer (Type 2) draws with
+		std::pmr::string Name;
+		uint32_t NameKey = 0; // Name interned in the parser's StringTable, 0 until the sprite is added to a parser
+		std::pmr::vector<AsepriteCelChunk> CelChunks;
 
 	};
 
+	struct AsepriteOldPalettePacket
+	{
+		AsepriteOldPalettePacket() = default;
+		explicit AsepriteOldPalettePacket(std::pmr::memory_resource* Resource)
+			:Colors(Resource) {}
+
+		uint8_t NumOfEntriesToSkip; // Counted from where the previous packet left off
+		std::pmr::vector<uint32_t> Colors; // RGBA, already scaled up to 0-255 for OldPaletteChunk2
+	};
+
 	struct AsepriteOldPaletteChunk
 	{
-		AsepriteChunkType Type;
+		AsepriteOldPaletteChunk() = default;
+		explicit AsepriteOldPaletteChunk(std::pmr::memory_resource* Resource)
+			:Packets(Resource) {}
+
+		AsepriteChunkType Type; // OldPaletteChunk2 (0x0011) stores colors as 0-63 instead of 0-255
 		uint16_t NumOfPackets;
-		uint8_t NumOfPalettesToSkip;
-		uint8_t NumOfColors;
-		std::vector<uint8_t*> Colors;
+		std::pmr::vector<AsepriteOldPalettePacket> Packets;
 
 	};
 
@@ -576,35 +737,74 @@ namespace ASE
 
 	struct AsepriteTagsChunk
 	{
+		AsepriteTagsChunk() = default;
+		explicit AsepriteTagsChunk(std::pmr::memory_resource* Resource)
+			:Tags(Resource) {}
+
 		uint16_t NumOfTags;
-		std::vector<AsepriteTag> Tags;
+		std::pmr::vector<AsepriteTag> Tags;
+	};
+
+	struct AsepritePaletteEntryName
+	{
+		AsepritePaletteEntryName() = default;
+		explicit AsepritePaletteEntryName(std::pmr::memory_resource* Resource)
+			:Name(Resource) {}
+
+		uint32_t Index;
+		std::pmr::string Name;
 	};
 
 	struct AsepritePaletteChunk
 	{
-		uint32_t Size;
+		AsepritePaletteChunk() = default;
+		explicit AsepritePaletteChunk(std::pmr::memory_resource* Resource)
+			:Colors(Resource), Names(Resource) {}
+
+		uint32_t Size; // Size of the whole palette, not how many entries this chunk has
 		uint32_t FirstIndexToChange;
 		uint32_t LastIndexToChange;
-		std::vector<AsepritePixelData> Entries;
+		std::pmr::vector<uint32_t> Colors; // RGBA (R in the low byte), Colors[i] is palette index FirstIndexToChange + i
+		std::pmr::vector<AsepritePaletteEntryName> Names; // Only the few entries that have a name
 	};
 
 	struct AsepriteSliceChunk
 	{
+		AsepriteSliceChunk() = default;
+		explicit AsepriteSliceChunk(std::pmr::memory_resource* Resource)
+			:Name(Resource), Slices(Resource) {}
+
 		uint32_t NumOfSliceKeys;
 		uint32_t Flags;
-		std::string Name;
-		std::vector<AsepriteSliceKey> Slices;
+		std::pmr::string Name;
+		uint32_t NameKey = 0; // Name interned in the parser's StringTable, 0 until the sprite is added to a parser
+		std::pmr::vector<AsepriteSliceKey> Slices; // Keys sorted by FrameNumber
+
+		bool IsNinePatch() const { return (Flags & (uint32_t)AsepriteSliceFlags::NinePatch) != 0; }
+		bool HasPivot() const { return (Flags & (uint32_t)AsepriteSliceFlags::Pivot) != 0; }
 	};
 
 	struct AsepriteChunk
 	{
 	public:
 		AsepriteChunk() = default;
+		explicit AsepriteChunk(std::pmr::memory_resource* Resource)
+			:Data(Resource) {}
 		AsepriteChunk(const AsepriteChunk&) = default;
+		AsepriteChunk(AsepriteChunk&&) = default;
+
+		AsepriteChunk& operator=(const AsepriteChunk&) = default;
+		AsepriteChunk& operator=(AsepriteChunk&&) = default;
 
 		uint32_t Size;
 		AsepriteChunkType Type;
-		std::vector<std::byte> Data;
+		uint64_t Offset = 0; // Where the chunk's body starts in the file
+		std::pmr::vector<std::byte> Data;
+		const std::byte* View = nullptr; // Points into AsepriteFileData::Mapping instead of owning a copy when the file was mapped
+
+		const std::byte* GetData() const { return View ? View : Data.data(); }
+		//Size also counts the 6 bytes of chunk header, this is just the body
+		size_t GetDataSize() const { return Size > 6 ? Size - 6 : 0; }
 	};
 
 	struct AsepriteHeader
@@ -638,7 +838,13 @@ namespace ASE
 	{
 	public:
 		AsepriteFrameData() = default;
+		explicit AsepriteFrameData(std::pmr::memory_resource* Resource)
+			:ChunkData(Resource), Layers(Resource), OldPaletteChunks(Resource), NewPaletteChunks(Resource) {}
 		AsepriteFrameData(const AsepriteFrameData&) = default;
+		AsepriteFrameData(AsepriteFrameData&&) = default;
+
+		AsepriteFrameData& operator=(const AsepriteFrameData&) = default;
+		AsepriteFrameData& operator=(AsepriteFrameData&&) = default;
 		//FrameData
 		uint32_t BytesInFrame;
 		uint16_t MagicNumber = 0xF1FA;
@@ -647,10 +853,13 @@ namespace ASE
 		//two uint8_t which will be 0
 		uint32_t NewNumOfChunks; // If 0 use NumOfChunks
 
-		std::vector<AsepriteChunk> ChunkData;
-		std::vector<AsepriteLayer> Layers;
-		std::vector<AsepriteOldPaletteChunk> OldPaletteChunks;
-		std::vector<AsepritePaletteChunk> NewPaletteChunks;
+		uint64_t Offset = 0; // Where the frame header starts in the file
+		bool CelsLoaded = true; // False until AsepriteParser::LoadFrame reads the cels of a frame parsed with AsepriteParseMode::Lazy
+
+		std::pmr::vector<AsepriteChunk> ChunkData;
+		std::pmr::vector<AsepriteLayer> Layers;
+		std::pmr::vector<AsepriteOldPaletteChunk> OldPaletteChunks;
+		std::pmr::vector<AsepritePaletteChunk> NewPaletteChunks;
 	};
 
 	struct AsepriteFileData
@@ -659,10 +868,86 @@ namespace ASE
 		AsepriteFileData() = default;
 		AsepriteFileData(const AsepriteHeader& HeaderData)
 			:Header(HeaderData) {}
-		AsepriteFileData(const AsepriteFileData&) = default;
+		//Everything parsed out of the file gets allocated from Arena, and is all given back at once when the last copy of Arena goes
+		explicit AsepriteFileData(std::shared_ptr<std::pmr::memory_resource> FileArena)
+			:Arena(std::move(FileArena)), Frames(GetResource()), Tags(GetResource()), Tilesets(GetResource()), Slices(GetResource()) {}
+		//A copy allocates from the default resource and doesn't keep the arena alive
+		AsepriteFileData(const AsepriteFileData& Other)
+			:Header(Other.Header), Frames(Other.Frames), Tags(Other.Tags), Tilesets(Other.Tilesets), Slices(Other.Slices), Mapping(Other.Mapping) {}
+		//Other is left empty. Its containers still allocate from the arena, so it keeps a reference to it until it's destroyed or assigned
+		AsepriteFileData(AsepriteFileData&& Other) noexcept
+			:Arena(Other.Arena), Header(Other.Header), Frames(std::move(Other.Frames)), Tags(std::move(Other.Tags)),
+			Tilesets(std::move(Other.Tilesets)), Slices(std::move(Other.Slices)), Mapping(std::move(Other.Mapping))
+		{
+			Other.Clear();
+		}
+
+		//Everything that can throw happens on the copy, so if it does this file is left as it was
+		AsepriteFileData& operator=(const AsepriteFileData& Other)
+		{
+			if (this != &Other)
+			{
+				AsepriteFileData Copy(Other);
+				*this = std::move(Copy);
+			}
+			return *this;
+		}
+		//Containers can only hand their memory over when they allocate from the same resource, so that's a swap.
+		//Otherwise this file is rebuilt around Other's arena, which is safe since nothing in the move constructor can throw. Other is left empty either way
+		AsepriteFileData& operator=(AsepriteFileData&& Other) noexcept
+		{
+			static_assert(std::is_nothrow_move_constructible<AsepriteFileData>::value, "Rebuilding in place relies on the move constructor never throwing");
+			if (this == &Other)
+			{
+				return *this;
+			}
+
+			if (GetResource() == Other.GetResource())
+			{
+				Swap(Other);
+				Other.Clear();
+			}
+			else
+			{
+				this->~AsepriteFileData();
+				new (this) AsepriteFileData(std::move(Other));
+			}
+			return *this;
+		}
+
+		//Only for files allocating from the same resource, swapping containers that don't is undefined
+		void Swap(AsepriteFileData& Other) noexcept
+		{
+			std::swap(Arena, Other.Arena);
+			std::swap(Header, Other.Header);
+			Frames.swap(Other.Frames);
+			Tags.swap(Other.Tags);
+			Tilesets.swap(Other.Tilesets);
+			Slices.swap(Other.Slices);
+			Mapping.swap(Other.Mapping);
+		}
+
+		//Empties the file but keeps the resource its containers allocate from
+		void Clear() noexcept
+		{
+			Header = AsepriteHeader();
+			Frames.clear();
+			Tags.clear();
+			Tilesets.clear();
+			Slices.clear();
+			Mapping.reset();
+		}
+
+		//Where anything added to this file should allocate from, the default resource unless it was parsed with AsepriteParseMode::Arena
+		std::pmr::memory_resource* GetResource() const { return Arena ? Arena.get() : std::pmr::get_default_resource(); }
 
+		std::shared_ptr<std::pmr::memory_resource> Arena; // Declared first so it outlives everything allocated from it
 		AsepriteHeader Header;
-		std::vector<AsepriteFrameData> Frames;
+		std::pmr::vector<AsepriteFrameData> Frames;
+		std::pmr::vector<AsepriteTag> Tags; // Aseprite writes the tags chunk once, in the first frame
+		std::pmr::vector<AsepriteTileset> Tilesets;
+		std::pmr::vector<AsepriteSliceChunk> Slices;
+		std::shared_ptr<MappedFile> Mapping; // Only set when the file was mapped (every mode but Stream), keeps chunk and cel views alive
 
 	};
 	
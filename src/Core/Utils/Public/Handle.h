@@ -0,0 +1,123 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+namespace ASE
+{
+	//Index into a SlotMap plus the generation of the slot when the handle was made. Once the slot is removed its generation moves on,
+	//so an old handle stops finding anything instead of finding whatever took the slot after it. Tag only keeps different kinds of handle apart
+	template<typename Tag>
+	struct Handle
+	{
+		static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+		uint32_t Index = InvalidIndex;
+		uint32_t Generation = 0;
+
+		bool IsValid() const { return Index != InvalidIndex; }
+		explicit operator bool() const { return IsValid(); }
+		bool operator==(const Handle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+		bool operator!=(const Handle& Other) const { return !(*this == Other); }
+	};
+
+	//Handle to something owned by whatever Parent points at, a layer of a sprite for instance. It goes stale along with its parent
+	template<typename Tag, typename ParentHandle>
+	struct ChildHandle
+	{
+		ParentHandle Parent;
+		uint32_t Index = ParentHandle::InvalidIndex;
+
+		bool IsValid() const { return Parent.IsValid() && Index != ParentHandle::InvalidIndex; }
+		explicit operator bool() const { return IsValid(); }
+		bool operator==(const ChildHandle& Other) const { return Parent == Other.Parent && Index == Other.Index; }
+		bool operator!=(const ChildHandle& Other) const { return !(*this == Other); }
+	};
+
+	//Values looked up by a Handle in constant time. Removed slots are reused by later inserts with their generation bumped
+	template<typename T, typename HandleType>
+	class SlotMap
+	{
+	public:
+		HandleType Insert(T&& Value)
+		{
+			uint32_t Index;
+			if (!m_Free.empty())
+			{
+				Index = m_Free.back();
+				m_Free.pop_back();
+				m_Slots[Index].Value = std::move(Value);
+			}
+			else
+			{
+				Index = (uint32_t)m_Slots.size();
+				m_Slots.push_back({ std::move(Value), 0, false });
+			}
+			m_Slots[Index].Alive = true;
+			m_Count++;
+			return { Index, m_Slots[Index].Generation };
+		}
+
+		//The value goes as well, false if Id was already stale
+		bool Remove(HandleType Id)
+		{
+			if (!Contains(Id))
+			{
+				return false;
+			}
+			Slot& S = m_Slots[Id.Index];
+			S.Value = T();
+			S.Alive = false;
+			S.Generation++;
+			m_Free.push_back(Id.Index);
+			m_Count--;
+			return true;
+		}
+
+		bool Contains(HandleType Id) const
+		{
+			return Id.Index < m_Slots.size() && m_Slots[Id.Index].Alive && m_Slots[Id.Index].Generation == Id.Generation;
+		}
+
+		//Null if Id is stale
+		T* Get(HandleType Id) { return Contains(Id) ? &m_Slots[Id.Index].Value : nullptr; }
+		const T* Get(HandleType Id) const { return Contains(Id) ? &m_Slots[Id.Index].Value : nullptr; }
+
+		size_t GetSize() const { return m_Count; }
+
+		//Fn(HandleType, T&) for every live value
+		template<typename Fn>
+		void ForEach(Fn&& Visit)
+		{
+			for (uint32_t i = 0; i < m_Slots.size(); i++)
+			{
+				if (m_Slots[i].Alive)
+				{
+					Visit(HandleType{ i, m_Slots[i].Generation }, m_Slots[i].Value);
+				}
+			}
+		}
+
+	private:
+		struct Slot
+		{
+			T Value;
+			uint32_t Generation;
+			bool Alive;
+		};
+
+		std::vector<Slot> m_Slots;
+		std::vector<uint32_t> m_Free;
+		size_t m_Count = 0;
+	};
+}
+
+namespace std
+{
+	template<typename Tag>
+	struct hash<ASE::Handle<Tag>>
+	{
+		size_t operator()(const ASE::Handle<Tag>& H) const { return std::hash<uint64_t>()(((uint64_t)H.Generation << 32) | H.Index); }
+	};
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace ASE
+{
+	namespace Utils
+	{
+		//64 bit non-cryptographic hash (the xxHash64 algorithm), for telling apart blobs of bytes quickly, not for anything security related
+		inline uint64_t Hash64(const void* Data, size_t Size, uint64_t Seed = 0)
+		{
+			constexpr uint64_t Prime1 = 11400714785074694791ULL;
+			constexpr uint64_t Prime2 = 14029467366897019727ULL;
+			constexpr uint64_t Prime3 = 1609587929392839161ULL;
+			constexpr uint64_t Prime4 = 9650029242287828579ULL;
+			constexpr uint64_t Prime5 = 2870177450012600261ULL;
+
+			auto Rotl = [](uint64_t V, int Bits) { return (V << Bits) | (V >> (64 - Bits)); };
+			auto Read64 = [](const uint8_t* P) { uint64_t V; memcpy(&V, P, sizeof(V)); return V; };
+			auto Read32 = [](const uint8_t* P) { uint32_t V; memcpy(&V, P, sizeof(V)); return V; };
+			auto Round = [&](uint64_t Acc, uint64_t Input) { return Rotl(Acc + Input * Prime2, 31) * Prime1; };
+			auto Merge = [&](uint64_t Acc, uint64_t V) { return (Acc ^ Round(0, V)) * Prime1 + Prime4; };
+
+			const uint8_t* P = (const uint8_t*)Data;
+			const uint8_t* End = P + Size;
+			uint64_t H;
+
+			if (Size >= 32)
+			{
+				//Four independent lanes so the multiplies overlap
+				uint64_t V1 = Seed + Prime1 + Prime2;
+				uint64_t V2 = Seed + Prime2;
+				uint64_t V3 = Seed;
+				uint64_t V4 = Seed - Prime1;
+				for (; P + 32 <= End; P += 32)
+				{
+					V1 = Round(V1, Read64(P));
+					V2 = Round(V2, Read64(P + 8));
+					V3 = Round(V3, Read64(P + 16));
+					V4 = Round(V4, Read64(P + 24));
+				}
+				H = Rotl(V1, 1) + Rotl(V2, 7) + Rotl(V3, 12) + Rotl(V4, 18);
+				H = Merge(H, V1);
+				H = Merge(H, V2);
+				H = Merge(H, V3);
+				H = Merge(H, V4);
+			}
+			else
+			{
+				H = Seed + Prime5;
+			}
+
+			H += (uint64_t)Size;
+			for (; P + 8 <= End; P += 8)
+			{
+				H = Rotl(H ^ Round(0, Read64(P)), 27) * Prime1 + Prime4;
+			}
+			if (P + 4 <= End)
+			{
+				H = Rotl(H ^ (Read32(P) * Prime1), 23) * Prime2 + Prime3;
+				P += 4;
+			}
+			for (; P < End; P++)
+			{
+				H = Rotl(H ^ (*P * Prime5), 11) * Prime1;
+			}
+
+			H ^= H >> 33;
+			H *= Prime2;
+			H ^= H >> 29;
+			H *= Prime3;
+			H ^= H >> 32;
+			return H;
+		}
+	}
+}
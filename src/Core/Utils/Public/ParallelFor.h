@@ -0,0 +1,177 @@
+#pragma once
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <type_traits>
+#include <condition_variable>
+
+namespace ASE
+{
+	namespace Utils
+	{
+		//Number of workers to use when the caller passes 0
+		inline uint32_t GetDefaultThreadCount()
+		{
+			return std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		//One ParallelFor call. Whoever claims an index runs it and counts it as done, the caller waits until every index is done
+		struct ParallelJob
+		{
+			size_t Count = 0;
+			void (*Call)(void*, size_t) = nullptr;
+			void* Func = nullptr;
+
+			std::atomic<size_t> Next = 0;
+			std::atomic<size_t> Done = 0;
+			std::atomic<bool> Failed = false;
+			std::exception_ptr Error; // First exception a task threw, only written by whoever set Failed
+
+			std::mutex Mutex;
+			std::condition_variable Finished;
+
+			//Runs indices until there are none left. Once something has thrown the rest are only counted, not run
+			void Work()
+			{
+				for (size_t i = Next++; i < Count; i = Next++)
+				{
+					if (!Failed)
+					{
+						try
+						{
+							Call(Func, i);
+						}
+						catch (...)
+						{
+							if (!Failed.exchange(true))
+							{
+								Error = std::current_exception();
+							}
+						}
+					}
+
+					if (++Done == Count)
+					{
+						std::lock_guard<std::mutex> Lock(Mutex);
+						Finished.notify_all();
+					}
+				}
+			}
+
+			void Wait()
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				Finished.wait(Lock, [this]() { return Done == Count; });
+			}
+		};
+
+		//Worker threads kept around for every ParallelFor, one less than the hardware threads since the caller always works too.
+		//Started on first use and never torn down, like the PixelBufferPool
+		class ThreadPool
+		{
+		public:
+			static ThreadPool& Get()
+			{
+				static ThreadPool* Pool = new ThreadPool(GetDefaultThreadCount() - 1);
+				return *Pool;
+			}
+
+			uint32_t GetWorkerCount() const { return (uint32_t)m_Workers.size(); }
+
+			//Lets up to Helpers workers join in on the job. A worker that only gets to it after it's finished finds no indices left
+			//and drops it, the shared_ptr keeps the job alive until then
+			void Submit(const std::shared_ptr<ParallelJob>& Job, uint32_t Helpers)
+			{
+				{
+					std::lock_guard<std::mutex> Lock(m_Mutex);
+					for (uint32_t h = 0; h < Helpers; h++)
+					{
+						m_Queue.push_back(Job);
+					}
+				}
+				if (Helpers == 1)
+				{
+					m_Wake.notify_one();
+				}
+				else
+				{
+					m_Wake.notify_all();
+				}
+			}
+
+		private:
+			explicit ThreadPool(uint32_t WorkerCount)
+			{
+				for (uint32_t t = 0; t < WorkerCount; t++)
+				{
+					m_Workers.emplace_back([this]() { Run(); });
+				}
+			}
+
+			void Run()
+			{
+				for (;;)
+				{
+					std::shared_ptr<ParallelJob> Job;
+					{
+						std::unique_lock<std::mutex> Lock(m_Mutex);
+						m_Wake.wait(Lock, [this]() { return !m_Queue.empty(); });
+						Job = std::move(m_Queue.front());
+						m_Queue.pop_front();
+					}
+					Job->Work();
+				}
+			}
+
+			std::mutex m_Mutex;
+			std::condition_variable m_Wake;
+			std::deque<std::shared_ptr<ParallelJob>> m_Queue;
+			std::vector<std::thread> m_Workers;
+		};
+
+		//Calls Func(i) for every i in [0, Count) on up to ThreadCount threads (0 uses every hardware thread).
+		//Indices are handed out one at a time through an atomic counter so uneven jobs still balance out.
+		//The calling thread does work too, so a ThreadCount of 1 never touches the pool, and it keeps working until its own job is done,
+		//which is what lets a Func call ParallelFor again without running out of workers.
+		//If a call throws, the indices nobody has started yet are skipped and the first exception is rethrown here once everything has stopped
+		template<typename Fn>
+		void ParallelFor(size_t Count, uint32_t ThreadCount, Fn&& Func)
+		{
+			if (ThreadCount == 0)
+			{
+				ThreadCount = GetDefaultThreadCount();
+			}
+			ThreadCount = (uint32_t)std::min<size_t>(ThreadCount, Count);
+
+			if (ThreadCount <= 1)
+			{
+				for (size_t i = 0; i < Count; i++)
+				{
+					Func(i);
+				}
+				return;
+			}
+
+			using FnType = std::remove_reference_t<Fn>;
+			auto Job = std::make_shared<ParallelJob>();
+			Job->Count = Count;
+			Job->Func = (void*)std::addressof(Func);
+			Job->Call = [](void* F, size_t i) { (*static_cast<FnType*>(F))(i); };
+
+			ThreadPool& Pool = ThreadPool::Get();
+			Pool.Submit(Job, std::min(ThreadCount - 1, Pool.GetWorkerCount()));
+			Job->Work();
+			Job->Wait();
+
+			if (Job->Error)
+			{
+				std::rethrow_exception(Job->Error);
+			}
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <unordered_map>
+
+namespace ASE
+{
+	//Index of a string in a StringTable. Two names are the same string exactly when their NameIds are equal, 0 is the empty string
+	using NameId = uint32_t;
+
+	//Keeps one copy of every distinct string it's given and hands out a small integer for it, so names can be compared and looked up
+	//as integers and only ever get hashed once, when they're first interned. Strings never move once added, references to them stay good
+	class StringTable
+	{
+	public:
+		StringTable()
+		{
+			Intern("");
+		}
+		//The map holds views into m_Strings, so a copy has to build its own rather than point at the other table's strings
+		StringTable(const StringTable& Other)
+		{
+			*this = Other;
+		}
+		StringTable& operator=(const StringTable& Other)
+		{
+			if (this != &Other)
+			{
+				m_Strings = Other.m_Strings;
+				m_Lookup.clear();
+				for (size_t i = 0; i < m_Strings.size(); i++)
+				{
+					m_Lookup.emplace(std::string_view(m_Strings[i]), (NameId)i);
+				}
+			}
+			return *this;
+		}
+
+		//The NameId for String, adding it if it isn't in the table yet
+		NameId Intern(std::string_view String)
+		{
+			auto It = m_Lookup.find(String);
+			if (It != m_Lookup.end())
+			{
+				return It->second;
+			}
+
+			NameId Id = (NameId)m_Strings.size();
+			m_Strings.emplace_back(String);
+			m_Lookup.emplace(std::string_view(m_Strings.back()), Id);
+			return Id;
+		}
+
+		//Like Intern but never adds, 0 if String has never been interned (or is empty)
+		NameId Find(std::string_view String) const
+		{
+			auto It = m_Lookup.find(String);
+			return It == m_Lookup.end() ? 0 : It->second;
+		}
+
+		const std::string& Get(NameId Id) const { return m_Strings[Id < m_Strings.size() ? Id : 0]; }
+		size_t GetSize() const { return m_Strings.size(); }
+
+	private:
+		std::deque<std::string> m_Strings;
+		std::unordered_map<std::string_view, NameId> m_Lookup;
+	};
+}
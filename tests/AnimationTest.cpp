@@ -0,0 +1,138 @@
+// Plays AnimationClips and an AnimationPlayer against the frame sequences Aseprite shows for each loop direction and repeat count,
+// with frames that all last the same time and frames that don't.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include tests/AnimationTest.cpp -o AnimationTest -lz
+// Usage:
+//   AnimationTest
+
+#include <vector>
+#include "Core/Log/Public/Log.h"
+#include "Core/Animation/Public/AnimationPlayer.h"
+#include "Check.h"
+
+namespace
+{
+	using ASE::AsepriteLoopDirection;
+
+	struct Case
+	{
+		const char* Name;
+		AsepriteLoopDirection Direction;
+		uint16_t RepeatTimes;
+		std::vector<uint16_t> Frames; // Every frame shown for clips that stop, the first few trips for loops
+	};
+
+	//Tag 1-4 of a 6 frame file
+	const Case Cases[] = {
+		{ "Forward", AsepriteLoopDirection::Forward, 0, { 1, 2, 3, 4, 1, 2, 3, 4, 1, 2 } },
+		{ "Reverse", AsepriteLoopDirection::Reverse, 0, { 4, 3, 2, 1, 4, 3, 2, 1, 4 } },
+		{ "PingPong", AsepriteLoopDirection::PingPong, 0, { 1, 2, 3, 4, 3, 2, 1, 2, 3, 4, 3, 2, 1, 2 } },
+		{ "PingPongReverse", AsepriteLoopDirection::PingPongReverse, 0, { 4, 3, 2, 1, 2, 3, 4, 3, 2, 1, 2, 3 } },
+		{ "Forward x2", AsepriteLoopDirection::Forward, 2, { 1, 2, 3, 4, 1, 2, 3, 4 } },
+		{ "Reverse x1", AsepriteLoopDirection::Reverse, 1, { 4, 3, 2, 1 } },
+		{ "PingPong x1", AsepriteLoopDirection::PingPong, 1, { 1, 2, 3, 4 } },
+		{ "PingPong x2", AsepriteLoopDirection::PingPong, 2, { 1, 2, 3, 4, 3, 2, 1 } },
+		{ "PingPong x3", AsepriteLoopDirection::PingPong, 3, { 1, 2, 3, 4, 3, 2, 1, 2, 3, 4 } },
+		{ "PingPongReverse x2", AsepriteLoopDirection::PingPongReverse, 2, { 4, 3, 2, 1, 2, 3, 4 } },
+	};
+
+	//Looks up the middle of every frame in the sequence, then past the end for clips that stop
+	void CheckClip(const Case& C, const std::vector<uint16_t>& Durations)
+	{
+		ASE::AnimationClip Clip(Durations, 1, 4, C.Direction, C.RepeatTimes);
+		ASE_CHECK(Clip.IsValid());
+		ASE_CHECK_EQ(Clip.IsLooping(), C.RepeatTimes == 0);
+
+		float Start = 0.0f;
+		for (size_t i = 0; i < C.Frames.size(); i++)
+		{
+			float Duration = Durations[C.Frames[i]];
+			if (!ASE_CHECK_EQ(Clip.GetFrame(Start + Duration / 2), C.Frames[i]))
+			{
+				printf("  %s, frame %zu of the sequence\n", C.Name, i);
+			}
+			Start += Duration;
+		}
+
+		if (C.RepeatTimes != 0)
+		{
+			ASE_CHECK_EQ(Clip.GetDuration(), Start);
+			ASE_CHECK(!Clip.IsFinished(Start - 1.0f));
+			ASE_CHECK(Clip.IsFinished(Start));
+			ASE_CHECK_EQ(Clip.GetFrame(Start * 10), C.Frames.back());
+		}
+	}
+
+	//Instances at different speeds stay on the frame their clip says for the time they've played, however the time is cut up
+	void CheckPlayer(const std::vector<uint16_t>& Durations)
+	{
+		ASE::AnimationPlayer Player;
+		uint32_t Loop = Player.AddClip(ASE::AnimationClip(Durations, 1, 4, AsepriteLoopDirection::PingPong));
+		uint32_t Once = Player.AddClip(ASE::AnimationClip(Durations, 1, 4, AsepriteLoopDirection::Forward, 2));
+
+		const float Speeds[] = { 1.0f, 2.0f, 0.5f, 0.0f };
+		for (float Speed : Speeds)
+		{
+			Player.Play(Loop, Speed);
+			Player.Play(Once, Speed);
+		}
+
+		float Elapsed = 0.0f;
+		for (int Step = 0; Step < 400; Step++)
+		{
+			//Steps that don't line up with frame boundaries
+			float Delta = 7.0f + (Step % 5);
+			Player.Update(Delta);
+			Elapsed += Delta;
+
+			for (uint32_t i = 0; i < Player.GetInstanceCount(); i++)
+			{
+				const ASE::AnimationClip& Clip = Player.GetClip(i % 2 == 0 ? Loop : Once);
+				float Time = Elapsed * Speeds[i / 2];
+				if (!ASE_CHECK_EQ(Player.GetFrame(i), Clip.GetFrame(Time)))
+				{
+					printf("  instance %u at %gms\n", i, Time);
+				}
+			}
+		}
+		ASE_CHECK(Player.IsFinished(1));
+		ASE_CHECK(!Player.IsFinished(0));
+		ASE_CHECK_EQ(Player.GetFrame(7), 1); // Paused on its first frame
+
+		//Removing moves the last instance into the gap
+		uint16_t Last = Player.GetFrame(7);
+		Player.Remove(2);
+		ASE_CHECK_EQ(Player.GetInstanceCount(), 7);
+		ASE_CHECK_EQ(Player.GetFrame(2), Last);
+	}
+}
+
+int main()
+{
+	ASE::Log::Init();
+
+	const std::vector<uint16_t> Uniform = { 100, 100, 100, 100, 100, 100 };
+	const std::vector<uint16_t> Varied = { 50, 100, 150, 200, 250, 300 };
+
+	for (const Case& C : Cases)
+	{
+		CheckClip(C, Uniform);
+		CheckClip(C, Varied);
+	}
+
+	//A one frame tag shows that frame whatever the direction
+	ASE::AnimationClip Single(Uniform, 2, 2, AsepriteLoopDirection::PingPong);
+	ASE_CHECK_EQ(Single.GetFrame(0.0f), 2);
+	ASE_CHECK_EQ(Single.GetFrame(12345.0f), 2);
+
+	//Times far past the start still land on the right frame of a loop
+	ASE::AnimationClip Loop(Varied, 1, 4, AsepriteLoopDirection::PingPong);
+	float Cycle = 150.0f + 200.0f + 250.0f + 200.0f + 150.0f + 100.0f; // 2 3 4 3 2 1
+	ASE_CHECK_EQ(Loop.GetFrame(100.0f + Cycle * 1000.0f + 10.0f), 2);
+
+	CheckPlayer(Uniform);
+	CheckPlayer(Varied);
+
+	return ASE::Test::Finish("AnimationTest");
+}
@@ -0,0 +1,255 @@
+// Packs a few sprites into an atlas and checks every packed frame sits on its page without overlapping another, that the page pixels
+// are the frame's, that duplicate and empty frames are handled, and that slice keys point where NineSlice::Build would draw from.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include tests/AtlasTest.cpp -o AtlasTest -lz
+// Usage:
+//   AtlasTest
+
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <filesystem>
+#include "Core/Log/Public/Log.h"
+#include "Core/Image/Public/Parser.h"
+#include "Core/Image/Public/FrameSet.h"
+#include "Core/Image/Public/NineSlice.h"
+#include "Core/Image/Public/AtlasBuilder.h"
+#include "Check.h"
+#include "TestSprite.h"
+
+namespace
+{
+	bool Near(float A, float B)
+	{
+		return std::fabs(A - B) < 0.0001f;
+	}
+
+	//Frames 0 and 2 look the same, frame 3 is empty and the slice has a key on each of them and one past the end
+	void WriteHero(const std::filesystem::path& Path)
+	{
+		ASE::Test::TestSpriteWriter Writer(24, 20);
+		Writer.AddLayer("Body");
+		Writer.AddLayer("Eye");
+		Writer.AddFrame(100);
+		Writer.AddCel(0, 3, 2, 10, 12, 0xFF3060C0);
+		Writer.AddCel(1, 5, 4, 2, 2, 0xFFFFFFFF);
+		Writer.AddFrame(150);
+		Writer.AddCel(0, 8, 5, 14, 9, 0xFF30C060);
+		Writer.AddFrame(100);
+		Writer.AddCel(0, 3, 2, 10, 12, 0xFF3060C0);
+		Writer.AddCel(1, 5, 4, 2, 2, 0xFFFFFFFF);
+		Writer.AddFrame(200);
+		Writer.AddTag("Walk", 0, 2, 2, 1);
+		Writer.AddSlice("Button", 1, { { 0, 3, 2, 10, 12, 2, 2, 6, 8 }, { 1, 8, 5, 14, 9, 3, 3, 8, 3 }, { 3, 0, 0, 4, 4 }, { 9, 0, 0, 4, 4 } });
+		Writer.Write(Path);
+	}
+
+	void WriteBlock(const std::filesystem::path& Path, uint16_t Size, uint32_t Color)
+	{
+		ASE::Test::TestSpriteWriter Writer(Size, Size);
+		Writer.AddLayer("Block");
+		Writer.AddFrame();
+		Writer.AddCel(0, 0, 0, Size, Size, Color);
+		Writer.Write(Path);
+	}
+
+	//Packed frames, with the padding after them, stay on their page and off each other
+	void CheckPlacement(const ASE::AtlasBuilder& Atlas, uint32_t Padding)
+	{
+		struct Placed
+		{
+			uint16_t Page;
+			uint32_t X0, Y0, X1, Y1;
+		};
+		std::vector<Placed> Rects;
+		for (auto& Sprite : Atlas.GetSprites())
+		{
+			for (auto& Rect : Sprite.Frames)
+			{
+				if (Rect.Width == 0)
+				{
+					continue;
+				}
+				const ASE::AtlasPage& Page = Atlas.GetPages()[Rect.Page];
+				ASE_CHECK(Rect.X + Rect.Width <= Page.Width && Rect.Y + Rect.Height <= Page.Height);
+				ASE_CHECK(Near(Rect.U0, (float)Rect.X / Page.Width) && Near(Rect.U1, (float)(Rect.X + Rect.Width) / Page.Width));
+				ASE_CHECK(Near(Rect.V0, (float)Rect.Y / Page.Height) && Near(Rect.V1, (float)(Rect.Y + Rect.Height) / Page.Height));
+
+				//Duplicate frames share a rect, they only need checking once
+				bool Seen = false;
+				for (auto& Other : Rects)
+				{
+					Seen |= Other.Page == Rect.Page && Other.X0 == Rect.X && Other.Y0 == Rect.Y;
+				}
+				if (!Seen)
+				{
+					Rects.push_back({ Rect.Page, Rect.X, Rect.Y, Rect.X + Rect.Width + Padding, Rect.Y + Rect.Height + Padding });
+				}
+			}
+		}
+
+		size_t Overlaps = 0;
+		for (size_t a = 0; a < Rects.size(); a++)
+		{
+			for (size_t b = a + 1; b < Rects.size(); b++)
+			{
+				const Placed& A = Rects[a];
+				const Placed& B = Rects[b];
+				Overlaps += A.Page == B.Page && A.X0 < B.X1 && B.X0 < A.X1 && A.Y0 < B.Y1 && B.Y0 < A.Y1;
+			}
+		}
+		ASE_CHECK_EQ(Overlaps, 0);
+	}
+
+	//Every pixel of the untrimmed frame is either on the page where its rect says or was trimmed off for being transparent
+	void CheckPixels(const ASE::AtlasBuilder& Atlas, const ASE::AtlasSprite& Sprite, const ASE::FrameSet& Frames)
+	{
+		ASE_CHECK_EQ(Sprite.Width, Frames.GetWidth());
+		ASE_CHECK_EQ(Sprite.Height, Frames.GetHeight());
+		ASE_CHECK_EQ(Sprite.Frames.size(), Frames.GetFrameCount());
+		for (uint16_t f = 0; f < Frames.GetFrameCount() && f < Sprite.Frames.size(); f++)
+		{
+			ASE_CHECK_EQ(Sprite.Durations[f], Frames.GetFrameDuration(f));
+			const ASE::AtlasRect& Rect = Sprite.Frames[f];
+			const uint32_t* Pixels = Frames.GetFrame(f);
+			size_t Mismatches = 0;
+			for (uint32_t y = 0; y < Frames.GetHeight(); y++)
+			{
+				for (uint32_t x = 0; x < Frames.GetWidth(); x++)
+				{
+					uint32_t Expected = Pixels[(size_t)y * Frames.GetWidth() + x];
+					int32_t TrimmedX = (int32_t)x - Rect.OffsetX;
+					int32_t TrimmedY = (int32_t)y - Rect.OffsetY;
+					if (TrimmedX < 0 || TrimmedY < 0 || TrimmedX >= (int32_t)Rect.Width || TrimmedY >= (int32_t)Rect.Height)
+					{
+						Mismatches += (Expected >> 24) != 0;
+						continue;
+					}
+					const ASE::AtlasPage& Page = Atlas.GetPages()[Rect.Page];
+					Mismatches += Page.Pixels[(size_t)(Rect.Y + TrimmedY) * Page.Width + Rect.X + TrimmedX] != Expected;
+				}
+			}
+			if (!ASE_CHECK_EQ(Mismatches, 0))
+			{
+				printf("  %s frame %u\n", Sprite.Name.c_str(), f);
+			}
+		}
+	}
+
+	//Each key's bounds are the outside of the quads NineSlice::Build gives with the key's frame position and page size
+	void CheckSlices(const ASE::AtlasBuilder& Atlas, const ASE::AtlasSprite& Sprite)
+	{
+		const ASE::AtlasSlice* Button = Sprite.FindSlice("Button");
+		ASE_CHECK(Button);
+		if (!Button)
+		{
+			return;
+		}
+		ASE_CHECK_EQ(Button->Keys.size(), Button->Slice.Slices.size());
+
+		for (size_t k = 0; k < 2; k++)
+		{
+			const ASE::AsepriteSliceKey& Key = Button->Slice.Slices[k];
+			const ASE::AtlasSliceKey& Placed = Button->Keys[k];
+			const ASE::AtlasRect& Rect = Sprite.Frames[Key.FrameNumber];
+			const ASE::AtlasPage& Page = Atlas.GetPages()[Placed.Page];
+			ASE_CHECK_EQ(Placed.Page, Rect.Page);
+			ASE_CHECK_EQ(Placed.FrameX, (int32_t)Rect.X - Rect.OffsetX);
+			ASE_CHECK_EQ(Placed.FrameY, (int32_t)Rect.Y - Rect.OffsetY);
+
+			ASE::NineSliceQuads Quads = ASE::NineSlice::Build(Button->Slice, Key, 0.0f, 0.0f, 40.0f, 40.0f, Page.Width, Page.Height, Placed.FrameX, Placed.FrameY);
+			ASE_CHECK_EQ(Quads.Count, 9);
+			ASE_CHECK(Near(Quads.Quads[0].U0, Placed.U0) && Near(Quads.Quads[0].V0, Placed.V0));
+			ASE_CHECK(Near(Quads.Quads[8].U1, Placed.U1) && Near(Quads.Quads[8].V1, Placed.V1));
+
+			//These keys cover exactly the frame's opaque body, so the slice's corner is the body's colour
+			uint32_t Corner = Page.Pixels[(size_t)(Placed.FrameY + Key.SliceY) * Page.Width + Placed.FrameX + Key.SliceX];
+			ASE_CHECK_EQ(Corner, k == 0 ? 0xFF3060C0 : 0xFF30C060);
+		}
+
+		//The key on the empty frame and the one past the last frame are left empty
+		ASE_CHECK(Button->Keys[2].U0 == 0.0f && Button->Keys[2].U1 == 0.0f);
+		ASE_CHECK(Button->Keys[3].U0 == 0.0f && Button->Keys[3].U1 == 0.0f);
+	}
+}
+
+int main()
+{
+	ASE::Log::Init();
+	std::filesystem::path Directory = std::filesystem::temp_directory_path() / "ase_atlas_test";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	WriteHero(Directory / "Hero.aseprite");
+	const uint16_t BlockSizes[] = { 30, 17, 8, 8, 5, 23, 1 };
+	for (size_t b = 0; b < std::size(BlockSizes); b++)
+	{
+		WriteBlock(Directory / ("Block" + std::to_string(b) + ".aseprite"), BlockSizes[b], 0xFF000000 | (uint32_t)(b * 0x112233));
+	}
+
+	//Loading moves the sprites already loaded, so everything is loaded before holding on to any of them
+	ASE::AsepriteParser Parser;
+	ASE::SpriteId HeroId = Parser.ReadData(Directory / "Hero.aseprite");
+	std::vector<ASE::SpriteId> BlockIds;
+	for (size_t b = 0; b < std::size(BlockSizes); b++)
+	{
+		BlockIds.push_back(Parser.ReadData(Directory / ("Block" + std::to_string(b) + ".aseprite")));
+	}
+	const ASE::AsepriteFileData* Hero = Parser.GetFileData(HeroId);
+	ASE_CHECK(Hero);
+	if (!Hero)
+	{
+		return ASE::Test::Finish("AtlasTest");
+	}
+	ASE::FrameSet HeroFrames(*Hero);
+
+	//Big enough for everything on one page, then small enough that it takes several
+	for (uint32_t PageSize : { 256u, 32u })
+	{
+		ASE::AtlasBuilder Atlas(PageSize, 1);
+		Atlas.AddSprite("Hero", *Hero);
+		std::vector<ASE::FrameSet> Blocks;
+		for (size_t b = 0; b < std::size(BlockSizes); b++)
+		{
+			const ASE::AsepriteFileData* Block = Parser.GetFileData(BlockIds[b]);
+			Atlas.AddSprite("Block" + std::to_string(b), *Block);
+			Blocks.emplace_back(*Block);
+		}
+		ASE_CHECK(Atlas.Build());
+		ASE_CHECK(PageSize == 256 ? Atlas.GetPages().size() == 1 : Atlas.GetPages().size() > 1);
+		for (auto& Page : Atlas.GetPages())
+		{
+			ASE_CHECK(Page.Width <= PageSize && Page.Height <= PageSize);
+			ASE_CHECK((Page.Width & (Page.Width - 1)) == 0 && (Page.Height & (Page.Height - 1)) == 0);
+		}
+		CheckPlacement(Atlas, 1);
+
+		const ASE::AtlasSprite& Sprite = *Atlas.GetSprite("Hero");
+		CheckPixels(Atlas, Sprite, HeroFrames);
+		for (size_t b = 0; b < Blocks.size(); b++)
+		{
+			CheckPixels(Atlas, *Atlas.GetSprite("Block" + std::to_string(b)), Blocks[b]);
+		}
+
+		//Frame 2 is frame 0 again and shares its rect, frame 3 is empty and wasn't packed
+		ASE_CHECK(Sprite.Frames[2].X == Sprite.Frames[0].X && Sprite.Frames[2].Y == Sprite.Frames[0].Y && Sprite.Frames[2].Page == Sprite.Frames[0].Page);
+		ASE_CHECK_EQ(Sprite.Frames[0].Width, 10);
+		ASE_CHECK_EQ(Sprite.Frames[0].OffsetX, 3);
+		ASE_CHECK_EQ(Sprite.Frames[3].Width, 0);
+
+		ASE_CHECK_EQ(Sprite.Tags.size(), 1);
+		ASE_CHECK(Sprite.Tags[0].Name == "Walk" && Sprite.Tags[0].ToFrame == 2 && Sprite.Tags[0].LoopDirection == 2 && Sprite.Tags[0].RepeatTimes == 1);
+		CheckSlices(Atlas, Sprite);
+	}
+
+	//A frame bigger than a page fails the build but everything else is still packed
+	ASE::AtlasBuilder Small(16, 1);
+	Small.AddSprite("Hero", *Hero);
+	Small.AddSprite("Block0", *Parser.GetFileData(BlockIds[0]));
+	ASE_CHECK(!Small.Build());
+	ASE_CHECK_EQ(Small.GetSprite("Block0")->Frames[0].Width, 0);
+	CheckPixels(Small, *Small.GetSprite("Hero"), HeroFrames);
+
+	std::filesystem::remove_all(Directory);
+	return ASE::Test::Finish("AtlasTest");
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdio>
+
+// Just enough of a test framework for the programs in this folder: ASE_CHECK records a failure and carries on,
+// ASE_CHECK_EQ prints both sides as integers, and main returns ASE::Test::Finish() so a failed check fails the run.
+
+namespace ASE
+{
+	namespace Test
+	{
+		struct Counts
+		{
+			int Checks = 0;
+			int Failures = 0;
+		};
+
+		inline Counts& GetCounts()
+		{
+			static Counts C;
+			return C;
+		}
+
+		inline bool Record(bool Passed, const char* File, int Line, const char* Expr)
+		{
+			GetCounts().Checks++;
+			if (!Passed)
+			{
+				GetCounts().Failures++;
+				printf("%s:%d: check failed: %s\n", File, Line, Expr);
+			}
+			return Passed;
+		}
+
+		inline bool RecordEqual(long long A, long long B, const char* File, int Line, const char* ExprA, const char* ExprB)
+		{
+			GetCounts().Checks++;
+			if (A != B)
+			{
+				GetCounts().Failures++;
+				printf("%s:%d: check failed: %s == %s (%lld vs %lld)\n", File, Line, ExprA, ExprB, A, B);
+			}
+			return A == B;
+		}
+
+		inline int Finish(const char* Name)
+		{
+			const Counts& C = GetCounts();
+			printf("%s: %d checks, %d failed\n", Name, C.Checks, C.Failures);
+			return C.Failures == 0 ? 0 : 1;
+		}
+	}
+}
+
+#define ASE_CHECK(Expr) ASE::Test::Record(static_cast<bool>(Expr), __FILE__, __LINE__, #Expr)
+#define ASE_CHECK_EQ(A, B) ASE::Test::RecordEqual((long long)(A), (long long)(B), __FILE__, __LINE__, #A, #B)
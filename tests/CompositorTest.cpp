@@ -0,0 +1,107 @@
+// Checks that Compositor::BlendRow, which takes the SSE4.1/AVX2 paths when they're compiled in, gives exactly the pixels
+// BlendPixel works out one at a time in plain C++, for every blend mode, opacity and row length.
+// Build it once with -mavx2 and once with -msse4.1 to cover both vector paths.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -mavx2 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include tests/CompositorTest.cpp -o CompositorTest -lz
+// Usage:
+//   CompositorTest
+
+#include <random>
+#include <vector>
+#include "Core/Log/Public/Log.h"
+#include "Core/Image/Public/Compositor.h"
+#include "Check.h"
+
+namespace
+{
+	//Mostly opaque and fully transparent pixels with the edge cases mixed in, the alpha values the blend has to get exactly right
+	uint32_t RandomPixel(std::mt19937& Random)
+	{
+		static const uint32_t Alphas[] = { 0, 1, 127, 128, 254, 255 };
+		uint32_t Alpha = Random() % 3 == 0 ? (uint32_t)(Random() & 0xFF) : Alphas[Random() % 6];
+		return (Random() & 0x00FFFFFF) | (Alpha << 24);
+	}
+
+	void CheckMode(std::mt19937& Random, ASE::AsepriteBlendMode Mode)
+	{
+		static const uint8_t Opacities[] = { 0, 1, 128, 200, 255 };
+		for (uint8_t Opacity : Opacities)
+		{
+			//Lengths either side of the 4 and 8 pixel vector widths and the 256 pixel blend buffer
+			for (size_t Count : { 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 255, 256, 257, 600 })
+			{
+				std::vector<uint32_t> Dst(Count), Src(Count), Expected(Count);
+				for (size_t i = 0; i < Count; i++)
+				{
+					Dst[i] = RandomPixel(Random);
+					Src[i] = RandomPixel(Random);
+					Expected[i] = ASE::Compositor::BlendPixel(Dst[i], Src[i], Mode, Opacity);
+				}
+
+				ASE::Compositor::BlendRow(Dst.data(), Src.data(), Count, Mode, Opacity);
+
+				size_t Mismatches = 0;
+				for (size_t i = 0; i < Count; i++)
+				{
+					Mismatches += Dst[i] != Expected[i];
+				}
+				if (!ASE_CHECK_EQ(Mismatches, 0))
+				{
+					printf("  mode %u opacity %u count %zu\n", (uint32_t)Mode, Opacity, Count);
+				}
+			}
+		}
+	}
+
+	//A cel hanging off every side of the canvas only touches the overlap, and blends it like BlendPixel would
+	void CheckClipping(std::mt19937& Random)
+	{
+		const uint32_t Width = 16, Height = 12;
+		for (int Y = -12; Y <= 12; Y += 4)
+		{
+			for (int X = -12; X <= 16; X += 4)
+			{
+				std::vector<uint32_t> Canvas(Width * Height), Cel(10 * 10);
+				for (auto& P : Canvas)
+				{
+					P = RandomPixel(Random);
+				}
+				for (auto& P : Cel)
+				{
+					P = RandomPixel(Random);
+				}
+
+				std::vector<uint32_t> Expected = Canvas;
+				for (int y = 0; y < 10; y++)
+				{
+					for (int x = 0; x < 10; x++)
+					{
+						if (X + x >= 0 && X + x < (int)Width && Y + y >= 0 && Y + y < (int)Height)
+						{
+							uint32_t& P = Expected[(size_t)(Y + y) * Width + (X + x)];
+							P = ASE::Compositor::BlendPixel(P, Cel[(size_t)y * 10 + x], ASE::AsepriteBlendMode::Multiply, 200);
+						}
+					}
+				}
+
+				ASE::Compositor::CompositeCel(Canvas.data(), Width, Height, Width, Cel.data(), X, Y, 10, 10, 10, ASE::AsepriteBlendMode::Multiply, 200);
+				ASE_CHECK(Canvas == Expected);
+			}
+		}
+	}
+}
+
+int main()
+{
+	ASE::Log::Init();
+	std::mt19937 Random(99);
+
+	for (uint16_t Mode = (uint16_t)ASE::AsepriteBlendMode::Normal; Mode <= (uint16_t)ASE::AsepriteBlendMode::Divide; Mode++)
+	{
+		CheckMode(Random, (ASE::AsepriteBlendMode)Mode);
+	}
+	CheckClipping(Random);
+
+	return ASE::Test::Finish("CompositorTest");
+}
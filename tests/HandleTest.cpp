@@ -0,0 +1,108 @@
+// Loads, unloads and reloads sprites and checks that handles to an unloaded sprite, its layers, tags and slices find nothing,
+// even once its slot has been reused, and that lookups by name and path forget it.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include tests/HandleTest.cpp -o HandleTest -lz
+// Usage:
+//   HandleTest
+
+#include <filesystem>
+#include "Core/Log/Public/Log.h"
+#include "Core/Image/Public/Parser.h"
+#include "Check.h"
+#include "TestSprite.h"
+
+namespace
+{
+	//Gets at the frame data lookup the parser keeps to itself
+	class TestParser : public ASE::AsepriteParser
+	{
+	public:
+		using ASE::AsepriteParser::GetSpriteFrameData;
+	};
+
+	void WriteSprite(const std::filesystem::path& Path)
+	{
+		ASE::Test::TestSpriteWriter Writer(8, 8);
+		Writer.AddLayer("Body");
+		Writer.AddLayer("Hat");
+		Writer.AddFrame();
+		Writer.AddCel(0, 0, 0, 8, 8, 0xFF0000FF);
+		Writer.AddFrame();
+		Writer.AddCel(1, 2, 0, 4, 4, 0xFF00FF00);
+		Writer.AddTag("Idle", 0, 1, 0);
+		Writer.AddSlice("Hitbox", 0, { { 0, 1, 1, 6, 6 } });
+		Writer.Write(Path);
+	}
+}
+
+int main()
+{
+	ASE::Log::Init();
+	std::filesystem::path Directory = std::filesystem::temp_directory_path() / "ase_handle_test";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory / "Other");
+	std::filesystem::path Source = Directory / "Hero.aseprite";
+	std::filesystem::path SameName = Directory / "Other" / "Hero.aseprite";
+	WriteSprite(Source);
+	WriteSprite(SameName);
+
+	TestParser Parser;
+	ASE::SpriteId Sprite = Parser.ReadData(Source);
+	ASE_CHECK(Sprite);
+	ASE_CHECK(Parser.FindSprite("Hero") == Sprite);
+	ASE_CHECK(Parser.FindSpriteByPath(Source) == Sprite);
+	ASE_CHECK(Parser.GetSpriteName(Sprite) == "Hero");
+	ASE_CHECK(Parser.GetSpriteFrameData("Hero"));
+
+	ASE::LayerId Layer = Parser.FindLayer(Sprite, "Hat");
+	ASE::TagId Tag = Parser.FindTag(Sprite, "Idle");
+	ASE::SliceId Slice = Parser.FindSlice(Sprite, "Hitbox");
+	ASE_CHECK(Parser.GetLayer(Layer) && Parser.GetLayer(Layer)->Name == "Hat");
+	ASE_CHECK(Parser.GetTag(Tag) && Parser.GetTag(Tag)->Name == "Idle");
+	ASE_CHECK(Parser.GetSlice(Slice) && Parser.GetSlice(Slice)->Name == "Hitbox");
+	ASE_CHECK(!Parser.FindTag(Sprite, "Run"));
+	ASE_CHECK(!Parser.GetTag(ASE::TagId()));
+
+	//Everything pointing at the sprite goes stale together, and it can only be unloaded once
+	ASE_CHECK(Parser.Unload(Sprite));
+	ASE_CHECK(!Parser.Unload(Sprite));
+	ASE_CHECK_EQ(Parser.GetSpriteCount(), 0);
+	ASE_CHECK(!Parser.GetFileData(Sprite));
+	ASE_CHECK(!Parser.GetLayer(Layer));
+	ASE_CHECK(!Parser.GetTag(Tag));
+	ASE_CHECK(!Parser.GetSlice(Slice));
+	ASE_CHECK(!Parser.FindTag(Sprite, "Idle"));
+	ASE_CHECK(!Parser.FindSprite("Hero"));
+	ASE_CHECK(!Parser.FindSpriteByPath(Source));
+	ASE_CHECK(!Parser.GetFileData("Hero"));
+	ASE_CHECK(!Parser.GetSpriteFrameData("Hero"));
+	ASE_CHECK(Parser.GetSpriteName(Sprite).empty());
+
+	//Loading again takes the freed slot with a new generation, the old handles still find nothing
+	ASE::SpriteId Reloaded = Parser.ReadData(Source);
+	ASE_CHECK(Reloaded);
+	ASE_CHECK(Reloaded != Sprite);
+	ASE_CHECK_EQ(Reloaded.Index, Sprite.Index);
+	ASE_CHECK(!Parser.GetFileData(Sprite));
+	ASE_CHECK(!Parser.GetTag(Tag));
+	ASE_CHECK(!Parser.GetSlice(Slice));
+	ASE_CHECK(!Parser.GetLayer(Layer));
+	ASE_CHECK(Parser.GetTag(Parser.FindTag(Reloaded, "Idle")));
+	ASE_CHECK(Parser.FindTag(Reloaded, "Idle") != Tag);
+	ASE_CHECK(Parser.FindSprite("Hero") == Reloaded);
+
+	//Two files with the same name, by name finds the one loaded last and unloading the other leaves it alone
+	ASE::SpriteId Second = Parser.ReadData(SameName);
+	ASE_CHECK(Second && Second != Reloaded);
+	ASE_CHECK(Parser.FindSprite("Hero") == Second);
+	ASE_CHECK(Parser.FindSpriteByPath(Source) == Reloaded);
+	ASE_CHECK(Parser.Unload(Reloaded));
+	ASE_CHECK(Parser.FindSprite("Hero") == Second);
+	ASE_CHECK(Parser.GetFileData(Second));
+	ASE_CHECK(Parser.Unload(Second));
+	ASE_CHECK(!Parser.FindSprite("Hero"));
+
+	std::filesystem::remove_all(Directory);
+	return ASE::Test::Finish("HandleTest");
+}
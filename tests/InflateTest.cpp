@@ -0,0 +1,129 @@
+// Checks ZlibInflater and FastInflater against zlib's own uncompress on streams that are valid, truncated, bit flipped,
+// the wrong size for their output or followed by junk, so both backends keep to the same contract.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include tests/InflateTest.cpp -o InflateTest -lz
+// Usage:
+//   InflateTest
+
+#include <random>
+#include <vector>
+#include "Core/Log/Public/Log.h"
+#include "Core/Compression/Public/Inflater.h"
+#include "Core/Compression/Public/FastInflater.h"
+#include "Check.h"
+
+namespace
+{
+	//Pixels with long runs and a few random bytes, the kind of thing a sprite compresses to
+	std::vector<uint8_t> MakePixels(std::mt19937& Random, size_t Size)
+	{
+		std::vector<uint8_t> Pixels(Size);
+		uint32_t Colors = 1 + Random() % 8;
+		for (auto& Byte : Pixels)
+		{
+			Byte = Random() % 4 == 0 ? (uint8_t)Random() : (uint8_t)(Random() % Colors);
+		}
+		return Pixels;
+	}
+
+	std::vector<uint8_t> Compress(const std::vector<uint8_t>& Data, int Level)
+	{
+		uLongf Size = compressBound((uLong)Data.size());
+		std::vector<uint8_t> Out(Size);
+		compress2(Out.data(), &Size, Data.data(), (uLong)Data.size(), Level);
+		Out.resize(Size);
+		return Out;
+	}
+
+	//What zlib itself makes of the stream: whether it's one complete stream and what it inflates to
+	bool Reference(const std::vector<uint8_t>& Stream, std::vector<uint8_t>& Out)
+	{
+		z_stream Z = {};
+		if (inflateInit(&Z) != Z_OK)
+		{
+			return false;
+		}
+		Z.next_in = (Bytef*)Stream.data();
+		Z.avail_in = (uInt)Stream.size();
+		Out.clear();
+
+		int Result = Z_OK;
+		uint8_t Chunk[4096];
+		while (Result == Z_OK)
+		{
+			Z.next_out = Chunk;
+			Z.avail_out = sizeof(Chunk);
+			Result = inflate(&Z, Z_NO_FLUSH);
+			Out.insert(Out.end(), Chunk, Chunk + (sizeof(Chunk) - Z.avail_out));
+			if (Result == Z_BUF_ERROR && Z.avail_in == 0)
+			{
+				break;
+			}
+		}
+		inflateEnd(&Z);
+		return Result == Z_STREAM_END;
+	}
+
+	//Both backends have to accept exactly when zlib finds one complete stream of DstSize bytes, and then agree with it byte for byte
+	void CheckStream(const std::vector<uint8_t>& Stream, size_t DstSize)
+	{
+		std::vector<uint8_t> Expected;
+		bool Valid = Reference(Stream, Expected) && Expected.size() == DstSize;
+
+		std::vector<uint8_t> Zlib(DstSize + 1), Fast(DstSize + 1);
+		ASE::ZlibInflater ZlibBackend;
+		ASE::FastInflater FastBackend;
+		bool ZlibResult = ZlibBackend.Inflate(Stream.data(), Stream.size(), Zlib.data(), DstSize);
+		bool FastResult = FastBackend.Inflate(Stream.data(), Stream.size(), Fast.data(), DstSize);
+
+		ASE_CHECK_EQ(ZlibResult, Valid);
+		ASE_CHECK_EQ(FastResult, Valid);
+		if (Valid)
+		{
+			ASE_CHECK(memcmp(Zlib.data(), Expected.data(), DstSize) == 0);
+			ASE_CHECK(memcmp(Fast.data(), Expected.data(), DstSize) == 0);
+		}
+	}
+}
+
+int main()
+{
+	ASE::Log::Init();
+	std::mt19937 Random(1234);
+
+	for (int i = 0; i < 500; i++)
+	{
+		std::vector<uint8_t> Pixels = MakePixels(Random, 1 + Random() % 20000);
+		std::vector<uint8_t> Stream = Compress(Pixels, i % 10);
+
+		CheckStream(Stream, Pixels.size());
+
+		//Output one byte too small or too big
+		CheckStream(Stream, Pixels.size() - 1);
+		CheckStream(Stream, Pixels.size() + 1);
+
+		//Cut off anywhere, including just the checksum
+		std::vector<uint8_t> Truncated(Stream.begin(), Stream.end() - 1 - Random() % std::min<size_t>(Stream.size() - 1, 16));
+		CheckStream(Truncated, Pixels.size());
+
+		//A flipped bit gets caught by the decoder or the checksum
+		std::vector<uint8_t> Corrupt = Stream;
+		Corrupt[Random() % Corrupt.size()] ^= (uint8_t)(1 << (Random() % 8));
+		CheckStream(Corrupt, Pixels.size());
+
+		//Bytes after the end of the stream are ignored
+		std::vector<uint8_t> Trailing = Stream;
+		Trailing.push_back(0xAB);
+		Trailing.push_back(0xCD);
+		CheckStream(Trailing, Pixels.size());
+	}
+
+	//Stored blocks only, then an empty cel
+	std::vector<uint8_t> Pixels = MakePixels(Random, 70000);
+	CheckStream(Compress(Pixels, 0), Pixels.size());
+	std::vector<uint8_t> Empty;
+	CheckStream(Compress(Empty, 6), 0);
+
+	return ASE::Test::Finish("InflateTest");
+}
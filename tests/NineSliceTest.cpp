@@ -0,0 +1,194 @@
+// Loads a sprite with nine-patch and plain slices and checks the quads NineSlice::Build gives at different sizes, where GetPivot
+// puts the pivot, which key each frame uses, and that slices can be found in a file, a plain vector of them or an atlas sprite.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include tests/NineSliceTest.cpp -o NineSliceTest -lz
+// Usage:
+//   NineSliceTest
+
+#include <cmath>
+#include <vector>
+#include <filesystem>
+#include "Core/Log/Public/Log.h"
+#include "Core/Image/Public/Parser.h"
+#include "Core/Image/Public/NineSlice.h"
+#include "Core/Image/Public/AtlasBuilder.h"
+#include "Check.h"
+#include "TestSprite.h"
+
+namespace
+{
+	bool Near(float A, float B)
+	{
+		return std::fabs(A - B) < 0.001f;
+	}
+
+	bool SameQuad(const ASE::SliceQuad& Q, float X, float Y, float Width, float Height)
+	{
+		return Near(Q.X, X) && Near(Q.Y, Y) && Near(Q.Width, Width) && Near(Q.Height, Height);
+	}
+
+	float Area(const ASE::NineSliceQuads& Quads)
+	{
+		float Total = 0.0f;
+		for (auto& Q : Quads)
+		{
+			Total += Q.Width * Q.Height;
+		}
+		return Total;
+	}
+
+	//24x16 slice at 2, 2 with a 4 pixel border left and right and 3 top and bottom. The second key from frame 2 moves it and its pivot
+	void WriteSprite(const std::filesystem::path& Path)
+	{
+		ASE::Test::TestSpriteWriter Writer(32, 32);
+		Writer.AddLayer("Panel");
+		for (uint16_t f = 0; f < 4; f++)
+		{
+			Writer.AddFrame();
+			Writer.AddCel(0, 0, 0, 32, 32, 0xFF204060);
+		}
+		Writer.AddSlice("Panel", 3, { { 0, 2, 2, 24, 16, 4, 3, 16, 10, 1, 1 }, { 2, 4, 6, 24, 16, 4, 3, 16, 10, 10, 6 } });
+		Writer.AddSlice("Plain", 2, { { 1, 0, 0, 8, 4, 0, 0, 0, 0, 6, 2 } });
+		Writer.AddSlice("LeftEdge", 1, { { 0, 0, 0, 12, 12, 0, 4, 8, 4 } });
+		Writer.Write(Path);
+	}
+
+	void CheckNinePatch(const ASE::AsepriteSliceChunk& Panel)
+	{
+		const ASE::AsepriteSliceKey& Key = Panel.Slices[0];
+
+		//Corners keep their size in pixels, edges stretch one way and the center both
+		ASE::NineSliceQuads Quads = ASE::NineSlice::Build(Panel, Key, 10.0f, 20.0f, 100.0f, 50.0f, 32, 32);
+		ASE_CHECK_EQ(Quads.Count, 9);
+		ASE_CHECK(SameQuad(Quads.Quads[0], 10.0f, 20.0f, 4.0f, 3.0f));
+		ASE_CHECK(SameQuad(Quads.Quads[1], 14.0f, 20.0f, 92.0f, 3.0f));
+		ASE_CHECK(SameQuad(Quads.Quads[2], 106.0f, 20.0f, 4.0f, 3.0f));
+		ASE_CHECK(SameQuad(Quads.Quads[4], 14.0f, 23.0f, 92.0f, 44.0f));
+		ASE_CHECK(SameQuad(Quads.Quads[8], 106.0f, 67.0f, 4.0f, 3.0f));
+		ASE_CHECK(Near(Area(Quads), 100.0f * 50.0f));
+
+		//UVs are the slice's pixels on the texture, moved by where the frame is
+		ASE_CHECK(Near(Quads.Quads[0].U0, 2.0f / 32) && Near(Quads.Quads[0].U1, 6.0f / 32));
+		ASE_CHECK(Near(Quads.Quads[0].V0, 2.0f / 32) && Near(Quads.Quads[0].V1, 5.0f / 32));
+		ASE_CHECK(Near(Quads.Quads[4].U0, 6.0f / 32) && Near(Quads.Quads[4].U1, 22.0f / 32));
+		ASE_CHECK(Near(Quads.Quads[8].U1, 26.0f / 32) && Near(Quads.Quads[8].V1, 18.0f / 32));
+		ASE::NineSliceQuads Moved = ASE::NineSlice::Build(Panel, Key, 0.0f, 0.0f, 100.0f, 50.0f, 64, 128, 30, 40);
+		ASE_CHECK(Near(Moved.Quads[0].U0, 32.0f / 64) && Near(Moved.Quads[0].V0, 42.0f / 128));
+		ASE_CHECK(Near(Moved.Quads[8].U1, 56.0f / 64) && Near(Moved.Quads[8].V1, 58.0f / 128));
+
+		//Drawn at its own size every quad is one texel for one pixel
+		ASE::NineSliceQuads Same = ASE::NineSlice::Build(Panel, Key, 0.0f, 0.0f, 24.0f, 16.0f, 32, 32);
+		for (auto& Q : Same)
+		{
+			ASE_CHECK(Near((Q.U1 - Q.U0) * 32, Q.Width) && Near((Q.V1 - Q.V0) * 32, Q.Height));
+		}
+
+		//Smaller than the corners, the corners shrink to fit and the edges and center come out empty
+		ASE::NineSliceQuads Small = ASE::NineSlice::Build(Panel, Key, 0.0f, 0.0f, 4.0f, 3.0f, 32, 32);
+		ASE_CHECK_EQ(Small.Count, 4);
+		ASE_CHECK(SameQuad(Small.Quads[0], 0.0f, 0.0f, 2.0f, 1.5f));
+		ASE_CHECK(SameQuad(Small.Quads[3], 2.0f, 1.5f, 2.0f, 1.5f));
+		ASE_CHECK(Near(Small.Quads[3].U1, 26.0f / 32));
+		ASE_CHECK(Near(Area(Small), 4.0f * 3.0f));
+
+		//Only one axis too small
+		ASE::NineSliceQuads Thin = ASE::NineSlice::Build(Panel, Key, 0.0f, 0.0f, 100.0f, 3.0f, 32, 32);
+		ASE_CHECK_EQ(Thin.Count, 6);
+		ASE_CHECK(Near(Area(Thin), 100.0f * 3.0f));
+
+		//The pivot moves with the piece it's in
+		float PivotX, PivotY;
+		ASE_CHECK(ASE::NineSlice::GetPivot(Panel, Key, 100.0f, 50.0f, PivotX, PivotY));
+		ASE_CHECK(Near(PivotX, 1.0f) && Near(PivotY, 1.0f));
+		const ASE::AsepriteSliceKey& Later = Panel.Slices[1];
+		ASE_CHECK(ASE::NineSlice::GetPivot(Panel, Later, 100.0f, 50.0f, PivotX, PivotY));
+		ASE_CHECK(Near(PivotX, 4.0f + 6.0f * 92.0f / 16.0f) && Near(PivotY, 3.0f + 3.0f * 44.0f / 10.0f));
+		ASE_CHECK(ASE::NineSlice::GetPivot(Panel, Later, 24.0f, 16.0f, PivotX, PivotY));
+		ASE_CHECK(Near(PivotX, 10.0f) && Near(PivotY, 6.0f));
+	}
+
+	void CheckPlain(const ASE::AsepriteSliceChunk& Plain, const ASE::AsepriteSliceChunk& LeftEdge)
+	{
+		//Not a nine-patch, one quad over the whole target and its pivot scales with it
+		const ASE::AsepriteSliceKey& Key = Plain.Slices[0];
+		ASE::NineSliceQuads Quads = ASE::NineSlice::Build(Plain, Key, 5.0f, 6.0f, 80.0f, 8.0f, 16, 16);
+		ASE_CHECK_EQ(Quads.Count, 1);
+		ASE_CHECK(SameQuad(Quads.Quads[0], 5.0f, 6.0f, 80.0f, 8.0f));
+		ASE_CHECK(Near(Quads.Quads[0].U0, 0.0f) && Near(Quads.Quads[0].U1, 0.5f));
+		ASE_CHECK(Near(Quads.Quads[0].V0, 0.0f) && Near(Quads.Quads[0].V1, 0.25f));
+
+		float PivotX, PivotY;
+		ASE_CHECK(ASE::NineSlice::GetPivot(Plain, Key, 80.0f, 8.0f, PivotX, PivotY));
+		ASE_CHECK(Near(PivotX, 60.0f) && Near(PivotY, 4.0f));
+
+		//No pivot gives false and 0, 0
+		PivotX = PivotY = 1.0f;
+		ASE_CHECK(!ASE::NineSlice::GetPivot(LeftEdge, LeftEdge.Slices[0], 50.0f, 50.0f, PivotX, PivotY));
+		ASE_CHECK(PivotX == 0.0f && PivotY == 0.0f);
+
+		//A nine-patch with no left border leaves out the pieces that would be empty
+		ASE::NineSliceQuads Edge = ASE::NineSlice::Build(LeftEdge, LeftEdge.Slices[0], 0.0f, 0.0f, 50.0f, 50.0f, 16, 16);
+		ASE_CHECK_EQ(Edge.Count, 6);
+		ASE_CHECK(Near(Area(Edge), 50.0f * 50.0f));
+		ASE_CHECK(SameQuad(Edge.Quads[0], 0.0f, 0.0f, 46.0f, 4.0f));
+	}
+
+	void CheckKeys(const ASE::AsepriteSliceChunk& Panel, const ASE::AsepriteSliceChunk& Plain)
+	{
+		ASE_CHECK(ASE::NineSlice::GetKey(Panel, 0) == &Panel.Slices[0]);
+		ASE_CHECK(ASE::NineSlice::GetKey(Panel, 1) == &Panel.Slices[0]);
+		ASE_CHECK(ASE::NineSlice::GetKey(Panel, 2) == &Panel.Slices[1]);
+		ASE_CHECK(ASE::NineSlice::GetKey(Panel, 3) == &Panel.Slices[1]);
+		ASE_CHECK(ASE::NineSlice::GetKey(Panel, 1000) == &Panel.Slices[1]);
+
+		//Plain doesn't start until frame 1
+		ASE_CHECK(!ASE::NineSlice::GetKey(Plain, 0));
+		ASE_CHECK(ASE::NineSlice::GetKey(Plain, 1) == &Plain.Slices[0]);
+	}
+}
+
+int main()
+{
+	ASE::Log::Init();
+	std::filesystem::path Directory = std::filesystem::temp_directory_path() / "ase_nine_slice_test";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	std::filesystem::path Source = Directory / "Panel.aseprite";
+	WriteSprite(Source);
+
+	ASE::AsepriteParser Parser;
+	ASE::SpriteId Sprite = Parser.ReadData(Source);
+	ASE_CHECK(Sprite);
+	const ASE::AsepriteFileData& File = *Parser.GetFileData(Sprite);
+	ASE_CHECK_EQ(File.Slices.size(), 3);
+
+	//Both FindSlice overloads, and an atlas sprite's slices
+	const ASE::AsepriteSliceChunk* Panel = ASE::NineSlice::FindSlice(File, "Panel");
+	const ASE::AsepriteSliceChunk* Plain = ASE::NineSlice::FindSlice(File, "Plain");
+	const ASE::AsepriteSliceChunk* LeftEdge = ASE::NineSlice::FindSlice(File, "LeftEdge");
+	ASE_CHECK(Panel && Plain && LeftEdge);
+	ASE_CHECK(!ASE::NineSlice::FindSlice(File, "Missing"));
+
+	std::vector<ASE::AsepriteSliceChunk> Copied(File.Slices.begin(), File.Slices.end());
+	const ASE::AsepriteSliceChunk* CopiedPanel = ASE::NineSlice::FindSlice(Copied, "Panel");
+	ASE_CHECK(CopiedPanel == &Copied[0]);
+	ASE_CHECK(!ASE::NineSlice::FindSlice(Copied, "Missing"));
+
+	ASE::AtlasBuilder Atlas(64);
+	Atlas.AddSprite("Panel", File);
+	ASE_CHECK(Atlas.Build());
+	const ASE::AtlasSprite* Placed = Atlas.GetSprite("Panel");
+	ASE_CHECK(Placed && Placed->FindSlice("Plain") && Placed->FindSlice("Plain")->Slice.Name == "Plain");
+	ASE_CHECK(Placed && !Placed->FindSlice("Missing"));
+
+	if (Panel && Plain && LeftEdge)
+	{
+		CheckNinePatch(*Panel);
+		CheckPlain(*Plain, *LeftEdge);
+		CheckKeys(*Panel, *Plain);
+	}
+
+	std::filesystem::remove_all(Directory);
+	return ASE::Test::Finish("NineSliceTest");
+}
@@ -0,0 +1,138 @@
+// Round trips a sprite through the sprite cache and checks the frames, durations, tags and slices come back the same,
+// and that caches from another version, of a changed source or cut short are turned down and rebuilt.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include tests/SpriteCacheTest.cpp -o SpriteCacheTest -lz
+// Usage:
+//   SpriteCacheTest
+
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include "Core/Log/Public/Log.h"
+#include "Core/Image/Public/Parser.h"
+#include "Core/Image/Public/SpriteCache.h"
+#include "Check.h"
+#include "TestSprite.h"
+
+namespace
+{
+	void WriteSprite(const std::filesystem::path& Path, uint16_t ExtraFrames = 0)
+	{
+		ASE::Test::TestSpriteWriter Writer(16, 16);
+		Writer.AddLayer("Body");
+		for (uint16_t f = 0; f < 3 + ExtraFrames; f++)
+		{
+			Writer.AddFrame(100 + f * 50);
+			Writer.AddCel(0, (int16_t)f, 2, 8, 8, 0xFF000000 | (0x30 * (f + 1)));
+		}
+		Writer.AddTag("Idle", 0, 1, 0);
+		Writer.AddTag("Hit", 1, 2, 2, 3);
+		Writer.AddSlice("Panel", 3, { { 0, 1, 2, 12, 10, 3, 3, 6, 4, 6, 5 }, { 2, 2, 2, 12, 10, 3, 3, 6, 4, 7, 5 } });
+		Writer.AddSlice("Hitbox", 0, { { 1, 4, 4, 8, 8 } });
+		Writer.Write(Path);
+	}
+
+	void CheckSame(const ASE::BakedSprite& Baked, const ASE::FrameSet& Frames, const ASE::AsepriteFileData& File)
+	{
+		ASE_CHECK_EQ(Baked.GetWidth(), Frames.GetWidth());
+		ASE_CHECK_EQ(Baked.GetHeight(), Frames.GetHeight());
+		ASE_CHECK_EQ(Baked.GetFrameCount(), Frames.GetFrameCount());
+		for (uint16_t f = 0; f < Frames.GetFrameCount() && f < Baked.GetFrameCount(); f++)
+		{
+			ASE_CHECK_EQ(Baked.GetFrameDuration(f), Frames.GetFrameDuration(f));
+			ASE_CHECK(memcmp(Baked.GetFrame(f), Frames.GetFrame(f), Frames.GetFrameStride() * sizeof(uint32_t)) == 0);
+		}
+
+		ASE_CHECK_EQ(Baked.GetTags().size(), File.Tags.size());
+		for (size_t t = 0; t < Baked.GetTags().size() && t < File.Tags.size(); t++)
+		{
+			const ASE::AsepriteTag& A = Baked.GetTags()[t];
+			const ASE::AsepriteTag& B = File.Tags[t];
+			ASE_CHECK(A.Name == B.Name);
+			ASE_CHECK_EQ(A.FromFrame, B.FromFrame);
+			ASE_CHECK_EQ(A.ToFrame, B.ToFrame);
+			ASE_CHECK_EQ(A.LoopDirection, B.LoopDirection);
+			ASE_CHECK_EQ(A.RepeatTimes, B.RepeatTimes);
+			ASE_CHECK(memcmp(A.RGB, B.RGB, sizeof(A.RGB)) == 0);
+		}
+
+		ASE_CHECK_EQ(Baked.GetSlices().size(), File.Slices.size());
+		for (size_t s = 0; s < Baked.GetSlices().size() && s < File.Slices.size(); s++)
+		{
+			const ASE::AsepriteSliceChunk& A = Baked.GetSlices()[s];
+			const ASE::AsepriteSliceChunk& B = File.Slices[s];
+			ASE_CHECK(A.Name == B.Name);
+			ASE_CHECK_EQ(A.Flags, B.Flags);
+			ASE_CHECK_EQ(A.Slices.size(), B.Slices.size());
+			ASE_CHECK(A.Slices.size() == B.Slices.size() && memcmp(A.Slices.data(), B.Slices.data(), A.Slices.size() * sizeof(ASE::AsepriteSliceKey)) == 0);
+		}
+	}
+
+	void PatchVersion(const std::filesystem::path& CachePath, uint32_t Version)
+	{
+		std::fstream File(CachePath, std::ios::in | std::ios::out | std::ios::binary);
+		File.seekp(offsetof(ASE::SpriteCacheHeader, Version));
+		File.write((const char*)&Version, sizeof(Version));
+	}
+}
+
+int main()
+{
+	ASE::Log::Init();
+	std::filesystem::path Directory = std::filesystem::temp_directory_path() / "ase_sprite_cache_test";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	std::filesystem::path Source = Directory / "Sprite.aseprite";
+	std::filesystem::path CacheDirectory = Directory / "Cache";
+	WriteSprite(Source);
+
+	ASE::AsepriteParser Parser;
+	ASE::SpriteId Sprite = Parser.ReadData(Source);
+	ASE_CHECK(Sprite);
+	const ASE::AsepriteFileData& File = *Parser.GetFileData(Sprite);
+	ASE_CHECK_EQ(File.Tags.size(), 2);
+	ASE_CHECK_EQ(File.Slices.size(), 2);
+	ASE::FrameSet Frames(File);
+
+	std::filesystem::path CachePath = ASE::SpriteCache::GetCachePath(CacheDirectory, Source);
+	ASE_CHECK(!ASE::SpriteCache::Load(Source, CachePath));
+
+	//First load composites and writes the cache, then maps it
+	ASE::BakedSprite First = Parser.LoadCached(Source, CacheDirectory);
+	ASE_CHECK(First);
+	ASE_CHECK(std::filesystem::exists(CachePath));
+	CheckSame(First, Frames, File);
+
+	ASE::BakedSprite Second = ASE::SpriteCache::Load(Source, CachePath);
+	ASE_CHECK(Second.IsMapped());
+	CheckSame(Second, Frames, File);
+
+	//A cache written by another version is ignored and LoadCached writes it again
+	First = ASE::BakedSprite();
+	Second = ASE::BakedSprite();
+	PatchVersion(CachePath, ASE::SpriteCache::Version - 1);
+	ASE_CHECK(!ASE::SpriteCache::Load(Source, CachePath));
+	ASE::BakedSprite Rebuilt = Parser.LoadCached(Source, CacheDirectory);
+	CheckSame(Rebuilt, Frames, File);
+	Rebuilt = ASE::BakedSprite();
+	ASE_CHECK(ASE::SpriteCache::Load(Source, CachePath));
+
+	//Cut short anywhere, the metadata included, it isn't used
+	uint64_t Size = std::filesystem::file_size(CachePath);
+	std::filesystem::resize_file(CachePath, Size - 1);
+	ASE_CHECK(!ASE::SpriteCache::Load(Source, CachePath));
+	std::filesystem::resize_file(CachePath, sizeof(ASE::SpriteCacheHeader) + 8);
+	ASE_CHECK(!ASE::SpriteCache::Load(Source, CachePath));
+
+	//A source that has changed size gets a fresh cache with its new frames
+	Parser.LoadCached(Source, CacheDirectory);
+	WriteSprite(Source, 2);
+	ASE_CHECK(!ASE::SpriteCache::Load(Source, CachePath));
+	ASE::BakedSprite Changed = Parser.LoadCached(Source, CacheDirectory);
+	ASE_CHECK_EQ(Changed.GetFrameCount(), 5);
+
+	Changed = ASE::BakedSprite();
+	std::filesystem::remove_all(Directory);
+	return ASE::Test::Finish("SpriteCacheTest");
+}
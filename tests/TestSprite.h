@@ -0,0 +1,232 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <zlib.h>
+
+// Writes small .aseprite files for the tests to load, so none of them need sprites checked in.
+// Layers, tilesets, tags and slices go in the first frame like Aseprite writes them, every cel is zlib compressed.
+// Pixels are given as RGBA (R in the low byte) and written at the file's depth, so an indexed file takes the index in the low byte.
+
+namespace ASE
+{
+	namespace Test
+	{
+		struct TestSliceKey
+		{
+			uint32_t Frame = 0;
+			int32_t X = 0, Y = 0;
+			uint32_t Width = 0, Height = 0;
+			int32_t CenterX = 0, CenterY = 0;
+			uint32_t CenterWidth = 0, CenterHeight = 0;
+			int32_t PivotX = 0, PivotY = 0;
+		};
+
+		class TestSpriteWriter
+		{
+		public:
+			TestSpriteWriter(uint16_t Width, uint16_t Height, uint16_t Depth = 32, uint8_t TransparentIndex = 0)
+				:m_Width(Width), m_Height(Height), m_Depth(Depth), m_TransparentIndex(TransparentIndex) {}
+
+			void AddLayer(const std::string& Name)
+			{
+				Bytes Body;
+				Body.U16(3).U16(0).U16(0).U16(0).U16(0).U16(0).U8(255).Zero(3).Str(Name); // Visible and editable, normal blend
+				m_Layers.push_back(Chunk(0x2004, Body));
+			}
+
+			//A tilemap layer drawing from the tileset with this ID
+			void AddTilemapLayer(const std::string& Name, uint32_t TilesetID)
+			{
+				Bytes Body;
+				Body.U16(3).U16(2).U16(0).U16(0).U16(0).U16(0).U8(255).Zero(3).Str(Name).U32(TilesetID);
+				m_Layers.push_back(Chunk(0x2004, Body));
+			}
+
+			//Every tile is TileWidth x TileHeight pixels, tile 0 is the empty one
+			void AddTileset(uint32_t ID, uint16_t TileWidth, uint16_t TileHeight, const std::vector<std::vector<uint32_t>>& Tiles)
+			{
+				std::vector<uint32_t> Strip;
+				for (auto& Tile : Tiles)
+				{
+					Strip.insert(Strip.end(), Tile.begin(), Tile.end());
+				}
+				std::vector<uint8_t> Compressed = Compress(ToDepth(Strip));
+
+				Bytes Body;
+				Body.U32(ID).U32(2 | 4).U32((uint32_t)Tiles.size()).U16(TileWidth).U16(TileHeight).U16(1).Zero(14).Str("Tiles");
+				Body.U32((uint32_t)Compressed.size()).Raw(Compressed);
+				m_Tilesets.push_back(Chunk(0x2023, Body));
+			}
+
+			//Changes palette entries from First on, in the frame added last
+			void AddPalette(uint32_t First, const std::vector<uint32_t>& Colors)
+			{
+				Bytes Body;
+				Body.U32(256).U32(First).U32(First + (uint32_t)Colors.size() - 1).Zero(8);
+				for (uint32_t Color : Colors)
+				{
+					Body.U16(0).U32(Color);
+				}
+				m_Frames.back().Chunks.push_back(Chunk(0x2019, Body));
+			}
+
+			//Starts a new frame, cels added after this go in it
+			void AddFrame(uint16_t Duration = 100)
+			{
+				m_Frames.push_back({ Duration, {} });
+			}
+
+			//A Width x Height cel of one colour at X, Y
+			void AddCel(uint16_t Layer, int16_t X, int16_t Y, uint16_t Width, uint16_t Height, uint32_t Color)
+			{
+				std::vector<uint8_t> Compressed = Compress(ToDepth(std::vector<uint32_t>((size_t)Width * Height, Color)));
+
+				Bytes Body;
+				Body.U16(Layer).U16((uint16_t)X).U16((uint16_t)Y).U8(255).U16(2).U16(0).Zero(5).U16(Width).U16(Height).Raw(Compressed);
+				m_Frames.back().Chunks.push_back(Chunk(0x2005, Body));
+			}
+
+			//A Width x Height tile tilemap cel at X, Y. Tiles are 32 bit, the tile ID in the low 29 bits and X, Y and diagonal flips in the top 3
+			void AddTilemapCel(uint16_t Layer, int16_t X, int16_t Y, uint16_t Width, uint16_t Height, const std::vector<uint32_t>& Tiles)
+			{
+				std::vector<uint8_t> Raw(Tiles.size() * 4);
+				memcpy(Raw.data(), Tiles.data(), Raw.size());
+
+				Bytes Body;
+				Body.U16(Layer).U16((uint16_t)X).U16((uint16_t)Y).U8(255).U16(3).U16(0).Zero(5).U16(Width).U16(Height).U16(32);
+				Body.U32(0x1FFFFFFF).U32(0x20000000).U32(0x40000000).U32(0x80000000).Zero(10).Raw(Compress(Raw));
+				m_Frames.back().Chunks.push_back(Chunk(0x2005, Body));
+			}
+
+			void AddTag(const std::string& Name, uint16_t From, uint16_t To, uint8_t Direction, uint16_t RepeatTimes = 0)
+			{
+				m_Tags.U16(From).U16(To).U8(Direction).U16(RepeatTimes).Zero(6).U8(10).U8(20).U8(30).Zero(1).Str(Name);
+				m_TagCount++;
+			}
+
+			//Flags 1 writes the nine-patch center of each key, 2 the pivot
+			void AddSlice(const std::string& Name, uint32_t Flags, const std::vector<TestSliceKey>& Keys)
+			{
+				Bytes Body;
+				Body.U32((uint32_t)Keys.size()).U32(Flags).U32(0).Str(Name);
+				for (auto& Key : Keys)
+				{
+					Body.U32(Key.Frame).U32((uint32_t)Key.X).U32((uint32_t)Key.Y).U32(Key.Width).U32(Key.Height);
+					if (Flags & 1)
+					{
+						Body.U32((uint32_t)Key.CenterX).U32((uint32_t)Key.CenterY).U32(Key.CenterWidth).U32(Key.CenterHeight);
+					}
+					if (Flags & 2)
+					{
+						Body.U32((uint32_t)Key.PivotX).U32((uint32_t)Key.PivotY);
+					}
+				}
+				m_Slices.push_back(Chunk(0x2022, Body));
+			}
+
+			bool Write(const std::filesystem::path& Path) const
+			{
+				Bytes Frames;
+				for (size_t f = 0; f < m_Frames.size(); f++)
+				{
+					std::vector<Bytes> Chunks;
+					if (f == 0)
+					{
+						Chunks = m_Tilesets;
+						Chunks.insert(Chunks.end(), m_Layers.begin(), m_Layers.end());
+						if (m_TagCount)
+						{
+							Bytes Tags;
+							Tags.U16(m_TagCount).Zero(8).Raw(m_Tags.Data);
+							Chunks.push_back(Chunk(0x2018, Tags));
+						}
+						Chunks.insert(Chunks.end(), m_Slices.begin(), m_Slices.end());
+					}
+					Chunks.insert(Chunks.end(), m_Frames[f].Chunks.begin(), m_Frames[f].Chunks.end());
+
+					Bytes Body;
+					for (auto& C : Chunks)
+					{
+						Body.Raw(C.Data);
+					}
+					Frames.U32((uint32_t)(16 + Body.Data.size())).U16(0xF1FA).U16((uint16_t)Chunks.size()).U16(m_Frames[f].Duration).Zero(2).U32((uint32_t)Chunks.size()).Raw(Body.Data);
+				}
+
+				Bytes Header;
+				Header.U32((uint32_t)(128 + Frames.Data.size())).U16(0xA5E0).U16((uint16_t)m_Frames.size()).U16(m_Width).U16(m_Height).U16(m_Depth);
+				Header.U32(1).U16(100).U32(0).U32(0).U8(m_TransparentIndex).Zero(3).U16(0).U8(1).U8(1).U16(0).U16(0).U16(16).U16(16);
+				Header.Zero(128 - Header.Data.size());
+
+				std::ofstream File(Path, std::ios::binary);
+				File.write((const char*)Header.Data.data(), Header.Data.size());
+				File.write((const char*)Frames.Data.data(), Frames.Data.size());
+				return File.good();
+			}
+
+		private:
+			struct Bytes
+			{
+				std::vector<uint8_t> Data;
+
+				Bytes& U8(uint8_t V) { Data.push_back(V); return *this; }
+				Bytes& U16(uint16_t V) { return U8((uint8_t)V).U8((uint8_t)(V >> 8)); }
+				Bytes& U32(uint32_t V) { return U16((uint16_t)V).U16((uint16_t)(V >> 16)); }
+				Bytes& Zero(size_t Count) { Data.insert(Data.end(), Count, 0); return *this; }
+				Bytes& Raw(const std::vector<uint8_t>& V) { Data.insert(Data.end(), V.begin(), V.end()); return *this; }
+				Bytes& Str(const std::string& S) { U16((uint16_t)S.size()); Data.insert(Data.end(), S.begin(), S.end()); return *this; }
+			};
+
+			struct Frame
+			{
+				uint16_t Duration;
+				std::vector<Bytes> Chunks;
+			};
+
+			//Each pixel cut down to the file's depth, the low bytes first
+			std::vector<uint8_t> ToDepth(const std::vector<uint32_t>& Pixels) const
+			{
+				size_t BytesPerPixel = m_Depth / 8;
+				std::vector<uint8_t> Out(Pixels.size() * BytesPerPixel);
+				for (size_t i = 0; i < Pixels.size(); i++)
+				{
+					for (size_t b = 0; b < BytesPerPixel; b++)
+					{
+						Out[i * BytesPerPixel + b] = (uint8_t)(Pixels[i] >> (b * 8));
+					}
+				}
+				return Out;
+			}
+
+			static std::vector<uint8_t> Compress(const std::vector<uint8_t>& Data)
+			{
+				uLongf Size = compressBound((uLong)Data.size());
+				std::vector<uint8_t> Compressed(Size);
+				compress(Compressed.data(), &Size, Data.data(), (uLong)Data.size());
+				Compressed.resize(Size);
+				return Compressed;
+			}
+
+			static Bytes Chunk(uint16_t Type, const Bytes& Body)
+			{
+				Bytes Out;
+				Out.U32((uint32_t)(6 + Body.Data.size())).U16(Type).Raw(Body.Data);
+				return Out;
+			}
+
+			uint16_t m_Width;
+			uint16_t m_Height;
+			uint16_t m_Depth;
+			uint8_t m_TransparentIndex;
+			std::vector<Bytes> m_Tilesets;
+			std::vector<Bytes> m_Layers;
+			std::vector<Frame> m_Frames;
+			std::vector<Bytes> m_Slices;
+			Bytes m_Tags;
+			uint16_t m_TagCount = 0;
+		};
+	}
+}
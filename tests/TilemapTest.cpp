@@ -0,0 +1,213 @@
+// Composites indexed and RGBA files with tilemap layers across several frames, flipped tiles and a palette change included,
+// and checks every pixel against the tiles drawn one at a time by hand. Also checks each tileset is only expanded once per palette.
+//
+// Build (from the repository root):
+//   g++ -O2 -std=c++17 -Isrc -Isrc/Core -Ivendor/spdlog/include -Ivendor/zlib/include tests/TilemapTest.cpp -o TilemapTest -lz
+// Usage:
+//   TilemapTest
+
+#include <vector>
+#include <filesystem>
+#include "Core/Log/Public/Log.h"
+#include "Core/Image/Public/Parser.h"
+#include "Core/Image/Public/FrameSet.h"
+#include "Core/Image/Public/TilemapRenderer.h"
+#include "Check.h"
+#include "TestSprite.h"
+
+namespace
+{
+	const uint32_t FlipX = 0x20000000;
+	const uint32_t FlipY = 0x40000000;
+	const uint32_t FlipDiagonal = 0x80000000;
+	const uint16_t TileSize = 4;
+
+	struct Map
+	{
+		int16_t X, Y;
+		uint16_t Width, Height;
+		std::vector<uint32_t> Tiles;
+	};
+
+	//What one frame shows, bottom layer first
+	struct Frame
+	{
+		std::vector<Map> Maps;
+		std::vector<uint32_t> Palette; // Empty if the frame keeps the palette it had
+	};
+
+	//Tile 1 isn't symmetric any way so every flip shows, tile 3 has see-through pixels, tile 0 is the empty one
+	std::vector<std::vector<uint32_t>> MakeTiles(bool Indexed)
+	{
+		std::vector<std::vector<uint32_t>> Tiles(4, std::vector<uint32_t>(TileSize * TileSize, 0));
+		for (uint32_t i = 0; i < TileSize * TileSize; i++)
+		{
+			uint32_t x = i % TileSize, y = i / TileSize;
+			Tiles[1][i] = Indexed ? 1 + (x + y * 2) % 4 : 0xFF000000 | (x * 60) | (y * 60 << 8);
+			Tiles[2][i] = Indexed ? 3 : 0xFF806040;
+			Tiles[3][i] = y < 2 ? (Indexed ? 4 : 0xFFFFFFFF) : 0;
+		}
+		return Tiles;
+	}
+
+	//Two tilemap layers over the same tileset. Frame 2 changes the palette and frame 3 keeps that change
+	std::vector<Frame> MakeFrames()
+	{
+		std::vector<Frame> Frames(4);
+		Frames[0].Palette = { 0x00000000, 0xFF0000FF, 0xFF00FF00, 0xFFFF0000, 0xFFFFFFFF };
+		Frames[0].Maps = { { 1, 2, 3, 2, { 1, 2, 0, 1 | FlipX, 1 | FlipY, 1 | FlipDiagonal } }, { 6, 0, 2, 2, { 3, 0, 3 | FlipY, 1 | FlipX | FlipY } } };
+		Frames[1].Maps = { { -2, 3, 3, 2, { 2, 1 | FlipX | FlipDiagonal, 1, 0, 3, 1 | FlipY | FlipDiagonal } }, { 5, 5, 2, 1, { 3, 3 } } };
+		Frames[2].Palette = { 0x00000000, 0xFF00FFFF, 0xFFFFFF00 };
+		Frames[2].Maps = Frames[0].Maps;
+		Frames[3].Maps = { { 0, 0, 4, 4, { 1, 2, 1, 2, 2, 1 | FlipX, 2, 1 | FlipY, 1, 2, 3, 0, 0, 0, 0, 3 } }, { 10, 10, 1, 1, { 1 | FlipX | FlipY | FlipDiagonal } } };
+		return Frames;
+	}
+
+	void WriteSprite(const std::filesystem::path& Path, bool Indexed, const std::vector<Frame>& Frames)
+	{
+		ASE::Test::TestSpriteWriter Writer(16, 14, Indexed ? 8 : 32, 0);
+		Writer.AddTileset(0, TileSize, TileSize, MakeTiles(Indexed));
+		Writer.AddTilemapLayer("Ground", 0);
+		Writer.AddTilemapLayer("Props", 0);
+		for (auto& F : Frames)
+		{
+			Writer.AddFrame();
+			if (Indexed && !F.Palette.empty())
+			{
+				Writer.AddPalette(0, F.Palette);
+			}
+			for (uint16_t l = 0; l < F.Maps.size(); l++)
+			{
+				const Map& M = F.Maps[l];
+				Writer.AddTilemapCel(l, M.X, M.Y, M.Width, M.Height, M.Tiles);
+			}
+		}
+		Writer.Write(Path);
+	}
+
+	//The frames as Aseprite shows them, every tile pixel looked up on its own. Flips swap x and y for the diagonal first, then mirror
+	std::vector<std::vector<uint32_t>> Expected(bool Indexed, const std::vector<Frame>& Frames, uint32_t Width, uint32_t Height)
+	{
+		std::vector<std::vector<uint32_t>> Tiles = MakeTiles(Indexed);
+		std::vector<uint32_t> Palette(256, 0);
+		std::vector<std::vector<uint32_t>> Out;
+		for (auto& F : Frames)
+		{
+			for (size_t i = 0; i < F.Palette.size(); i++)
+			{
+				Palette[i] = F.Palette[i];
+			}
+
+			std::vector<uint32_t> Canvas((size_t)Width * Height, 0);
+			for (auto& M : F.Maps)
+			{
+				for (uint32_t t = 0; t < M.Tiles.size(); t++)
+				{
+					uint32_t ID = M.Tiles[t] & 0x1FFFFFFF;
+					if (ID == 0)
+					{
+						continue;
+					}
+					for (uint32_t y = 0; y < TileSize; y++)
+					{
+						for (uint32_t x = 0; x < TileSize; x++)
+						{
+							uint32_t SrcX = (M.Tiles[t] & FlipX) ? TileSize - 1 - x : x;
+							uint32_t SrcY = (M.Tiles[t] & FlipY) ? TileSize - 1 - y : y;
+							if (M.Tiles[t] & FlipDiagonal)
+							{
+								std::swap(SrcX, SrcY);
+							}
+							uint32_t Pixel = Tiles[ID][SrcY * TileSize + SrcX];
+							//The tilemap layers aren't the background, so index 0 is see-through
+							uint32_t Color = Indexed ? (Pixel == 0 ? 0 : Palette[Pixel]) : Pixel;
+							int CanvasX = M.X + (int)((t % M.Width) * TileSize + x);
+							int CanvasY = M.Y + (int)((t / M.Width) * TileSize + y);
+							if ((Color >> 24) == 0xFF && CanvasX >= 0 && CanvasY >= 0 && CanvasX < (int)Width && CanvasY < (int)Height)
+							{
+								Canvas[(size_t)CanvasY * Width + CanvasX] = Color;
+							}
+						}
+					}
+				}
+			}
+			Out.push_back(std::move(Canvas));
+		}
+		return Out;
+	}
+
+	void CheckFrames(const ASE::AsepriteFileData& File, bool Indexed, const std::vector<Frame>& Frames, uint32_t ThreadCount, bool Deduplicate)
+	{
+		ASE::FrameSet Set(File, ThreadCount, Deduplicate);
+		std::vector<std::vector<uint32_t>> Want = Expected(Indexed, Frames, Set.GetWidth(), Set.GetHeight());
+		ASE_CHECK_EQ(Set.GetFrameCount(), Frames.size());
+		for (uint16_t f = 0; f < Set.GetFrameCount() && f < Want.size(); f++)
+		{
+			size_t Mismatches = 0;
+			for (size_t i = 0; i < Want[f].size(); i++)
+			{
+				Mismatches += Set.GetFrame(f)[i] != Want[f][i];
+			}
+			if (!ASE_CHECK_EQ(Mismatches, 0))
+			{
+				printf("  %s frame %u, %u threads\n", Indexed ? "indexed" : "RGBA", f, ThreadCount);
+			}
+		}
+	}
+
+	//One expanded copy per palette, handed back again for the same palette, and RGBA tiles used where they are
+	void CheckExpansion(const ASE::AsepriteFileData& Indexed, const ASE::AsepriteFileData& RGBA)
+	{
+		std::vector<std::shared_ptr<const ASE::Palette>> Palettes = ASE::Palette::ForAllFrames(Indexed);
+		ASE_CHECK(Palettes[0] == Palettes[1] && Palettes[1] != Palettes[2] && Palettes[2] == Palettes[3]);
+
+		ASE::ExpandedTilesets Tilesets;
+		const ASE::AsepriteTileset& Tileset = Indexed.Tilesets[0];
+		const uint32_t* First = Tilesets.Add(Tileset, 1, Palettes[0]->GetColors());
+		ASE_CHECK(First);
+		ASE_CHECK(Tilesets.Add(Tileset, 1, Palettes[1]->GetColors()) == First);
+		ASE_CHECK(Tilesets.Find(Tileset, 1, Palettes[0]->GetColors()) == First);
+		ASE_CHECK(!Tilesets.Find(Tileset, 1, Palettes[2]->GetColors()));
+		const uint32_t* Changed = Tilesets.Add(Tileset, 1, Palettes[2]->GetColors());
+		ASE_CHECK(Changed && Changed != First);
+		ASE_CHECK_EQ(Tilesets.GetCount(), 2);
+		ASE_CHECK(First[TileSize * TileSize] == Palettes[0]->GetColors()[1]);
+		ASE_CHECK(Changed[TileSize * TileSize] == Palettes[2]->GetColors()[1]);
+
+		ASE_CHECK(Tilesets.Add(RGBA.Tilesets[0], 4, nullptr) == (const uint32_t*)RGBA.Tilesets[0].Pixels->data());
+		ASE_CHECK_EQ(Tilesets.GetCount(), 2);
+	}
+}
+
+int main()
+{
+	ASE::Log::Init();
+	std::filesystem::path Directory = std::filesystem::temp_directory_path() / "ase_tilemap_test";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	std::vector<Frame> Frames = MakeFrames();
+	WriteSprite(Directory / "Indexed.aseprite", true, Frames);
+	WriteSprite(Directory / "RGBA.aseprite", false, Frames);
+
+	ASE::AsepriteParser Parser;
+	ASE::SpriteId IndexedId = Parser.ReadData(Directory / "Indexed.aseprite");
+	ASE::SpriteId RGBAId = Parser.ReadData(Directory / "RGBA.aseprite");
+	const ASE::AsepriteFileData* Indexed = Parser.GetFileData(IndexedId);
+	const ASE::AsepriteFileData* RGBA = Parser.GetFileData(RGBAId);
+	ASE_CHECK(Indexed && RGBA);
+	if (Indexed && RGBA)
+	{
+		ASE_CHECK_EQ(Indexed->Tilesets.size(), 1);
+		ASE_CHECK(Indexed->Tilesets.size() == 1 && Indexed->Tilesets[0].Pixels);
+		for (uint32_t ThreadCount : { 1u, 4u })
+		{
+			CheckFrames(*Indexed, true, Frames, ThreadCount, false);
+			CheckFrames(*RGBA, false, Frames, ThreadCount, false);
+		}
+		CheckFrames(*Indexed, true, Frames, 0, true);
+		CheckExpansion(*Indexed, *RGBA);
+	}
+
+	std::filesystem::remove_all(Directory);
+	return ASE::Test::Finish("TilemapTest");
+}